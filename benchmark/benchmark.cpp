@@ -1,7 +1,23 @@
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstring>
 #include <iostream>
 #include <iomanip>
 #include <locale>
+#include <optional>
+#include <tuple>
+
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include <benchmark.hpp>
 
@@ -15,16 +31,22 @@ std::map<std::string, std::function<void()>> features {
    { "key", key_benchmarking },
    { "hash", hash_benchmarking },
    { "blake2", blake2_benchmarking },
-   { "bls", bls_benchmarking }
+   { "bls", bls_benchmarking },
+   { "chain", chain_benchmarking },
+   { "replay", replay_benchmarking },
+   { "db", db_benchmarking }
 };
 
 // values to control cout format
 constexpr auto name_width = 40;
-constexpr auto runs_width = 5;
+constexpr auto runs_width = 7;
 constexpr auto time_width = 12;
 constexpr auto ns_width = 2;
 
 uint32_t num_runs = 1;
+harness_options options;
+std::vector<result> results;
+std::vector<value_result> values;
 
 std::map<std::string, std::function<void()>> get_features() {
    return features;
@@ -34,27 +56,53 @@ void set_num_runs(uint32_t runs) {
    num_runs = runs;
 }
 
+void set_harness_options(const harness_options& opts) {
+   options = opts;
+#ifdef __linux__
+   if (options.cpu >= 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(options.cpu, &set);
+      if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+         std::cerr << "unable to pin to cpu " << options.cpu << ": " << strerror(errno) << std::endl;
+      }
+   }
+#endif
+}
+
 void print_header() {
    std::cout << std::left << std::setw(name_width) << "function"
       << std::setw(runs_width) << "runs"
       << std::setw(time_width + ns_width) << std::right << "average"
+      << std::setw(time_width + ns_width) << "ci95"
       << std::setw(time_width + ns_width) << "minimum"
-      << std::setw(time_width + ns_width) << "maximum"
-      << std::endl << std::endl;
+      << std::setw(time_width + ns_width) << "median"
+      << std::setw(time_width + ns_width) << "p99"
+      << std::setw(time_width + ns_width) << "maximum";
+   if (options.perf_counters) {
+      std::cout << std::setw(time_width) << "cycles" << std::setw(time_width) << "instrs";
+   }
+   std::cout << std::endl << std::endl;
 }
 
-void print_results(std::string name, uint32_t runs, uint64_t total, uint64_t min, uint64_t max) {
+void print_results(const result& r) {
    std::cout.imbue(std::locale(""));
    std::cout
-      << std::setw(name_width) << std::left << name
+      << std::setw(name_width) << std::left << r.name
       // std::fixed for not printing 1234 in 1.234e3.
       // setprecision(0) for not printing fractions
       << std::right << std::fixed << std::setprecision(0)
-      << std::setw(runs_width)  << runs
-      << std::setw(time_width) << total/runs << std::setw(ns_width) << " ns"
-      << std::setw(time_width) << min << std::setw(ns_width) << " ns"
-      << std::setw(time_width) << max << std::setw(ns_width) << " ns"
-      << std::endl;
+      << std::setw(runs_width)  << r.runs
+      << std::setw(time_width) << r.mean << std::setw(ns_width) << " ns"
+      << std::setw(time_width) << r.ci95 << std::setw(ns_width) << " ns"
+      << std::setw(time_width) << r.min << std::setw(ns_width) << " ns"
+      << std::setw(time_width) << r.p50 << std::setw(ns_width) << " ns"
+      << std::setw(time_width) << r.p99 << std::setw(ns_width) << " ns"
+      << std::setw(time_width) << r.max << std::setw(ns_width) << " ns";
+   if (options.perf_counters && r.cycles) {
+      std::cout << std::setw(time_width) << r.cycles << std::setw(time_width) << r.instructions;
+   }
+   std::cout << std::endl;
 }
 
 bytes to_bytes(const std::string& source) {
@@ -63,23 +111,267 @@ bytes to_bytes(const std::string& source) {
    return output;
 };
 
+// cycles and instructions retired by this thread, read as one group
+class perf_counters {
+public:
+   perf_counters() {
+#ifdef __linux__
+      leader = open_counter(PERF_COUNT_HW_CPU_CYCLES, -1);
+      if (leader >= 0)
+         member = open_counter(PERF_COUNT_HW_INSTRUCTIONS, leader);
+      if (member < 0) {
+         std::cerr << "perf counters unavailable: " << strerror(errno) << " (see /proc/sys/kernel/perf_event_paranoid)" << std::endl;
+         close_all();
+      }
+#endif
+   }
+   ~perf_counters() { close_all(); }
+
+   bool valid() const { return leader >= 0; }
+
+   void start() {
+#ifdef __linux__
+      ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+   }
+
+   // returns {cycles, instructions} since start()
+   std::pair<uint64_t, uint64_t> stop() {
+#ifdef __linux__
+      ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+      struct { uint64_t nr; uint64_t values[2]; } data{};
+      if (read(leader, &data, sizeof(data)) == sizeof(data))
+         return {data.values[0], data.values[1]};
+#endif
+      return {0, 0};
+   }
+
+private:
+#ifdef __linux__
+   static int open_counter(uint64_t config, int group_fd) {
+      perf_event_attr attr{};
+      attr.type           = PERF_TYPE_HARDWARE;
+      attr.size           = sizeof(attr);
+      attr.config         = config;
+      attr.disabled       = group_fd == -1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv     = 1;
+      attr.read_format    = PERF_FORMAT_GROUP;
+      return syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+   }
+#endif
+   void close_all() {
+#ifdef __linux__
+      if (member >= 0)
+         close(member);
+      if (leader >= 0)
+         close(leader);
+#endif
+      member = leader = -1;
+   }
+
+   int leader = -1;
+   int member = -1;
+};
+
+namespace {
+
+double percentile(const std::vector<uint64_t>& sorted, double p) {
+   return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p / 100.0 * sorted.size()))];
+}
+
+// mean and 95% confidence half-width over samples within 3 interquartile ranges of the quartiles;
+// scheduler preemptions and page faults show up as far outliers and would otherwise dominate the mean
+std::tuple<double, double, uint32_t> robust_mean_ci(const std::vector<uint64_t>& sorted) {
+   const double q1 = percentile(sorted, 25.0);
+   const double q3 = percentile(sorted, 75.0);
+   const double lo = q1 - 3 * (q3 - q1);
+   const double hi = q3 + 3 * (q3 - q1);
+
+   double   sum = 0, sum_sq = 0;
+   uint32_t n   = 0;
+   for (auto v : sorted) {
+      if (v < lo || v > hi)
+         continue;
+      sum += v;
+      sum_sq += double(v) * v;
+      ++n;
+   }
+   const double mean     = n ? sum / n : 0;
+   const double variance = n > 1 ? std::max(0.0, (sum_sq - n * mean * mean) / (n - 1)) : 0;
+   const double ci95     = n > 1 ? 1.96 * std::sqrt(variance / n) : 0;
+   return {mean, ci95, static_cast<uint32_t>(sorted.size() - n)};
+}
+
+// 95% confidence interval of the median from the order statistics at n/2 -+ 1.96*sqrt(n)/2, which makes no
+// assumption about the shape of the run time distribution
+std::pair<double, double> median_ci(const std::vector<uint64_t>& sorted) {
+   const double n    = sorted.size();
+   const double half = 1.96 * std::sqrt(n) / 2;
+   const auto   lo   = static_cast<size_t>(std::max(0.0, std::floor(n / 2 - half)));
+   const auto   hi   = static_cast<size_t>(std::min(n - 1, std::ceil(n / 2 + half)));
+   return {double(sorted[lo]), double(sorted[hi])};
+}
+
+} // anonymous namespace
+
+void report_value(const std::string& name, double value, const std::string& unit) {
+   std::cout << std::setw(name_width) << std::left << name
+             << std::right << std::fixed << std::setprecision(0)
+             << std::setw(runs_width) << ""
+             << std::setw(time_width) << value << " " << unit << std::endl;
+   values.push_back({name, value, unit});
+}
+
 void benchmarking(const std::string& name, const std::function<void()>& func) {
-   uint64_t total{0};
-   uint64_t min{std::numeric_limits<uint64_t>::max()};
-   uint64_t max{0};
+   std::optional<perf_counters> counters;
+   if (options.perf_counters) {
+      counters.emplace();
+      if (!counters->valid())
+         counters.reset();
+   }
 
-   for (auto i = 0U; i < num_runs; ++i) {
-      auto start_time = std::chrono::high_resolution_clock::now();
+   for (auto i = 0U; i < options.warmup_runs; ++i) {
       func();
-      auto end_time = std::chrono::high_resolution_clock::now();
+   }
 
-      uint64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count();
-      total += duration;
-      min = std::min(min, duration);
-      max = std::max(max, duration);
+   std::vector<uint64_t> samples;
+   uint64_t cycles = 0, instructions = 0;
+   const uint32_t max_runs = std::max(num_runs, options.max_runs);
+   samples.reserve(options.target_ci_percent > 0 ? max_runs : num_runs);
+
+   auto run_batch = [&](uint32_t n) {
+      for (auto i = 0U; i < n; ++i) {
+         if (counters)
+            counters->start();
+         auto start_time = std::chrono::high_resolution_clock::now();
+         func();
+         auto end_time = std::chrono::high_resolution_clock::now();
+         if (counters) {
+            auto [c, in] = counters->stop();
+            cycles += c;
+            instructions += in;
+         }
+         samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+      }
+   };
+
+   run_batch(std::max(num_runs, 1U));
+   // keep adding batches of num_runs until the confidence interval is within target_ci_percent of the mean
+   while (options.target_ci_percent > 0 && samples.size() < max_runs) {
+      std::vector<uint64_t> sorted(samples);
+      std::sort(sorted.begin(), sorted.end());
+      auto [mean, ci95, outliers] = robust_mean_ci(sorted);
+      if (mean > 0 && ci95 / mean * 100.0 <= options.target_ci_percent)
+         break;
+      run_batch(std::min<uint32_t>(num_runs, max_runs - samples.size()));
    }
 
-   print_results(name, num_runs, total, min, max);
+   report(name, std::move(samples), cycles, instructions);
+}
+
+void report(const std::string& name, std::vector<uint64_t> samples, uint64_t cycles, uint64_t instructions) {
+   if (samples.empty())
+      return;
+   std::sort(samples.begin(), samples.end());
+   auto [mean, ci95, outliers] = robust_mean_ci(samples);
+
+   result r;
+   r.name         = name;
+   r.runs         = samples.size();
+   r.mean         = mean;
+   r.ci95         = ci95;
+   r.outliers     = outliers;
+   r.min          = samples.front();
+   r.p50          = percentile(samples, 50.0);
+   std::tie(r.p50_ci95_lo, r.p50_ci95_hi) = median_ci(samples);
+   r.p90          = percentile(samples, 90.0);
+   r.p99          = percentile(samples, 99.0);
+   r.max          = samples.back();
+   r.cycles       = cycles / samples.size();
+   r.instructions = instructions / samples.size();
+
+   print_results(r);
+   results.push_back(std::move(r));
+}
+
+bool write_results(const std::string& file) {
+   fc::variants out;
+   out.reserve(results.size());
+   for (const auto& r : results) {
+      out.emplace_back(fc::mutable_variant_object()
+         ("name", r.name)
+         ("runs", r.runs)
+         ("mean_ns", r.mean)
+         ("ci95_ns", r.ci95)
+         ("outliers", r.outliers)
+         ("min_ns", r.min)
+         ("p50_ns", r.p50)
+         ("p50_ci95_lo_ns", r.p50_ci95_lo)
+         ("p50_ci95_hi_ns", r.p50_ci95_hi)
+         ("p90_ns", r.p90)
+         ("p99_ns", r.p99)
+         ("max_ns", r.max)
+         ("cycles", r.cycles)
+         ("instructions", r.instructions));
+   }
+   for (const auto& v : values) {
+      out.emplace_back(fc::mutable_variant_object()
+         ("name", v.name)
+         ("value", v.value)
+         ("unit", v.unit));
+   }
+   return fc::json::save_to_file(fc::variant(std::move(out)), file, true, fc::json::output_formatting::legacy_generator);
+}
+
+uint32_t compare_to_baseline(const std::string& file, double threshold_percent) {
+   std::map<std::string, fc::variant_object> baseline;
+   for (const auto& v : fc::json::from_file(file).get_array()) {
+      baseline.emplace(v["name"].as_string(), v.get_object());
+   }
+
+   std::cout << std::endl << "comparison of medians to baseline " << file
+             << " (regression threshold " << threshold_percent << "%)" << std::endl << std::endl;
+
+   uint32_t regressions = 0;
+   auto print_change = [&](const std::string& name, double base, double current, const std::string& unit, bool regressed) {
+      const double change = base > 0 ? (current - base) / base * 100.0 : 0.0;
+      std::cout << std::setw(name_width) << std::left << name
+                << std::right << std::fixed << std::setprecision(1)
+                << std::setw(time_width) << base << std::setw(ns_width) << unit
+                << std::setw(time_width) << current << std::setw(ns_width) << unit
+                << std::setw(time_width - 2) << std::showpos << change << std::noshowpos << " %"
+                << (regressed ? "  REGRESSION" : "")
+                << std::endl;
+   };
+
+   for (const auto& r : results) {
+      auto itr = baseline.find(r.name);
+      if (itr == baseline.end() || !itr->second.contains("p50_ns"))
+         continue;
+      const double base   = itr->second["p50_ns"].as_double();
+      const double change = base > 0 ? (r.p50 - base) / base * 100.0 : 0.0;
+      // a change within the noise of either run is not a regression: the confidence intervals of the two medians
+      // must not overlap. Baselines written before the median interval was recorded only have their median.
+      const double base_lo = itr->second.contains("p50_ci95_lo_ns") ? itr->second["p50_ci95_lo_ns"].as_double() : base;
+      const double base_hi = itr->second.contains("p50_ci95_hi_ns") ? itr->second["p50_ci95_hi_ns"].as_double() : base;
+      const bool significant = r.p50_ci95_lo > base_hi || r.p50_ci95_hi < base_lo;
+      const bool regressed   = change > threshold_percent && significant;
+      regressions += regressed;
+      print_change(r.name, base, r.p50, " ns", regressed);
+   }
+   // single values (peak memory, totals) have no noise estimate, only the threshold applies; lower is better
+   for (const auto& v : values) {
+      auto itr = baseline.find(v.name);
+      if (itr == baseline.end() || !itr->second.contains("value"))
+         continue;
+      const double base      = itr->second["value"].as_double();
+      const bool   regressed = base > 0 && (v.value - base) / base * 100.0 > threshold_percent;
+      regressions += regressed;
+      print_change(v.name, base, v.value, " " + v.unit, regressed);
+   }
+   return regressions;
 }
 
 } // benchmark
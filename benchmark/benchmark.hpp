@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <map>
+#include <string>
 #include <vector>
 #include <limits>
 
@@ -10,7 +11,42 @@
 namespace eosio::benchmark {
 using bytes = std::vector<char>;
 
+struct harness_options {
+   uint32_t warmup_runs       = 0;     // untimed runs before measuring
+   uint32_t max_runs          = 0;     // upper bound on runs when target_ci_percent is set
+   double   target_ci_percent = 0;     // add runs until the 95% confidence interval is within this percent of the mean
+   int      cpu               = -1;    // pin to this cpu, -1 for no affinity
+   bool     perf_counters     = false; // report cycles and instructions per run
+};
+
+struct result {
+   std::string name;
+   uint64_t    runs = 0;
+   double      mean = 0;
+   double      ci95 = 0;
+   uint32_t    outliers = 0;
+   uint64_t    min = 0;
+   double      p50 = 0;
+   double      p50_ci95_lo = 0; // distribution free 95% confidence interval of the median
+   double      p50_ci95_hi = 0;
+   double      p90 = 0;
+   double      p99 = 0;
+   uint64_t    max = 0;
+   uint64_t    cycles = 0;
+   uint64_t    instructions = 0;
+};
+
+// a measurement that is not a distribution of run times, e.g. peak memory
+struct value_result {
+   std::string name;
+   double      value = 0;
+   std::string unit;
+};
+
 void set_num_runs(uint32_t runs);
+void set_harness_options(const harness_options& opts);
+void set_chain_params(uint32_t trxs_per_block, uint32_t num_blocks);
+void set_replay_params(uint32_t trxs_per_block, uint32_t num_blocks);
 std::map<std::string, std::function<void()>> get_features();
 void print_header();
 bytes to_bytes(const std::string& source);
@@ -21,7 +57,18 @@ void key_benchmarking();
 void hash_benchmarking();
 void blake2_benchmarking();
 void bls_benchmarking();
+void chain_benchmarking();
+void replay_benchmarking();
+void db_benchmarking();
 
 void benchmarking(const std::string& name, const std::function<void()>& func); 
+// records samples in nanoseconds taken outside of benchmarking(), e.g. per block times of a replay
+void report(const std::string& name, std::vector<uint64_t> samples, uint64_t cycles = 0, uint64_t instructions = 0);
+void report_value(const std::string& name, double value, const std::string& unit);
+
+// writes the results of all benchmarking() calls as a json array
+bool write_results(const std::string& file);
+// prints the change in median against a file written by write_results() and returns the number of regressions
+uint32_t compare_to_baseline(const std::string& file, double threshold_percent);
 
 } // benchmark
@@ -0,0 +1,397 @@
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <sstream>
+
+#include <eosio/chain/snapshot.hpp>
+#include <eosio/testing/tester.hpp>
+#include <fc/io/raw.hpp>
+
+#include <test_contracts.hpp>
+
+#include <benchmark.hpp>
+
+using namespace eosio::chain;
+using namespace eosio::chain::literals;
+using namespace eosio::testing;
+
+namespace eosio::benchmark {
+
+// Produces blocks filled with a mix of transactions on one controller and validates them on a second one, in process
+// and without networking, so block production and validation throughput can be compared across releases.
+
+uint32_t chain_trxs_per_block = 500;
+uint32_t chain_num_blocks     = 20;
+uint32_t replay_trxs_per_block = 20;
+uint32_t replay_num_blocks     = 2000;
+
+void set_chain_params(uint32_t trxs_per_block, uint32_t num_blocks) {
+   chain_trxs_per_block = trxs_per_block;
+   chain_num_blocks     = num_blocks;
+}
+
+void set_replay_params(uint32_t trxs_per_block, uint32_t num_blocks) {
+   replay_trxs_per_block = trxs_per_block;
+   replay_num_blocks     = num_blocks;
+}
+
+namespace {
+
+constexpr auto token_account = "eosio.token"_n;
+constexpr auto dex_account   = "dex"_n;   // liquidity pool on the other side of every swap
+constexpr auto ram_account   = "ramheavy"_n;
+constexpr auto num_users     = 100;
+constexpr auto ram_rows_per_trx  = 10;
+constexpr auto ram_bytes_per_row = 256;
+
+enum class trx_kind { transfer, swap, ram };
+
+struct trx_mix {
+   std::string name;
+   uint32_t    transfer_per; // percent of transactions of each kind
+   uint32_t    swap_per;
+   uint32_t    ram_per;
+};
+
+const std::vector<trx_mix> mixes {
+   { "transfer", 100,   0,   0 },
+   { "swap",       0, 100,   0 },
+   { "ram",        0,   0, 100 },
+   { "mixed",     60,  30,  10 }
+};
+
+using nanoseconds = uint64_t;
+
+template <typename F>
+nanoseconds time_ns(F&& f) {
+   auto start = std::chrono::high_resolution_clock::now();
+   f();
+   auto end = std::chrono::high_resolution_clock::now();
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+class chain_bench {
+public:
+   explicit chain_bench(bool with_validator = true) {
+      auto [cfg, genesis] = base_tester::default_config(tempdir);
+      // let a block hold as many transactions as requested; limits are not what is being measured
+      genesis.initial_configuration.max_block_cpu_usage = 100 * config::default_max_block_cpu_usage;
+      genesis.initial_configuration.max_block_net_usage = 100 * config::default_max_block_net_usage;
+
+      producer.emplace(cfg, genesis);
+      producer->execute_setup_policy(setup_policy::full);
+
+      deploy();
+
+      if (with_validator) {
+         controller::config vcfg = cfg;
+         validating_tester::config_validator(vcfg);
+         validator = validating_tester::create_validating_node(vcfg, genesis, true);
+         sync_validator();
+      }
+   }
+
+   void run(const trx_mix& mix) {
+      std::vector<uint64_t> trx_ns;
+      std::vector<uint64_t> produce_ns;
+      std::vector<uint64_t> validate_ns;
+      trx_ns.reserve(chain_trxs_per_block * chain_num_blocks);
+      produce_ns.reserve(chain_num_blocks);
+      validate_ns.reserve(chain_num_blocks);
+      uint64_t      trx_count   = 0;
+      const int64_t state_start = state_size();
+
+      for (uint32_t b = 0; b < chain_num_blocks; ++b) {
+         // create and sign outside of the measured time; a node receives transactions already signed
+         std::vector<packed_transaction> trxs;
+         trxs.reserve(chain_trxs_per_block);
+         for (uint32_t t = 0; t < chain_trxs_per_block; ++t) {
+            trxs.emplace_back(make_trx(pick(mix)));
+         }
+
+         nanoseconds block_ns = 0;
+         for (auto& trx : trxs) {
+            nanoseconds ns = time_ns([&]() { producer->push_transaction(trx, fc::time_point::maximum(), 0); });
+            trx_ns.push_back(ns);
+            block_ns += ns;
+         }
+         signed_block_ptr block;
+         block_ns += time_ns([&]() { block = producer->produce_block(); });
+         produce_ns.push_back(block_ns);
+         trx_count += trxs.size();
+
+         validate_ns.push_back(time_ns([&]() { push_to_validator(block); }));
+      }
+
+      FC_ASSERT(producer->control->head_block_id() == validator->head_block_id(), "validator diverged from producer");
+
+      const int64_t     state_diff     = state_size() - state_start;
+      const nanoseconds produce_total  = std::accumulate(produce_ns.begin(), produce_ns.end(), nanoseconds{0});
+      const nanoseconds validate_total = std::accumulate(validate_ns.begin(), validate_ns.end(), nanoseconds{0});
+
+      report("chain " + mix.name + " produce block", std::move(produce_ns));
+      report("chain " + mix.name + " validate block", std::move(validate_ns));
+      report("chain " + mix.name + " trx", std::move(trx_ns));
+      report_value("chain " + mix.name + " state per trx", double(state_diff) / std::max<uint64_t>(trx_count, 1), "B");
+
+      std::cout.imbue(std::locale(""));
+      std::cout << std::fixed << std::setprecision(0)
+                << mix.name << ": " << trx_count << " transactions, "
+                << trx_count * 1e9 / produce_total << " produced trxs/s, "
+                << trx_count * 1e9 / validate_total << " validated trxs/s" << std::endl;
+   }
+
+   // produces blocks cycling through all transaction mixes, returns the number of transactions
+   uint64_t generate(uint32_t num_blocks, uint32_t trxs_per_block) {
+      uint64_t trx_count = 0;
+      for (uint32_t b = 0; b < num_blocks; ++b) {
+         const auto& mix = mixes[b % mixes.size()];
+         for (uint32_t t = 0; t < trxs_per_block; ++t) {
+            auto trx = make_trx(pick(mix));
+            producer->push_transaction(trx, fc::time_point::maximum(), 0);
+         }
+         producer->produce_block();
+         trx_count += trxs_per_block;
+      }
+      return trx_count;
+   }
+
+   std::string snapshot() {
+      producer->control->abort_block();
+      std::ostringstream out;
+      auto writer = std::make_shared<ostream_snapshot_writer>(out);
+      producer->control->write_snapshot(writer);
+      writer->finalize();
+      return out.str();
+   }
+
+   // closes the producing chain so its irreversible blocks are in the block log
+   controller::config close() {
+      auto cfg = producer->get_config();
+      producer->close();
+      return cfg;
+   }
+
+   const fc::temp_directory& dir() const { return tempdir; }
+   chain_id_type producer_chain_id() const { return producer->control->get_chain_id(); }
+
+private:
+   void deploy() {
+      std::vector<account_name> accounts{token_account, dex_account, ram_account};
+      for (auto i = 0; i < num_users; ++i) {
+         users.emplace_back(user_name(i));
+      }
+      accounts.insert(accounts.end(), users.begin(), users.end());
+      producer->create_accounts(accounts);
+
+      producer->set_code(token_account, test_contracts::eosio_token_wasm());
+      producer->set_abi(token_account, test_contracts::eosio_token_abi());
+      producer->set_code(ram_account, test_contracts::test_ram_limit_wasm());
+      producer->set_abi(ram_account, test_contracts::test_ram_limit_abi());
+      producer->produce_block();
+
+      for (const auto* sym : {"1000000000.0000 AAA", "1000000000.0000 BBB"}) {
+         producer->push_action(token_account, "create"_n, token_account,
+                               fc::mutable_variant_object()("issuer", token_account)("maximum_supply", sym));
+      }
+      for (const auto* qty : {"100000000.0000 AAA", "100000000.0000 BBB"}) {
+         producer->push_action(token_account, "issue"_n, token_account,
+                               fc::mutable_variant_object()("to", token_account)("quantity", qty)("memo", ""));
+      }
+      producer->produce_block();
+
+      // every user and the pool hold both tokens so any transfer or swap between them succeeds
+      std::vector<account_name> holders(users);
+      holders.push_back(dex_account);
+      for (const auto& holder : holders) {
+         for (const auto* qty : {"100000.0000 AAA", "100000.0000 BBB"}) {
+            producer->push_action(token_account, "transfer"_n, token_account,
+                                  fc::mutable_variant_object()("from", token_account)("to", holder)("quantity", qty)("memo", ""));
+         }
+      }
+      producer->produce_block();
+   }
+
+   static account_name user_name(int i) {
+      std::string n = "user";
+      for (int d = 0; d < 4; ++d, i /= 26) {
+         n += static_cast<char>('a' + i % 26);
+      }
+      return account_name(n);
+   }
+
+   trx_kind pick(const trx_mix& mix) {
+      const uint32_t r = rng() % 100;
+      if (r < mix.transfer_per)
+         return trx_kind::transfer;
+      if (r < mix.transfer_per + mix.swap_per)
+         return trx_kind::swap;
+      return trx_kind::ram;
+   }
+
+   action transfer_action(account_name from, account_name to, const asset& quantity) {
+      // unique memo keeps otherwise identical transfers from being duplicate transactions
+      return action({{from, config::active_name}}, token_account, "transfer"_n,
+                    fc::raw::pack(from, to, quantity, std::to_string(++nonce)));
+   }
+
+   packed_transaction make_trx(trx_kind kind) {
+      static const asset one_aaa = asset::from_string("0.0001 AAA");
+      static const asset one_bbb = asset::from_string("0.0001 BBB");
+
+      const account_name from = users[rng() % users.size()];
+      account_name to = users[rng() % users.size()];
+      if (to == from)
+         to = users[(std::find(users.begin(), users.end(), from) - users.begin() + 1) % users.size()];
+
+      signed_transaction trx;
+      std::vector<account_name> signers{from};
+      switch (kind) {
+         case trx_kind::transfer:
+            trx.actions.emplace_back(transfer_action(from, to, one_aaa));
+            break;
+         case trx_kind::swap:
+            // atomic swap against the pool: one token in, the other out, authorized by both sides
+            trx.actions.emplace_back(transfer_action(from, dex_account, one_aaa));
+            trx.actions.emplace_back(transfer_action(dex_account, from, one_bbb));
+            signers.push_back(dex_account);
+            break;
+         case trx_kind::ram: {
+            const uint64_t first = ram_rows;
+            ram_rows += ram_rows_per_trx;
+            trx.actions.emplace_back(std::vector<permission_level>{{from, config::active_name}}, ram_account, "setentry"_n,
+                                     fc::raw::pack(from, first, first + ram_rows_per_trx - 1, uint64_t(ram_bytes_per_row)));
+            break;
+         }
+      }
+      producer->set_transaction_headers(trx);
+      for (const auto& signer : signers) {
+         trx.sign(base_tester::get_private_key(signer, "active"), producer->control->get_chain_id());
+      }
+      return packed_transaction(std::move(trx));
+   }
+
+   void push_to_validator(const signed_block_ptr& block) {
+      auto bsf = validator->create_block_state_future(block->calculate_id(), block);
+      controller::block_report br;
+      validator->push_block(br, bsf.get(), forked_branch_callback{}, trx_meta_cache_lookup{});
+   }
+
+   void sync_validator() {
+      for (uint32_t n = validator->head_block_num() + 1; n <= producer->control->head_block_num(); ++n) {
+         push_to_validator(producer->control->fetch_block_by_number(n));
+      }
+   }
+
+   int64_t state_size() const {
+      const auto& db = producer->control->db();
+      return db.get_segment_manager()->get_size() - db.get_free_memory();
+   }
+
+   fc::temp_directory          tempdir;
+   std::optional<tester>       producer;
+   std::unique_ptr<controller> validator;
+   std::vector<account_name>   users;
+   std::mt19937                rng{42}; // fixed seed, every run produces the same blocks
+   uint64_t                    nonce    = 0;
+   uint64_t                    ram_rows = 0;
+};
+
+#ifdef __linux__
+// peak resident set size of the process since the last reset_peak_rss(), in KiB
+uint64_t peak_rss_kb() {
+   std::ifstream status("/proc/self/status");
+   std::string line;
+   while (std::getline(status, line)) {
+      if (line.rfind("VmHWM:", 0) == 0)
+         return std::stoull(line.substr(6));
+   }
+   return 0;
+}
+
+void reset_peak_rss() {
+   std::ofstream("/proc/self/clear_refs") << "5";
+}
+#else
+uint64_t peak_rss_kb() { return 0; }
+void reset_peak_rss() {}
+#endif
+
+} // anonymous namespace
+
+void chain_benchmarking() {
+   for (const auto& mix : mixes) {
+      // fresh chain per mix so state growth and caches of one mix do not carry into the next
+      chain_bench bench;
+      bench.run(mix);
+   }
+}
+
+// Replays a block log against a snapshot taken before it, the way a node rebuilds its state. The blocks are generated
+// with a fixed seed so every run replays the same chain. Reports the time of each replayed block, the time spent in
+// each phase per block and the peak resident memory of the replay, for comparison against a --baseline.
+void replay_benchmarking() {
+   chain_bench bench(false);
+   const std::string   snapshot  = bench.snapshot();
+   const uint64_t      trx_count = bench.generate(replay_num_blocks, replay_trxs_per_block);
+   const chain_id_type chain_id  = bench.producer_chain_id();
+   controller::config  cfg       = bench.close();
+   cfg.state_dir = bench.dir().path() / "replay_state";
+
+   std::istringstream in(snapshot);
+   auto reader = std::make_shared<istream_snapshot_reader>(in);
+   reader->validate();
+
+   auto replay = std::make_unique<controller>(cfg, make_protocol_feature_set(), chain_id);
+   replay->add_indices();
+
+   std::vector<uint64_t> block_ns;
+   block_ns.reserve(replay_num_blocks);
+   // blocks are replayed from within startup() once the snapshot is loaded; time them from the start of the first
+   // replayed block so the snapshot load is not counted as part of it
+   std::optional<std::chrono::high_resolution_clock::time_point> last;
+   auto start_conn = replay->block_start.connect([&](uint32_t) {
+      if (!last)
+         last = std::chrono::high_resolution_clock::now();
+   });
+   auto accepted_conn = replay->accepted_block.connect([&](const block_signal_params&) {
+      const auto now = std::chrono::high_resolution_clock::now();
+      block_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(now - *last).count());
+      last = now;
+   });
+
+   reset_peak_rss();
+   const auto start = std::chrono::high_resolution_clock::now();
+   replay->startup([]() {}, []() { return false; }, reader);
+   const auto end = std::chrono::high_resolution_clock::now();
+   const uint64_t rss_kb = peak_rss_kb();
+   start_conn.disconnect();
+   accepted_conn.disconnect();
+
+   FC_ASSERT(!block_ns.empty(), "no blocks were replayed");
+   const double blocks   = block_ns.size();
+   const double total_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+   const auto&  br       = replay->replay_report();
+   auto per_block_ns = [&](const fc::microseconds& t) { return t.count() * 1000.0 / blocks; };
+
+   report("replay block", std::move(block_ns));
+   report_value("replay start_block per block", per_block_ns(br.start_block_time), "ns");
+   report_value("replay execution per block", per_block_ns(br.execution_time), "ns");
+   report_value("replay finalize_block per block", per_block_ns(br.finalize_block_time), "ns");
+   report_value("replay signals per block", per_block_ns(br.signal_time), "ns");
+   report_value("replay db commit per block", per_block_ns(br.db_commit_time), "ns");
+   report_value("replay total", total_ns / 1e6, "ms");
+   if (rss_kb)
+      report_value("replay peak rss", rss_kb, "KiB");
+
+   std::cout.imbue(std::locale(""));
+   std::cout << std::fixed << std::setprecision(0)
+             << "replayed " << blocks << " blocks, " << trx_count << " transactions: "
+             << blocks * 1e9 / total_ns << " blocks/s, " << trx_count * 1e9 / total_ns << " trxs/s" << std::endl;
+}
+
+} // benchmark
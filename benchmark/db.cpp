@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <random>
+#include <string>
+
+#include <eosio/chain/contract_table_objects.hpp>
+#include <eosio/chain/memory_placement.hpp>
+#include <eosio/testing/tester.hpp>
+#include <fc/io/raw.hpp>
+
+#include <test_contracts.hpp>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <benchmark.hpp>
+
+using namespace eosio::chain;
+using namespace eosio::chain::literals;
+using namespace eosio::testing;
+
+namespace eosio::benchmark {
+
+// Looks up rows of a large contract table the way db_find_i64 does, with the chain state loaded in to memory
+// (database-map-mode heap) once without and once with the huge page and NUMA placement hints of memory_placement, so
+// the effect of the hints can be measured on the host running the benchmark.
+
+namespace {
+
+constexpr auto     table_account  = "ramheavy"_n;
+constexpr auto     table_name     = "test.table"_n;
+constexpr uint64_t num_rows       = 200'000;
+constexpr uint64_t rows_per_trx   = 100;
+constexpr uint64_t bytes_per_row  = 64;
+constexpr uint32_t finds_per_run  = 1000;  // random lookups per timed run of the direct lookup
+constexpr uint64_t finds_per_trx  = 500;   // rows read by each printentry transaction
+constexpr uint32_t num_find_trxs  = 200;
+
+// NUMA node of the cpu the benchmark runs on, use --cpu to pin it
+std::optional<uint32_t> current_numa_node() {
+#ifdef __linux__
+   unsigned cpu = 0, node = 0;
+   if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+      return node;
+#endif
+   return {};
+}
+
+class db_bench {
+public:
+   explicit db_bench(const memory_placement& placement) {
+      auto [cfg, genesis] = base_tester::default_config(tempdir);
+      // large enough that the table does not fit in the TLB reach of 4K pages
+      cfg.state_size        = 1024ull * 1024 * 1024;
+      cfg.db_map_mode       = pinnable_mapped_file::map_mode::heap;
+      cfg.state_placement   = placement;
+      cfg.contracts_console = false;
+      genesis.initial_configuration.max_block_cpu_usage = 100 * config::default_max_block_cpu_usage;
+
+      chain.emplace(cfg, genesis);
+      chain->execute_setup_policy(setup_policy::full);
+      chain->create_accounts({table_account});
+      chain->set_code(table_account, test_contracts::test_ram_limit_wasm());
+      chain->set_abi(table_account, test_contracts::test_ram_limit_abi());
+      chain->produce_block();
+
+      for (uint64_t first = 0; first < num_rows; first += rows_per_trx) {
+         chain->push_action(table_account, "setentry"_n, table_account,
+                            fc::mutable_variant_object()("payer", table_account)("from", first)
+                                                        ("to", first + rows_per_trx - 1)("size", bytes_per_row));
+         if ((first / rows_per_trx) % 100 == 99)
+            chain->produce_block();
+      }
+      chain->produce_block();
+
+      keys.resize(finds_per_run);
+      std::uniform_int_distribution<uint64_t> dist(0, num_rows - 1);
+      std::generate(keys.begin(), keys.end(), [&]() { return dist(rng); });
+   }
+
+   // the chainbase lookups of apply_context::db_find_i64, without the wasm and transaction overhead around them
+   void find_rows() {
+      const auto& db = chain->control->db();
+      size_t found = 0;
+      for (const auto key : keys) {
+         const auto* tab = db.find<table_id_object, by_code_scope_table>(boost::make_tuple(table_account, table_account, table_name));
+         const auto* obj = db.find<key_value_object, by_scope_primary>(boost::make_tuple(tab->id, key));
+         found += obj->value.size();
+      }
+      sink = found;
+   }
+
+   // printentry transactions each reading a range of rows through db_find_i64, returns the time of each push
+   std::vector<uint64_t> find_rows_in_contract() {
+      // distinct ranges so that no two transactions are duplicates
+      std::vector<uint64_t> starts(num_rows / finds_per_trx);
+      for (size_t i = 0; i < starts.size(); ++i)
+         starts[i] = i * finds_per_trx;
+      std::shuffle(starts.begin(), starts.end(), rng);
+      starts.resize(std::min<size_t>(starts.size(), num_find_trxs));
+
+      std::vector<packed_transaction> trxs;
+      trxs.reserve(starts.size());
+      for (const auto first : starts) {
+         signed_transaction trx;
+         trx.actions.emplace_back(std::vector<permission_level>{{table_account, config::active_name}}, table_account, "printentry"_n,
+                                  fc::raw::pack(first, first + finds_per_trx - 1));
+         chain->set_transaction_headers(trx);
+         trx.sign(base_tester::get_private_key(table_account, "active"), chain->control->get_chain_id());
+         trxs.emplace_back(std::move(trx));
+      }
+
+      std::vector<uint64_t> samples;
+      samples.reserve(trxs.size());
+      for (auto& trx : trxs) {
+         const auto start = std::chrono::high_resolution_clock::now();
+         chain->push_transaction(trx, fc::time_point::maximum(), 0);
+         const auto end = std::chrono::high_resolution_clock::now();
+         samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+      }
+      chain->produce_block();
+      return samples;
+   }
+
+private:
+   fc::temp_directory    tempdir;
+   std::optional<tester> chain;
+   std::vector<uint64_t> keys;
+   std::mt19937          rng{42}; // fixed seed, every run looks up the same rows
+   volatile size_t       sink = 0;
+};
+
+} // anonymous namespace
+
+void db_benchmarking() {
+   memory_placement placed;
+   placed.huge_pages = true;
+   placed.numa_node  = current_numa_node();
+
+   const std::vector<std::pair<std::string, memory_placement>> placements {
+      { "no placement", memory_placement{} },
+      { "huge pages+numa", placed }
+   };
+
+   for (const auto& [desc, placement] : placements) {
+      // fresh chain per placement so the rows are faulted in under the hints being measured
+      db_bench bench(placement);
+      benchmarking("db_find_i64 x" + std::to_string(finds_per_run) + " " + desc, [&]() { bench.find_rows(); });
+      report("db_find_i64 contract x" + std::to_string(finds_per_trx) + " " + desc, bench.find_rows_in_contract());
+   }
+}
+
+} // benchmark
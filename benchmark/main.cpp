@@ -2,6 +2,8 @@
 
 #include <boost/program_options.hpp>
 
+#include <fc/exception/exception.hpp>
+
 #include <benchmark.hpp>
 
 namespace bpo = boost::program_options;
@@ -10,7 +12,15 @@ using bpo::variables_map;
 
 int main(int argc, char* argv[]) {
    uint32_t num_runs = 1;
+   uint32_t chain_trxs_per_block = 500;
+   uint32_t chain_blocks = 20;
+   uint32_t replay_trxs_per_block = 20;
+   uint32_t replay_blocks = 2000;
    std::string feature_name;
+   std::string json_file;
+   std::string baseline_file;
+   double regression_threshold = 5.0;
+   eosio::benchmark::harness_options harness;
 
    auto features = eosio::benchmark::get_features();
 
@@ -19,6 +29,18 @@ int main(int argc, char* argv[]) {
       ("feature,f", bpo::value<std::string>(), "feature to be benchmarked; if this option is not present, all features are benchmarked.")
       ("list,l", "list of supported features")
       ("runs,r", bpo::value<uint32_t>(&num_runs)->default_value(1000), "the number of times running a function during benchmarking")
+      ("warmup,w", bpo::value<uint32_t>(&harness.warmup_runs)->default_value(10), "the number of untimed runs before measuring a function")
+      ("target-ci", bpo::value<double>(&harness.target_ci_percent)->default_value(0), "keep adding batches of --runs until the 95% confidence interval of the mean is within this percent of it; 0 runs exactly --runs times")
+      ("max-runs", bpo::value<uint32_t>(&harness.max_runs)->default_value(100000), "the maximum number of runs when --target-ci is set")
+      ("cpu", bpo::value<int>(&harness.cpu)->default_value(-1), "pin the benchmark to this cpu; -1 leaves affinity unchanged")
+      ("perf-counters", bpo::bool_switch(&harness.perf_counters), "report cycles and instructions per run using perf_event_open")
+      ("json", bpo::value<std::string>(&json_file), "write results to this file as json")
+      ("baseline", bpo::value<std::string>(&baseline_file), "compare medians against a json file previously written with --json and exit with an error on regression")
+      ("regression-threshold", bpo::value<double>(&regression_threshold)->default_value(5.0), "percent increase in median over the baseline that is reported as a regression")
+      ("chain-trxs-per-block", bpo::value<uint32_t>(&chain_trxs_per_block)->default_value(500), "the number of transactions in each block produced by the chain feature")
+      ("chain-blocks", bpo::value<uint32_t>(&chain_blocks)->default_value(20), "the number of blocks produced and validated for each transaction mix by the chain feature")
+      ("replay-trxs-per-block", bpo::value<uint32_t>(&replay_trxs_per_block)->default_value(20), "the number of transactions in each block generated for the replay feature")
+      ("replay-blocks", bpo::value<uint32_t>(&replay_blocks)->default_value(2000), "the number of blocks generated and replayed by the replay feature, cycling through the transaction mixes")
       ("help,h", "benchmark functions, and report average, minimum, and maximum execution time in nanoseconds");
 
    variables_map vmap;
@@ -62,6 +84,9 @@ int main(int argc, char* argv[]) {
    }
 
    eosio::benchmark::set_num_runs(num_runs);
+   eosio::benchmark::set_harness_options(harness);
+   eosio::benchmark::set_chain_params(chain_trxs_per_block, chain_blocks);
+   eosio::benchmark::set_replay_params(replay_trxs_per_block, replay_blocks);
    eosio::benchmark::print_header();
 
    if (feature_name.empty()) {
@@ -76,5 +101,22 @@ int main(int argc, char* argv[]) {
       std::cout << std::endl;
    }
 
+   if (!json_file.empty() && !eosio::benchmark::write_results(json_file)) {
+      std::cerr << "unable to write " << json_file << std::endl;
+      return 1;
+   }
+
+   if (!baseline_file.empty()) {
+      try {
+         if (auto regressions = eosio::benchmark::compare_to_baseline(baseline_file, regression_threshold); regressions > 0) {
+            std::cout << std::endl << regressions << " regression(s) against baseline" << std::endl;
+            return 2;
+         }
+      } catch (const fc::exception& e) {
+         std::cerr << "unable to read baseline " << baseline_file << ": " << e.to_string() << std::endl;
+         return 1;
+      }
+   }
+
    return 0;
 }
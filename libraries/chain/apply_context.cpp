@@ -10,6 +10,7 @@
 #include <eosio/chain/code_object.hpp>
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/deep_mind.hpp>
+#include <eosio/chain/native_token.hpp>
 #include <boost/container/flat_set.hpp>
 
 using boost::container::flat_set;
@@ -104,7 +105,8 @@ void apply_context::exec_one()
                   control.check_action_list( act->account, act->name );
                }
                try {
-                  control.get_wasm_interface().apply( receiver_account->code_hash, receiver_account->vm_type, receiver_account->vm_version, *this );
+                  if( !( control.is_native_token_code( receiver_account->code_hash ) && native_token::apply( *this ) ) )
+                     control.get_wasm_interface().apply( receiver_account->code_hash, receiver_account->vm_type, receiver_account->vm_version, *this );
                } catch( const wasm_exit& ) {}
             }
 
@@ -0,0 +1,162 @@
+#include <eosio/chain/async_signal_subscriber.hpp>
+
+#include <fc/exception/exception.hpp>
+#include <fc/log/logger.hpp>
+
+#include <boost/asio/io_context_strand.hpp>
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace eosio::chain {
+
+struct async_signal_subscriber::impl {
+   impl( std::string name, boost::asio::io_context& ioc, size_t max_queued, backpressure policy )
+   : name( std::move( name ) ), strand( ioc ), max_queued( std::max<size_t>( max_queued, 1 ) ), policy( policy ) {}
+
+   struct event {
+      fc::time_point        queued;
+      std::function<void()> handler;
+   };
+
+   void run_handler( const event& e ) {
+      try {
+         e.handler();
+      } catch( const fc::exception& ex ) {
+         wlog( "async signal subscriber ${n}: ${e}", ("n", name)("e", ex.to_detail_string()) );
+      } catch( const std::exception& ex ) {
+         wlog( "async signal subscriber ${n}: ${e}", ("n", name)("e", ex.what()) );
+      } catch( ... ) {
+         wlog( "async signal subscriber ${n}: unknown exception", ("n", name) );
+      }
+   }
+
+   // runs on the strand
+   void drain() {
+      std::unique_lock g( mtx );
+      while( !stopped && !queue.empty() ) {
+         event e = std::move( queue.front() );
+         queue.pop_front();
+         running = true;
+         g.unlock();
+         not_full.notify_one();
+
+         run_handler( e );
+
+         g.lock();
+         running = false;
+         ++dispatched;
+         idle.notify_all();
+      }
+      scheduled = false;
+   }
+
+   stats get_stats() const {
+      std::lock_guard g( mtx );
+      return { .name       = name,
+               .queued     = queue.size(),
+               .dispatched = dispatched,
+               .dropped    = dropped,
+               .lag        = queue.empty() ? fc::microseconds{} : fc::time_point::now() - queue.front().queued };
+   }
+
+   // live subscribers, for get_all_stats
+   static std::mutex                        registry_mtx;
+   static std::vector<std::weak_ptr<impl>>  registry;
+
+   const std::string               name;
+   boost::asio::io_context::strand strand;
+   const size_t                    max_queued;
+   const backpressure              policy;
+
+   mutable std::mutex      mtx;
+   std::condition_variable not_full;
+   std::condition_variable idle;
+   std::deque<event>       queue;            // guarded by mtx
+   bool                    scheduled = false; // guarded by mtx, a drain is posted to the strand
+   bool                    running   = false; // guarded by mtx, a handler is running on the strand
+   bool                    stopped   = false; // guarded by mtx
+   uint64_t                dispatched = 0;    // guarded by mtx
+   uint64_t                dropped    = 0;    // guarded by mtx
+};
+
+std::mutex                                              async_signal_subscriber::impl::registry_mtx;
+std::vector<std::weak_ptr<async_signal_subscriber::impl>> async_signal_subscriber::impl::registry;
+
+async_signal_subscriber::async_signal_subscriber( std::string name, boost::asio::io_context& ioc, size_t max_queued, backpressure policy )
+: _impl( std::make_shared<impl>( std::move( name ), ioc, max_queued, policy ) ) {
+   std::lock_guard g( impl::registry_mtx );
+   std::erase_if( impl::registry, []( const auto& w ) { return w.expired(); } );
+   impl::registry.emplace_back( _impl );
+}
+
+async_signal_subscriber::~async_signal_subscriber() {
+   stop();
+}
+
+void async_signal_subscriber::push( const std::shared_ptr<impl>& my, std::function<void()> handler ) {
+   std::unique_lock g( my->mtx );
+   if( my->stopped ) {
+      g.unlock();
+      my->run_handler( {fc::time_point::now(), std::move( handler )} );
+      return;
+   }
+   if( my->queue.size() >= my->max_queued ) {
+      if( my->policy == backpressure::block ) {
+         my->not_full.wait( g, [&]() { return my->stopped || my->queue.size() < my->max_queued; } );
+         if( my->stopped ) {
+            g.unlock();
+            my->run_handler( {fc::time_point::now(), std::move( handler )} );
+            return;
+         }
+      } else {
+         my->queue.pop_front();
+         ++my->dropped;
+      }
+   }
+   my->queue.push_back( {fc::time_point::now(), std::move( handler )} );
+   if( !my->scheduled ) {
+      my->scheduled = true;
+      boost::asio::post( my->strand, [my]() { my->drain(); } );
+   }
+}
+
+void async_signal_subscriber::stop() {
+   std::deque<impl::event> remaining;
+   {
+      std::unique_lock g( _impl->mtx );
+      if( _impl->stopped )
+         return;
+      _impl->stopped = true;
+      _impl->not_full.notify_all();
+      _impl->idle.wait( g, [this]() { return !_impl->running; } );
+      remaining.swap( _impl->queue );
+   }
+   for( const auto& e : remaining )
+      _impl->run_handler( e );
+}
+
+async_signal_subscriber::stats async_signal_subscriber::get_stats() const {
+   return _impl->get_stats();
+}
+
+std::vector<async_signal_subscriber::stats> async_signal_subscriber::get_all_stats() {
+   std::vector<std::shared_ptr<impl>> subscribers;
+   {
+      std::lock_guard g( impl::registry_mtx );
+      for( const auto& w : impl::registry ) {
+         if( auto s = w.lock() )
+            subscribers.emplace_back( std::move( s ) );
+      }
+   }
+   std::vector<stats> result;
+   result.reserve( subscribers.size() );
+   for( const auto& s : subscribers )
+      result.emplace_back( s->get_stats() );
+   return result;
+}
+
+} // namespace eosio::chain
@@ -478,7 +478,7 @@ namespace eosio { namespace chain {
 
          virtual uint32_t first_block_num()                                                   = 0;
          virtual void     append(const signed_block_ptr& b, const block_id_type& id,
-                                 const std::vector<char>& packed_block)                       = 0;
+                                 const packed_block_buffer& packed_block)                     = 0;
          virtual uint64_t get_block_pos(uint32_t block_num)                                   = 0;
          virtual void     reset(const genesis_state& gs, const signed_block_ptr& first_block) = 0;
          virtual void     reset(const chain_id_type& chain_id, uint32_t first_block_num)      = 0;
@@ -508,7 +508,7 @@ namespace eosio { namespace chain {
          }
 
          uint32_t first_block_num() final { return head ? head->ptr->block_num() : first_block_number; }
-         void append(const signed_block_ptr& b, const block_id_type& id, const std::vector<char>& packed_block) final {
+         void append(const signed_block_ptr& b, const block_id_type& id, const packed_block_buffer& packed_block) final {
             update_head(b, id);
          }
 
@@ -565,7 +565,7 @@ namespace eosio { namespace chain {
          virtual std::optional<signed_block_header> retry_read_block_header_by_num(uint32_t block_num) { return {}; }
 
          void append(const signed_block_ptr& b, const block_id_type& id,
-                     const std::vector<char>& packed_block) override {
+                     const packed_block_buffer& packed_block) override {
             try {
                EOS_ASSERT(genesis_written_to_block_log, block_log_append_fail,
                           "Cannot append to block log until the genesis is first written");
@@ -581,8 +581,10 @@ namespace eosio { namespace chain {
                           block_log_append_fail, "Append to index file occuring at wrong position.",
                           ("position", (uint64_t)index_file.tellp())(
                                 "expected", (b->block_num() - preamble.first_block_num) * sizeof(uint64_t)));
-               block_file.write(packed_block.data(), packed_block.size());
-               block_file.write((char*)&pos, sizeof(pos));
+               // block followed by its position, in one write
+               auto iov = packed_block.get_iovec();
+               iov.push_back(iovec{&pos, sizeof(pos)});
+               block_file.writev(iov.data(), iov.size());
                index_file.write((char*)&pos, sizeof(pos));
                index_file.flush();
                update_head(b, id);
@@ -733,7 +735,7 @@ namespace eosio { namespace chain {
 
          void reset(const genesis_state& gs, const signed_block_ptr& first_block) override {
             this->reset(1, gs, default_initial_version);
-            this->append(first_block, first_block->calculate_id(), fc::raw::pack(*first_block));
+            this->append(first_block, first_block->calculate_id(), pack_block(*first_block));
          }
 
          void reset(const chain_id_type& chain_id, uint32_t first_block_num) override {
@@ -1198,13 +1200,20 @@ namespace eosio { namespace chain {
       return my->version();
    }
 
+   packed_block_buffer pack_block(const signed_block& b) {
+      packed_block_buffer buf;
+      auto ds = buf.create_datastream();
+      fc::raw::pack(ds, b);
+      return buf;
+   }
+
    void block_log::append(const signed_block_ptr& b, const block_id_type& id) {
-      std::vector<char> packed_block = fc::raw::pack(*b);
+      packed_block_buffer packed_block = pack_block(*b);
       std::lock_guard g(my->mtx);
       my->append(b, id, packed_block);
    }
 
-   void block_log::append(const signed_block_ptr& b, const block_id_type& id, const std::vector<char>& packed_block) {
+   void block_log::append(const signed_block_ptr& b, const block_id_type& id, const packed_block_buffer& packed_block) {
       std::lock_guard g(my->mtx);
       my->append(b, id, packed_block);
    }
@@ -31,6 +31,7 @@
 #include <eosio/vm/allocator.hpp>
 #include <fc/io/json.hpp>
 #include <fc/log/logger_config.hpp>
+#include <fc/log/trace_spans.hpp>
 #include <fc/scoped_exit.hpp>
 #include <fc/variant_object.hpp>
 #include <bls12-381/bls12-381.hpp>
@@ -119,7 +120,7 @@ struct building_block {
                    const vector<digest_type>& new_protocol_feature_activations )
    :_pending_block_header_state_legacy( prev.next( when, num_prev_blocks_to_confirm ) )
    ,_new_protocol_feature_activations( new_protocol_feature_activations )
-   ,_trx_mroot_or_receipt_digests( digests_t{} )
+   ,_trx_mroot_or_receipt_merkle( merkle_accumulator{} )
    {}
 
    pending_block_header_state_legacy          _pending_block_header_state_legacy;
@@ -128,8 +129,12 @@ struct building_block {
    size_t                                     _num_new_protocol_features_that_have_activated = 0;
    deque<transaction_metadata_ptr>            _pending_trx_metas;
    deque<transaction_receipt>                 _pending_trx_receipts; // boost deque in 1.71 with 1024 elements performs better
-   std::variant<checksum256_type, digests_t>  _trx_mroot_or_receipt_digests;
-   digests_t                                  _action_receipt_digests;
+   // producing: merkle trees built as receipts are pushed, leaving only the final hashing of their right edge to
+   // finalize_block, which is on the path to signing.
+   // validating: the transaction mroot comes from the block and action receipt digests are only collected, then
+   // hashed on the thread pool while finalize_block updates resource limits.
+   std::variant<checksum256_type, merkle_accumulator> _trx_mroot_or_receipt_merkle;
+   std::variant<merkle_accumulator, digests_t>        _action_receipt_merkle_or_digests;
 };
 
 struct assembled_block {
@@ -246,6 +251,7 @@ struct controller_impl {
    controller::config              conf;
    const chain_id_type             chain_id; // read by thread_pool threads, value will not be changed
    bool                            replaying = false;
+   controller::block_report        replay_report;
    bool                            is_producer_node = false; // true if node is configured as a block producer
    db_read_mode                    read_mode = db_read_mode::HEAD;
    bool                            in_trx_requiring_checks = false; ///< if true, checks that are normally skipped on replay (e.g. auth checks) cannot be skipped
@@ -287,6 +293,23 @@ struct controller_impl {
       protocol_features.popped_blocks_to( prev->block_num );
    }
 
+   // merge the undo sessions of a transaction into the pending block, timed for the block report
+   template<typename... Sessions>
+   void squash_trx_sessions( Sessions&... sessions ) {
+      const auto start = fc::time_point::now();
+      ( sessions.squash(), ... );
+      pending->_block_report.db_squash_time += fc::time_point::now() - start;
+      ++pending->_block_report.db_squash_count;
+   }
+
+   template<typename Session>
+   void undo_trx_session( Session& session ) {
+      const auto start = fc::time_point::now();
+      session.undo();
+      pending->_block_report.db_undo_time += fc::time_point::now() - start;
+      ++pending->_block_report.db_undo_count;
+   }
+
    template<builtin_protocol_feature_t F>
    void on_activation();
 
@@ -323,6 +346,10 @@ struct controller_impl {
     thread_pool(),
     wasmif( conf.wasm_runtime, conf.eosvmoc_tierup, db, conf.state_dir, conf.eosvmoc_config, !conf.profile_accounts.empty() )
    {
+      if( conf.db_map_mode == pinnable_mapped_file::map_mode::heap || conf.db_map_mode == pinnable_mapped_file::map_mode::locked ) {
+         apply_memory_placement( db.get_segment_manager(), db.get_segment_manager()->get_size(), conf.state_placement, "chain state database" );
+      }
+
       fork_db.open( [this]( block_timestamp_type timestamp,
                             const flat_set<digest_type>& cur_features,
                             const vector<digest_type>& new_features )
@@ -416,9 +443,14 @@ struct controller_impl {
       }
    }
 
-   void log_irreversible() {
+   void log_irreversible( controller::block_report& br ) {
+      FC_TRACE_SPAN( "log_irreversible", "chain" );
       EOS_ASSERT( fork_db.root(), fork_database_exception, "fork database not properly initialized" );
 
+      auto report_undo_stack_depth = fc::make_scoped_exit([&]() {
+         br.undo_stack_depth = db.revision() - fork_db.root()->block_num;
+      });
+
       const std::optional<block_id_type> log_head_id = blog.head_id();
       const bool valid_log_head = !!log_head_id;
 
@@ -442,10 +474,10 @@ struct controller_impl {
       auto branch = fork_db.fetch_branch( fork_head->id, fork_head->dpos_irreversible_blocknum );
       try {
 
-         std::vector<std::future<std::vector<char>>> v;
+         std::vector<std::future<packed_block_buffer>> v;
          v.reserve( branch.size() );
          for( auto bitr = branch.rbegin(); bitr != branch.rend(); ++bitr ) {
-            v.emplace_back( post_async_task( thread_pool.get_executor(), [b=(*bitr)->block]() { return fc::raw::pack(*b); } ) );
+            v.emplace_back( post_async_task( thread_pool.get_executor(), [b=(*bitr)->block]() { return pack_block(*b); } ) );
          }
          auto it = v.begin();
 
@@ -462,7 +494,9 @@ struct controller_impl {
             blog.append( (*bitr)->block, (*bitr)->id, it->get() );
             ++it;
 
+            const auto commit_start = fc::time_point::now();
             db.commit( (*bitr)->block_num );
+            br.db_commit_time += fc::time_point::now() - commit_start;
             root_id = (*bitr)->id;
          }
       } catch( std::exception& ) {
@@ -518,6 +552,7 @@ struct controller_impl {
       }
 
       replaying = true;
+      replay_report = controller::block_report{};
       auto start_block_num = head->block_num + 1;
       auto start = fc::time_point::now();
 
@@ -588,6 +623,10 @@ struct controller_impl {
       ilog( "replayed ${n} blocks in ${duration} seconds, ${mspb} ms/block",
             ("n", head->block_num + 1 - start_block_num)("duration", (end-start).count()/1000000)
             ("mspb", ((end-start).count()/1000.0)/(head->block_num-start_block_num)) );
+      ilog( "replay phases: start_block ${sb} ms, execution ${ex} ms, finalize_block ${fb} ms, signals ${sig} ms, db commit ${c} ms",
+            ("sb", replay_report.start_block_time.count()/1000)("ex", replay_report.execution_time.count()/1000)
+            ("fb", replay_report.finalize_block_time.count()/1000)("sig", replay_report.signal_time.count()/1000)
+            ("c", replay_report.db_commit_time.count()/1000) );
       replaying = false;
 
       if( except_ptr ) {
@@ -851,6 +890,7 @@ struct controller_impl {
    }
 
    void add_to_snapshot( const snapshot_writer_ptr& snapshot ) {
+      FC_TRACE_SPAN( "add_to_snapshot", "chain", head->block_num );
       // clear in case the previous call to clear did not finish in time of deadline
       clear_expired_input_transactions( fc::time_point::maximum() );
 
@@ -1142,21 +1182,29 @@ struct controller_impl {
       auto& bb = std::get<building_block>(pending->_block_stage);
       auto orig_trx_receipts_size           = bb._pending_trx_receipts.size();
       auto orig_trx_metas_size              = bb._pending_trx_metas.size();
-      auto orig_trx_receipt_digests_size    = std::holds_alternative<digests_t>(bb._trx_mroot_or_receipt_digests) ?
-                                              std::get<digests_t>(bb._trx_mroot_or_receipt_digests).size() : 0;
-      auto orig_action_receipt_digests_size = bb._action_receipt_digests.size();
+      // appending can merge subtrees, restoring takes a copy of the O(log n) subtree roots
+      auto orig_trx_mroot_or_receipt_merkle = bb._trx_mroot_or_receipt_merkle;
+      std::optional<merkle_accumulator> orig_action_receipt_merkle;
+      size_t orig_action_receipt_digests_size = 0;
+      if( std::holds_alternative<merkle_accumulator>(bb._action_receipt_merkle_or_digests) )
+         orig_action_receipt_merkle = std::get<merkle_accumulator>(bb._action_receipt_merkle_or_digests);
+      else
+         orig_action_receipt_digests_size = std::get<digests_t>(bb._action_receipt_merkle_or_digests).size();
       std::function<void()> callback = [this,
             orig_trx_receipts_size,
             orig_trx_metas_size,
-            orig_trx_receipt_digests_size,
+            orig_trx_mroot_or_receipt_merkle{std::move(orig_trx_mroot_or_receipt_merkle)},
+            orig_action_receipt_merkle{std::move(orig_action_receipt_merkle)},
             orig_action_receipt_digests_size]()
       {
          auto& bb = std::get<building_block>(pending->_block_stage);
          bb._pending_trx_receipts.resize(orig_trx_receipts_size);
          bb._pending_trx_metas.resize(orig_trx_metas_size);
-         if( std::holds_alternative<digests_t>(bb._trx_mroot_or_receipt_digests) )
-            std::get<digests_t>(bb._trx_mroot_or_receipt_digests).resize(orig_trx_receipt_digests_size);
-         bb._action_receipt_digests.resize(orig_action_receipt_digests_size);
+         bb._trx_mroot_or_receipt_merkle = orig_trx_mroot_or_receipt_merkle;
+         if( orig_action_receipt_merkle )
+            bb._action_receipt_merkle_or_digests = *orig_action_receipt_merkle;
+         else
+            std::get<digests_t>(bb._action_receipt_merkle_or_digests).resize(orig_action_receipt_digests_size);
       };
 
       return fc::make_scoped_exit( std::move(callback) );
@@ -1217,8 +1265,7 @@ struct controller_impl {
          auto restore = make_block_restore_point();
          trace->receipt = push_receipt( gtrx.trx_id, transaction_receipt::soft_fail,
                                         trx_context.billed_cpu_time_us, trace->net_usage );
-         fc::move_append( std::get<building_block>(pending->_block_stage)._action_receipt_digests,
-                          std::move(trx_context.executed_action_receipt_digests) );
+         append_action_receipt_digests( trx_context );
 
          trx_context.squash();
          restore.cancel();
@@ -1403,16 +1450,14 @@ struct controller_impl {
                                         trx_context.billed_cpu_time_us,
                                         trace->net_usage );
 
-         fc::move_append( std::get<building_block>(pending->_block_stage)._action_receipt_digests,
-                          std::move(trx_context.executed_action_receipt_digests) );
+         append_action_receipt_digests( trx_context );
 
          trace->account_ram_delta = account_delta( gtrx.payer, trx_removal_ram_delta );
 
          dmlog_applied_transaction(trace);
          emit( self.applied_transaction, std::tie(trace, trx->packed_trx()) );
 
-         trx_context.squash();
-         undo_session.squash();
+         squash_trx_sessions( trx_context, undo_session );
 
          restore.cancel();
 
@@ -1437,7 +1482,7 @@ struct controller_impl {
         handle_exception(wrapper);
       }
 
-      trx_context.undo();
+      undo_trx_session( trx_context );
 
       // Only subjective OR soft OR hard failure logic below:
 
@@ -1530,11 +1575,24 @@ struct controller_impl {
       r.net_usage_words      = net_usage_words;
       r.status               = status;
       auto& bb = std::get<building_block>(pending->_block_stage);
-      if( std::holds_alternative<digests_t>(bb._trx_mroot_or_receipt_digests) )
-         std::get<digests_t>(bb._trx_mroot_or_receipt_digests).emplace_back( r.digest() );
+      if( std::holds_alternative<merkle_accumulator>(bb._trx_mroot_or_receipt_merkle) )
+         std::get<merkle_accumulator>(bb._trx_mroot_or_receipt_merkle).append( r.digest() );
       return r;
    }
 
+   void append_action_receipt_digests( transaction_context& trx_context ) {
+      auto& bb = std::get<building_block>(pending->_block_stage);
+      if( std::holds_alternative<merkle_accumulator>(bb._action_receipt_merkle_or_digests) ) {
+         auto& action_receipt_merkle = std::get<merkle_accumulator>(bb._action_receipt_merkle_or_digests);
+         for( const auto& d : trx_context.executed_action_receipt_digests )
+            action_receipt_merkle.append( d );
+         trx_context.executed_action_receipt_digests.clear();
+      } else {
+         fc::move_append( std::get<digests_t>(bb._action_receipt_merkle_or_digests),
+                          std::move(trx_context.executed_action_receipt_digests) );
+      }
+   }
+
    /**
     *  This is the entry point for new transactions to the block state. It will check authorization and
     *  determine whether to execute it now or to delay it. Lastly it inserts a transaction receipt into
@@ -1547,6 +1605,7 @@ struct controller_impl {
                                            bool explicit_billed_cpu_time,
                                            int64_t subjective_cpu_bill_us )
    {
+      FC_TRACE_SPAN( "push_transaction", "chain" );
       EOS_ASSERT(block_deadline != fc::time_point(), transaction_exception, "deadline cannot be uninitialized");
 
       transaction_trace_ptr trace;
@@ -1629,8 +1688,7 @@ struct controller_impl {
             }
 
             if ( !trx->is_read_only() ) {
-               fc::move_append( std::get<building_block>(pending->_block_stage)._action_receipt_digests,
-                                std::move(trx_context.executed_action_receipt_digests) );
+               append_action_receipt_digests( trx_context );
                 if ( !trx->is_dry_run() ) {
                    // call the accept signal but only once for this transaction
                    if (!trx->accepted) {
@@ -1651,10 +1709,10 @@ struct controller_impl {
                // save the trxs in the un-applied transaction queue for use during block validation to skip signature
                // recovery.
                restore.cancel();   // maintain trx metas for abort block
-               trx_context.undo(); // this will happen automatically in destructor, but make it more explicit
+               undo_trx_session( trx_context ); // this will happen automatically in destructor, but make it more explicit
             } else {
                restore.cancel();
-               trx_context.squash();
+               squash_trx_sessions( trx_context );
             }
 
             if( !trx->is_transient() ) {
@@ -1703,6 +1761,9 @@ struct controller_impl {
    {
       EOS_ASSERT( !pending, block_validate_exception, "pending block already exists" );
 
+      FC_TRACE_SPAN( "start_block", "chain", head->block_num + 1 );
+      const auto start = fc::time_point::now();
+
       emit( self.block_start, head->block_num + 1 );
 
       // at block level, no transaction specific logging is possible
@@ -1731,6 +1792,10 @@ struct controller_impl {
       auto& bb = std::get<building_block>(pending->_block_stage);
       const auto& pbhs = bb._pending_block_header_state_legacy;
 
+      // a block being validated is not signed here, its action receipts are hashed off the main thread
+      if( s != controller::block_status::incomplete && s != controller::block_status::ephemeral )
+         bb._action_receipt_merkle_or_digests = digests_t{};
+
       // block status is either ephemeral or incomplete. Modify state of speculative block only if we are building a
       // speculative incomplete block (otherwise we need clean state for head mode, ephemeral block)
       if ( pending->_block_status != controller::block_status::ephemeral )
@@ -1857,6 +1922,7 @@ struct controller_impl {
          update_producers_authority();
       }
 
+      pending->_block_report.start_block_time = fc::time_point::now() - start;
       guard_pending.cancel();
    } /// start_block
 
@@ -1867,21 +1933,19 @@ struct controller_impl {
 
       try {
 
+      FC_TRACE_SPAN( "finalize_block", "chain" );
+      const auto start = fc::time_point::now();
+
       auto& pbhs = pending->get_pending_block_header_state_legacy();
 
       auto& bb = std::get<building_block>(pending->_block_stage);
 
-      auto action_merkle_fut = post_async_task( thread_pool.get_executor(),
-                                                [ids{std::move( bb._action_receipt_digests )}]() mutable {
-                                                   return merkle( std::move( ids ) );
-                                                } );
-      const bool calc_trx_merkle = !std::holds_alternative<checksum256_type>(bb._trx_mroot_or_receipt_digests);
-      std::future<checksum256_type> trx_merkle_fut;
-      if( calc_trx_merkle ) {
-         trx_merkle_fut = post_async_task( thread_pool.get_executor(),
-                                           [ids{std::move( std::get<digests_t>(bb._trx_mroot_or_receipt_digests) )}]() mutable {
-                                              return merkle( std::move( ids ) );
-                                           } );
+      std::future<checksum256_type> action_merkle_fut;
+      if( std::holds_alternative<digests_t>(bb._action_receipt_merkle_or_digests) ) {
+         action_merkle_fut = post_async_task( thread_pool.get_executor(),
+                                              [ids{std::move( std::get<digests_t>(bb._action_receipt_merkle_or_digests) )}]() mutable {
+                                                 return merkle( std::move( ids ) );
+                                              } );
       }
 
       // Update resource limits:
@@ -1896,8 +1960,11 @@ struct controller_impl {
 
       // Create (unsigned) block:
       auto block_ptr = std::make_shared<signed_block>( pbhs.make_block_header(
-         calc_trx_merkle ? trx_merkle_fut.get() : std::get<checksum256_type>(bb._trx_mroot_or_receipt_digests),
-         action_merkle_fut.get(),
+         std::holds_alternative<checksum256_type>(bb._trx_mroot_or_receipt_merkle)
+            ? std::get<checksum256_type>(bb._trx_mroot_or_receipt_merkle)
+            : std::get<merkle_accumulator>(bb._trx_mroot_or_receipt_merkle).get_root(),
+         action_merkle_fut.valid() ? action_merkle_fut.get()
+                                   : std::get<merkle_accumulator>(bb._action_receipt_merkle_or_digests).get_root(),
          bb._new_pending_producer_schedule,
          std::move( bb._new_protocol_feature_activations ),
          protocol_features.get_protocol_feature_set()
@@ -1931,12 +1998,15 @@ struct controller_impl {
                                  std::move( block_ptr ),
                                  std::move( bb._new_pending_producer_schedule )
                               };
+
+      pending->_block_report.finalize_block_time = fc::time_point::now() - start;
    } FC_CAPTURE_AND_RETHROW() } /// finalize_block
 
    /**
     * @post regardless of the success of commit block there is no active pending block
     */
-   void commit_block( controller::block_status s ) {
+   void commit_block( controller::block_report& br, controller::block_status s ) {
+      FC_TRACE_SPAN( "commit_block", "chain" );
       auto reset_pending_on_exit = fc::make_scoped_exit([this]{
          pending.reset();
       });
@@ -1947,10 +2017,12 @@ struct controller_impl {
 
          const auto& bsp = std::get<completed_block>(pending->_block_stage)._block_state;
 
+         auto signal_start = fc::time_point::now();
          if( s == controller::block_status::incomplete ) {
             fork_db.add( bsp );
             fork_db.mark_valid( bsp );
             emit( self.accepted_block_header, std::tie(bsp->block, bsp->id) );
+            br.signal_time += fc::time_point::now() - signal_start;
             EOS_ASSERT( bsp == fork_db.head(), fork_database_exception, "committed block did not become the new head in fork database");
          } else if (s != controller::block_status::irreversible) {
             fork_db.mark_valid( bsp );
@@ -1962,10 +2034,14 @@ struct controller_impl {
             dm_logger->on_accepted_block(bsp);
          }
 
+         signal_start = fc::time_point::now();
          emit( self.accepted_block, std::tie(bsp->block, bsp->id) );
+         br.signal_time += fc::time_point::now() - signal_start;
 
          if( s == controller::block_status::incomplete ) {
-            log_irreversible();
+            const auto lib_start = fc::time_point::now();
+            log_irreversible( br );
+            br.log_irreversible_time += fc::time_point::now() - lib_start;
          }
       } catch (...) {
          // dont bother resetting pending, instead abort the block
@@ -2064,15 +2140,17 @@ struct controller_impl {
                      const trx_meta_cache_lookup& trx_lookup )
    { try {
       try {
+         FC_TRACE_SPAN( "apply_block", "chain", bsp->block_num );
          auto start = fc::time_point::now();
          const signed_block_ptr& b = bsp->block;
          const auto& new_protocol_feature_activations = bsp->get_new_protocol_feature_activations();
 
          auto producer_block_id = bsp->id;
          start_block( b->timestamp, b->confirmed, new_protocol_feature_activations, s, producer_block_id, fc::time_point::maximum() );
+         const auto execution_start = fc::time_point::now();
 
          // validated in create_block_state_future()
-         std::get<building_block>(pending->_block_stage)._trx_mroot_or_receipt_digests = b->transaction_mroot;
+         std::get<building_block>(pending->_block_stage)._trx_mroot_or_receipt_merkle = b->transaction_mroot;
 
          const bool existing_trxs_metas = !bsp->trxs_metas().empty();
          const bool pub_keys_recovered = bsp->is_pub_keys_recovered();
@@ -2112,10 +2190,16 @@ struct controller_impl {
          for( const auto& receipt : b->transactions ) {
             auto num_pending_receipts = trx_receipts.size();
             if( std::holds_alternative<packed_transaction>(receipt.trx) ) {
-               const auto& trx_meta = ( use_bsp_cached ? bsp->trxs_metas().at( packed_idx )
-                                                       : ( !!std::get<0>( trx_metas.at( packed_idx ) ) ?
-                                                             std::get<0>( trx_metas.at( packed_idx ) )
-                                                             : std::get<1>( trx_metas.at( packed_idx ) ).get() ) );
+               transaction_metadata_ptr trx_meta;
+               if( use_bsp_cached ) {
+                  trx_meta = bsp->trxs_metas().at( packed_idx );
+               } else if( std::get<0>( trx_metas.at( packed_idx ) ) ) {
+                  trx_meta = std::get<0>( trx_metas.at( packed_idx ) );
+               } else {
+                  const auto wait_start = fc::time_point::now();
+                  trx_meta = std::get<1>( trx_metas.at( packed_idx ) ).get();
+                  pending->_block_report.key_recovery_wait_time += fc::time_point::now() - wait_start;
+               }
                trace = push_transaction( trx_meta, fc::time_point::maximum(), fc::microseconds::maximum(), receipt.cpu_usage_us, true, 0 );
                ++packed_idx;
             } else if( std::holds_alternative<transaction_id_type>(receipt.trx) ) {
@@ -2145,6 +2229,8 @@ struct controller_impl {
                         ("lhs", r)("rhs", static_cast<const transaction_receipt_header&>(receipt)) );
          }
 
+         pending->_block_report.execution_time = fc::time_point::now() - execution_start;
+
          finalize_block();
 
          auto& ab = std::get<assembled_block>(pending->_block_stage);
@@ -2164,7 +2250,7 @@ struct controller_impl {
          pending->_block_stage = completed_block{ bsp };
 
          br = pending->_block_report; // copy before commit block destroys pending
-         commit_block(s);
+         commit_block(br, s);
          br.total_time = fc::time_point::now() - start;
          return;
       } catch ( const std::bad_alloc& ) {
@@ -2237,6 +2323,15 @@ struct controller_impl {
       return create_block_state_i( id, b, *prev );
    }
 
+   // thread safe, expected to be called from thread other than the main thread
+   block_state_legacy_ptr create_block_state( const block_id_type& id, const signed_block_ptr& b, const block_state_legacy& prev ) {
+      EOS_ASSERT( b, block_validate_exception, "null block" );
+      EOS_ASSERT( b->previous == prev.id, block_validate_exception,
+                  "block ${id} does not link to ${prev}", ("id", id)("prev", prev.id) );
+
+      return create_block_state_i( id, b, prev );
+   }
+
    void push_block( controller::block_report& br,
                     const block_state_legacy_ptr& bsp,
                     const forked_branch_callback& forked_branch_cb,
@@ -2269,7 +2364,9 @@ struct controller_impl {
          if( read_mode != db_read_mode::IRREVERSIBLE ) {
             maybe_switch_forks( br, fork_db.pending_head(), s, forked_branch_cb, trx_lookup );
          } else {
-            log_irreversible();
+            const auto lib_start = fc::time_point::now();
+            log_irreversible( br );
+            br.log_irreversible_time += fc::time_point::now() - lib_start;
          }
 
       } FC_LOG_AND_RETHROW( )
@@ -2319,7 +2416,9 @@ struct controller_impl {
             emit( self.irreversible_block, std::tie(bsp->block, bsp->id) );
 
             if (!self.skip_db_sessions(s)) {
+               const auto commit_start = fc::time_point::now();
                db.commit(bsp->block_num);
+               br.db_commit_time += fc::time_point::now() - commit_start;
             }
 
          } else {
@@ -2328,6 +2427,7 @@ struct controller_impl {
             maybe_switch_forks( br, bsp, s, forked_branch_callback{}, trx_meta_cache_lookup{} );
          }
 
+         replay_report += br;
       } FC_LOG_AND_RETHROW( )
    }
 
@@ -2421,8 +2521,11 @@ struct controller_impl {
          head_changed = false;
       }
 
-      if( head_changed )
-         log_irreversible();
+      if( head_changed ) {
+         const auto lib_start = fc::time_point::now();
+         log_irreversible( br );
+         br.log_irreversible_time += fc::time_point::now() - lib_start;
+      }
 
    } /// push_block
 
@@ -2799,6 +2902,8 @@ void controller::startup(std::function<void()> shutdown, std::function<bool()> c
 
 const chainbase::database& controller::db()const { return my->db; }
 
+const controller::block_report& controller::replay_report()const { return my->replay_report; }
+
 chainbase::database& controller::mutable_db()const { return my->db; }
 
 const fork_database& controller::fork_db()const { return my->fork_db; }
@@ -2976,8 +3081,13 @@ block_state_legacy_ptr controller::finalize_block( block_report& br, const signe
 }
 
 void controller::commit_block() {
+   block_report br;
+   commit_block( br );
+}
+
+void controller::commit_block( block_report& br ) {
    validate_db_available_size();
-   my->commit_block(block_status::incomplete);
+   my->commit_block(br, block_status::incomplete);
 }
 
 deque<transaction_metadata_ptr> controller::abort_block() {
@@ -2996,6 +3106,10 @@ block_state_legacy_ptr controller::create_block_state( const block_id_type& id,
    return my->create_block_state( id, b );
 }
 
+block_state_legacy_ptr controller::create_block_state( const block_id_type& id, const signed_block_ptr& b, const block_state_legacy& prev ) const {
+   return my->create_block_state( id, b, prev );
+}
+
 void controller::push_block( controller::block_report& br,
                              const block_state_legacy_ptr& bsp,
                              const forked_branch_callback& forked_branch_cb,
@@ -3422,6 +3536,9 @@ const apply_handler* controller::find_apply_handler( account_name receiver, acco
    }
    return nullptr;
 }
+bool controller::is_native_token_code( const digest_type& code_hash )const {
+   return my->conf.native_token_code_hashes.count( code_hash );
+}
 wasm_interface& controller::get_wasm_interface() {
    return my->get_wasm_interface();
 }
@@ -7,8 +7,18 @@
 #include <eosio/chain/global_property_object.hpp>
 #include <eosio/chain/account_object.hpp>
 #include <eosio/chain/protocol_feature_manager.hpp>
+#include <eosio/chain/deep_mind_writer.hpp>
 #include <fc/crypto/hex.hpp>
 
+// With a binary writer, lines go through its queue so they stay ordered with the binary block and trace records
+#define DEEP_MIND_LOG( FORMAT, ... ) \
+  FC_MULTILINE_MACRO_BEGIN \
+   if( _writer ) \
+      _writer->write_text( fc::format_string( FORMAT, fc::mutable_variant_object()__VA_ARGS__ ) ); \
+   else \
+      fc_dlog( _logger, FORMAT, __VA_ARGS__ ); \
+  FC_MULTILINE_MACRO_END
+
 namespace {
 
    void set_trace_elapsed_to_zero(eosio::chain::action_trace& trace) {
@@ -36,6 +46,11 @@ namespace eosio::chain {
       fc::logger::update( logger_name, _logger );
    }
 
+   void deep_mind_handler::update_writer(std::shared_ptr<deep_mind_writer> writer)
+   {
+      _writer = std::move(writer);
+   }
+
    static const char* prefix(deep_mind_handler::operation_qualifier q) {
       switch(q)
       {
@@ -49,34 +64,41 @@ namespace eosio::chain {
    void deep_mind_handler::on_startup(chainbase::database& db, uint32_t head_block_num)
    {
       // FIXME: We should probably feed that from CMake directly somehow ...
-      fc_dlog(_logger, "DEEP_MIND_VERSION leap 13 0");
+      DEEP_MIND_LOG("DEEP_MIND_VERSION leap 13 0");
 
-      fc_dlog(_logger, "ABIDUMP START ${block_num} ${global_sequence_num}",
+      DEEP_MIND_LOG("ABIDUMP START ${block_num} ${global_sequence_num}",
          ("block_num", head_block_num)
          ("global_sequence_num", db.get<dynamic_global_property_object>().global_action_sequence)
       );
       const auto& idx = db.get_index<account_index>();
       for (auto& row : idx.indices()) {
          if (row.abi.size() != 0) {
-            fc_dlog(_logger, "ABIDUMP ABI ${contract} ${abi}",
+            DEEP_MIND_LOG("ABIDUMP ABI ${contract} ${abi}",
                ("contract", row.name)
                ("abi", row.abi)
             );
          }
       }
-      fc_dlog(_logger, "ABIDUMP END");
+      DEEP_MIND_LOG("ABIDUMP END");
    }
 
    void deep_mind_handler::on_start_block(uint32_t block_num)
    {
-      fc_dlog(_logger, "START_BLOCK ${block_num}", ("block_num", block_num));
+      DEEP_MIND_LOG("START_BLOCK ${block_num}", ("block_num", block_num));
    }
 
    void deep_mind_handler::on_accepted_block(const std::shared_ptr<block_state_legacy>& bsp)
    {
+      if (_writer) {
+         // block state is immutable once accepted
+         _writer->write_packed(deep_mind_writer::record_type::accepted_block, bsp->block_num,
+                               [bsp]() { return fc::raw::pack(*bsp); });
+         return;
+      }
+
       auto packed_blk = fc::raw::pack(*bsp);
 
-      fc_dlog(_logger, "ACCEPTED_BLOCK ${num} ${blk}",
+      DEEP_MIND_LOG("ACCEPTED_BLOCK ${num} ${blk}",
          ("num", bsp->block_num)
          ("blk", fc::to_hex(packed_blk))
       );
@@ -84,7 +106,7 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_switch_forks(const block_id_type& old_head, const block_id_type& new_head)
    {
-      fc_dlog(_logger, "SWITCH_FORK ${from_id} ${to_id}",
+      DEEP_MIND_LOG("SWITCH_FORK ${from_id} ${to_id}",
          ("from_id", old_head)
          ("to_id", new_head)
       );
@@ -94,7 +116,7 @@ namespace eosio::chain {
    {
       auto packed_trx = fc::raw::pack(etrx);
 
-      fc_dlog(_logger, "TRX_OP CREATE onerror ${id} ${trx}",
+      DEEP_MIND_LOG("TRX_OP CREATE onerror ${id} ${trx}",
          ("id", etrx.id())
          ("trx", fc::to_hex(packed_trx))
       );
@@ -104,7 +126,7 @@ namespace eosio::chain {
    {
       auto packed_trx = fc::raw::pack(trx);
 
-      fc_dlog(_logger, "TRX_OP CREATE onblock ${id} ${trx}",
+      DEEP_MIND_LOG("TRX_OP CREATE onblock ${id} ${trx}",
          ("id", trx.id())
          ("trx", fc::to_hex(packed_trx))
       );
@@ -122,6 +144,20 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_applied_transaction(uint32_t block_num, const transaction_trace_ptr& trace)
    {
+      if (_writer) {
+         // trace is not modified after applied_transaction
+         _writer->write_packed(deep_mind_writer::record_type::applied_transaction, block_num,
+                               [trace, zero_elapsed = _config.zero_elapsed]() {
+                                  if (zero_elapsed) {
+                                     transaction_trace trace_copy = *trace;
+                                     set_trace_elapsed_to_zero(trace_copy);
+                                     return fc::raw::pack(trace_copy);
+                                  }
+                                  return fc::raw::pack(*trace);
+                               });
+         return;
+      }
+
       std::vector<char> packed_trace;
       
       if (_config.zero_elapsed) {
@@ -133,7 +169,7 @@ namespace eosio::chain {
          packed_trace = fc::raw::pack(*trace);
       }
 
-      fc_dlog(_logger, "APPLIED_TRANSACTION ${block} ${traces}",
+      DEEP_MIND_LOG("APPLIED_TRANSACTION ${block} ${traces}",
          ("block", block_num)
          ("traces", fc::to_hex(packed_trace))
       );
@@ -141,7 +177,7 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_add_ram_correction(const account_ram_correction_object& rco, uint64_t delta)
    {
-      fc_dlog(_logger, "RAM_CORRECTION_OP ${action_id} ${correction_id} ${event_id} ${payer} ${delta}",
+      DEEP_MIND_LOG("RAM_CORRECTION_OP ${action_id} ${correction_id} ${event_id} ${payer} ${delta}",
          ("action_id", _action_id)
          ("correction_id", rco.id._id)
          ("event_id", _ram_trace.event_id)
@@ -153,7 +189,7 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_preactivate_feature(const protocol_feature& feature)
    {
-      fc_dlog(_logger, "FEATURE_OP PRE_ACTIVATE ${action_id} ${feature_digest} ${feature}",
+      DEEP_MIND_LOG("FEATURE_OP PRE_ACTIVATE ${action_id} ${feature_digest} ${feature}",
          ("action_id", _action_id)
          ("feature_digest", feature.feature_digest)
          ("feature", feature.to_variant())
@@ -162,7 +198,7 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_activate_feature(const protocol_feature& feature)
    {
-      fc_dlog(_logger, "FEATURE_OP ACTIVATE ${feature_digest} ${feature}",
+      DEEP_MIND_LOG("FEATURE_OP ACTIVATE ${feature_digest} ${feature}",
          ("feature_digest", feature.feature_digest)
          ("feature", feature.to_variant())
       );
@@ -170,7 +206,7 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_input_action()
    {
-      fc_dlog(_logger, "CREATION_OP ROOT ${action_id}",
+      DEEP_MIND_LOG("CREATION_OP ROOT ${action_id}",
          ("action_id", _action_id)
       );
    }
@@ -180,25 +216,25 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_require_recipient()
    {
-      fc_dlog(_logger, "CREATION_OP NOTIFY ${action_id}",
+      DEEP_MIND_LOG("CREATION_OP NOTIFY ${action_id}",
          ("action_id", _action_id)
       );
    }
    void deep_mind_handler::on_send_inline()
    {
-      fc_dlog(_logger, "CREATION_OP INLINE ${action_id}",
+      DEEP_MIND_LOG("CREATION_OP INLINE ${action_id}",
          ("action_id", _action_id)
       );
    }
    void deep_mind_handler::on_send_context_free_inline()
    {
-      fc_dlog(_logger, "CREATION_OP CFA_INLINE ${action_id}",
+      DEEP_MIND_LOG("CREATION_OP CFA_INLINE ${action_id}",
          ("action_id", _action_id)
       );
    }
    void deep_mind_handler::on_cancel_deferred(operation_qualifier qual, const generated_transaction_object& gto)
    {
-      fc_dlog(_logger, "DTRX_OP ${qual}CANCEL ${action_id} ${sender} ${sender_id} ${payer} ${published} ${delay} ${expiration} ${trx_id} ${trx}",
+      DEEP_MIND_LOG("DTRX_OP ${qual}CANCEL ${action_id} ${sender} ${sender_id} ${payer} ${published} ${delay} ${expiration} ${trx_id} ${trx}",
          ("qual", prefix(qual))
          ("action_id", _action_id)
          ("sender", gto.sender)
@@ -213,7 +249,7 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_send_deferred(operation_qualifier qual, const generated_transaction_object& gto)
    {
-      fc_dlog(_logger, "DTRX_OP ${qual}CREATE ${action_id} ${sender} ${sender_id} ${payer} ${published} ${delay} ${expiration} ${trx_id} ${trx}",
+      DEEP_MIND_LOG("DTRX_OP ${qual}CREATE ${action_id} ${sender} ${sender_id} ${payer} ${published} ${delay} ${expiration} ${trx_id} ${trx}",
          ("qual", prefix(qual))
          ("action_id", _action_id)
          ("sender", gto.sender)
@@ -230,7 +266,7 @@ namespace eosio::chain {
    {
       auto packed_signed_trx = fc::raw::pack(packed_trx.get_signed_transaction());
 
-      fc_dlog(_logger, "DTRX_OP ${qual}CREATE ${action_id} ${sender} ${sender_id} ${payer} ${published} ${delay} ${expiration} ${trx_id} ${trx}",
+      DEEP_MIND_LOG("DTRX_OP ${qual}CREATE ${action_id} ${sender} ${sender_id} ${payer} ${published} ${delay} ${expiration} ${trx_id} ${trx}",
          ("qual", prefix(qual))
          ("action_id", _action_id)
          ("sender", gto.sender)
@@ -245,13 +281,13 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_fail_deferred()
    {
-      fc_dlog(_logger, "DTRX_OP FAILED ${action_id}",
+      DEEP_MIND_LOG("DTRX_OP FAILED ${action_id}",
          ("action_id", _action_id)
       );
    }
    void deep_mind_handler::on_create_table(const table_id_object& tid)
    {
-      fc_dlog(_logger, "TBL_OP INS ${action_id} ${code} ${scope} ${table} ${payer}",
+      DEEP_MIND_LOG("TBL_OP INS ${action_id} ${code} ${scope} ${table} ${payer}",
          ("action_id", _action_id)
          ("code", tid.code)
          ("scope", tid.scope)
@@ -261,7 +297,7 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_remove_table(const table_id_object& tid)
    {
-      fc_dlog(_logger, "TBL_OP REM ${action_id} ${code} ${scope} ${table} ${payer}",
+      DEEP_MIND_LOG("TBL_OP REM ${action_id} ${code} ${scope} ${table} ${payer}",
          ("action_id", _action_id)
          ("code", tid.code)
          ("scope", tid.scope)
@@ -271,7 +307,7 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_db_store_i64(const table_id_object& tid, const key_value_object& kvo)
    {
-      fc_dlog(_logger, "DB_OP INS ${action_id} ${payer} ${table_code} ${scope} ${table_name} ${primkey} ${ndata}",
+      DEEP_MIND_LOG("DB_OP INS ${action_id} ${payer} ${table_code} ${scope} ${table_name} ${primkey} ${ndata}",
          ("action_id", _action_id)
          ("payer", kvo.payer)
          ("table_code", tid.code)
@@ -283,7 +319,7 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_db_update_i64(const table_id_object& tid, const key_value_object& kvo, account_name payer, const char* buffer, std::size_t buffer_size)
    {
-      fc_dlog(_logger, "DB_OP UPD ${action_id} ${opayer}:${npayer} ${table_code} ${scope} ${table_name} ${primkey} ${odata}:${ndata}",
+      DEEP_MIND_LOG("DB_OP UPD ${action_id} ${opayer}:${npayer} ${table_code} ${scope} ${table_name} ${primkey} ${odata}:${ndata}",
          ("action_id", _action_id)
          ("opayer", kvo.payer)
          ("npayer", payer)
@@ -297,7 +333,7 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_db_remove_i64(const table_id_object& tid, const key_value_object& kvo)
    {
-      fc_dlog(_logger, "DB_OP REM ${action_id} ${payer} ${table_code} ${scope} ${table_name} ${primkey} ${odata}",
+      DEEP_MIND_LOG("DB_OP REM ${action_id} ${payer} ${table_code} ${scope} ${table_name} ${primkey} ${odata}",
          ("action_id", _action_id)
          ("payer", kvo.payer)
          ("table_code", tid.code)
@@ -309,43 +345,43 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_init_resource_limits(const resource_limits::resource_limits_config_object& config, const resource_limits::resource_limits_state_object& state)
    {
-      fc_dlog(_logger, "RLIMIT_OP CONFIG INS ${data}",
+      DEEP_MIND_LOG("RLIMIT_OP CONFIG INS ${data}",
          ("data", config)
       );
-      fc_dlog(_logger, "RLIMIT_OP STATE INS ${data}",
+      DEEP_MIND_LOG("RLIMIT_OP STATE INS ${data}",
          ("data", state)
       );
    }
    void deep_mind_handler::on_update_resource_limits_config(const resource_limits::resource_limits_config_object& config)
    {
-      fc_dlog(_logger, "RLIMIT_OP CONFIG UPD ${data}",
+      DEEP_MIND_LOG("RLIMIT_OP CONFIG UPD ${data}",
          ("data", config)
       );
    }
    void deep_mind_handler::on_update_resource_limits_state(const resource_limits::resource_limits_state_object& state)
    {
-      fc_dlog(_logger, "RLIMIT_OP STATE UPD ${data}",
+      DEEP_MIND_LOG("RLIMIT_OP STATE UPD ${data}",
          ("data", state)
       );
    }
    void deep_mind_handler::on_newaccount_resource_limits(const resource_limits::resource_limits_object& limits, const resource_limits::resource_usage_object& usage)
    {
-      fc_dlog(_logger, "RLIMIT_OP ACCOUNT_LIMITS INS ${data}",
+      DEEP_MIND_LOG("RLIMIT_OP ACCOUNT_LIMITS INS ${data}",
          ("data", limits)
       );
-      fc_dlog(_logger, "RLIMIT_OP ACCOUNT_USAGE INS ${data}",
+      DEEP_MIND_LOG("RLIMIT_OP ACCOUNT_USAGE INS ${data}",
          ("data", usage)
       );
    }
    void deep_mind_handler::on_update_account_usage(const resource_limits::resource_usage_object& usage)
    {
-      fc_dlog(_logger, "RLIMIT_OP ACCOUNT_USAGE UPD ${data}",
+      DEEP_MIND_LOG("RLIMIT_OP ACCOUNT_USAGE UPD ${data}",
          ("data", usage)
       );
    }
    void deep_mind_handler::on_set_account_limits(const resource_limits::resource_limits_object& limits)
    {
-      fc_dlog(_logger, "RLIMIT_OP ACCOUNT_LIMITS UPD ${data}",
+      DEEP_MIND_LOG("RLIMIT_OP ACCOUNT_LIMITS UPD ${data}",
          ("data", limits)
       );
    }
@@ -355,7 +391,7 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_ram_event(account_name account, uint64_t new_usage, int64_t delta)
    {
-      fc_dlog(_logger, "RAM_OP ${action_id} ${event_id} ${family} ${operation} ${legacy_tag} ${payer} ${new_usage} ${delta}",
+      DEEP_MIND_LOG("RAM_OP ${action_id} ${event_id} ${family} ${operation} ${legacy_tag} ${payer} ${new_usage} ${delta}",
          ("action_id", _action_id)
          ("event_id", _ram_trace.event_id)
          ("family", _ram_trace.family)
@@ -370,7 +406,7 @@ namespace eosio::chain {
 
    void deep_mind_handler::on_create_permission(const permission_object& p)
    {
-      fc_dlog(_logger, "PERM_OP INS ${action_id} ${permission_id} ${data}",
+      DEEP_MIND_LOG("PERM_OP INS ${action_id} ${permission_id} ${data}",
          ("action_id", _action_id)
          ("permission_id", p.id)
          ("data", p)
@@ -378,7 +414,7 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_modify_permission(const permission_object& old_permission, const permission_object& new_permission)
    {
-      fc_dlog(_logger, "PERM_OP UPD ${action_id} ${permission_id} ${data}",
+      DEEP_MIND_LOG("PERM_OP UPD ${action_id} ${permission_id} ${data}",
          ("action_id", _action_id)
          ("permission_id", new_permission.id)
          ("data", fc::mutable_variant_object()
@@ -389,7 +425,7 @@ namespace eosio::chain {
    }
    void deep_mind_handler::on_remove_permission(const permission_object& permission)
    {
-      fc_dlog(_logger, "PERM_OP REM ${action_id} ${permission_id} ${data}",
+      DEEP_MIND_LOG("PERM_OP REM ${action_id} ${permission_id} ${data}",
         ("action_id", _action_id)
         ("permission_id", permission.id)
         ("data", permission)
@@ -0,0 +1,178 @@
+#include <eosio/chain/deep_mind_writer.hpp>
+#include <eosio/chain/exceptions.hpp>
+
+#include <fc/log/logger_config.hpp> //set_thread_name()
+
+#include <boost/endian/conversion.hpp>
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace eosio::chain {
+
+namespace {
+
+int open_destination( const std::string& destination ) {
+   if( destination == "-" )
+      return STDOUT_FILENO;
+
+   static const std::string unix_prefix = "unix:";
+   if( destination.rfind( unix_prefix, 0 ) == 0 ) {
+      const std::string path = destination.substr( unix_prefix.size() );
+      sockaddr_un addr{};
+      EOS_ASSERT( path.size() < sizeof( addr.sun_path ), misc_exception, "deep mind socket path too long: ${p}", ("p", path) );
+      addr.sun_family = AF_UNIX;
+      std::strncpy( addr.sun_path, path.c_str(), sizeof( addr.sun_path ) - 1 );
+
+      int fd = ::socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+      EOS_ASSERT( fd >= 0, misc_exception, "unable to create deep mind socket: ${e}", ("e", std::strerror( errno )) );
+      if( ::connect( fd, reinterpret_cast<const sockaddr*>( &addr ), sizeof( addr ) ) != 0 ) {
+         const int err = errno;
+         ::close( fd );
+         EOS_THROW( misc_exception, "unable to connect to deep mind socket ${p}: ${e}", ("p", path)("e", std::strerror( err )) );
+      }
+      return fd;
+   }
+
+   // opening a fifo blocks until the consumer opens it for reading
+   int fd = ::open( destination.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644 );
+   EOS_ASSERT( fd >= 0, misc_exception, "unable to open deep mind output ${d}: ${e}", ("d", destination)("e", std::strerror( errno )) );
+   return fd;
+}
+
+} // anonymous namespace
+
+deep_mind_writer::deep_mind_writer( const std::string& destination, uint32_t max_queued_records )
+   : _fd( open_destination( destination ) )
+   , _owns_fd( _fd != STDOUT_FILENO )
+   , _max_queued_records( std::max<uint32_t>( max_queued_records, 1 ) )
+   , _thread( [this]() { run(); } ) {
+}
+
+deep_mind_writer::~deep_mind_writer() {
+   {
+      std::lock_guard g( _mtx );
+      _done = true;
+   }
+   _not_empty.notify_one();
+   _thread.join();
+   if( _owns_fd )
+      ::close( _fd );
+}
+
+void deep_mind_writer::write_text( std::string line ) {
+   push( record{ .type = record_type::text, .text = std::move( line ) } );
+}
+
+void deep_mind_writer::write_packed( record_type type, uint32_t block_num, packer_type pack ) {
+   push( record{ .type = type, .block_num = block_num, .pack = std::move( pack ) } );
+}
+
+void deep_mind_writer::flush() {
+   std::unique_lock g( _mtx );
+   _drained.wait( g, [this]() { return _queue.empty() && !_writing; } );
+}
+
+void deep_mind_writer::push( record&& r ) {
+   {
+      std::unique_lock g( _mtx );
+      _not_full.wait( g, [this]() { return _queue.size() < _max_queued_records; } );
+      _queue.emplace_back( std::move( r ) );
+   }
+   _not_empty.notify_one();
+}
+
+void deep_mind_writer::run() {
+   fc::set_thread_name( "deep-mind" );
+   // SIGPIPE of a failed write is delivered to the writing thread; blocked here so a consumer going away is reported
+   // as EPIPE by write_all() instead of killing the process, without changing the disposition for the whole process
+   sigset_t sigpipe;
+   sigemptyset( &sigpipe );
+   sigaddset( &sigpipe, SIGPIPE );
+   pthread_sigmask( SIG_BLOCK, &sigpipe, nullptr );
+
+   std::unique_lock g( _mtx );
+   for( ;; ) {
+      _not_empty.wait( g, [this]() { return !_queue.empty() || _done; } );
+      if( _queue.empty() )
+         break; // _done and drained
+
+      record r = std::move( _queue.front() );
+      _queue.pop_front();
+      _writing = true;
+      g.unlock();
+      _not_full.notify_one();
+
+      try {
+         write_record( r );
+      } catch( ... ) {
+         fprintf( stderr, "DMLOG BINARY_PACK_FAILURE_TERMINATED\n" );
+         _stopped = true;
+         kill( getpid(), SIGTERM );
+      }
+
+      g.lock();
+      _writing = false;
+      if( _queue.empty() )
+         _drained.notify_all();
+   }
+}
+
+void deep_mind_writer::write_record( const record& r ) {
+   if( _stopped )
+      return;
+
+   std::vector<char> body;
+   if( r.type == record_type::text ) {
+      body.assign( r.text.begin(), r.text.end() );
+   } else {
+      std::vector<char> packed = r.pack();
+      body.resize( sizeof( uint32_t ) + packed.size() );
+      const uint32_t num = boost::endian::native_to_little( r.block_num );
+      std::memcpy( body.data(), &num, sizeof( num ) );
+      std::memcpy( body.data() + sizeof( num ), packed.data(), packed.size() );
+   }
+
+   char header[sizeof( uint32_t ) + 1];
+   const uint32_t length = boost::endian::native_to_little( static_cast<uint32_t>( body.size() + 1 ) );
+   std::memcpy( header, &length, sizeof( length ) );
+   header[sizeof( length )] = static_cast<char>( r.type );
+
+   write_all( header, sizeof( header ) );
+   write_all( body.data(), body.size() );
+}
+
+void deep_mind_writer::write_all( const char* data, size_t size ) {
+   while( !_stopped && size ) {
+      const ssize_t written = ::write( _fd, data, size );
+      if( written < 0 ) {
+         if( errno == EINTR )
+            continue;
+         const int err = errno;
+         if( err == EPIPE ) {
+            // discard the SIGPIPE left pending by the failed write
+            sigset_t sigpipe;
+            sigemptyset( &sigpipe );
+            sigaddset( &sigpipe, SIGPIPE );
+            const timespec no_wait{};
+            sigtimedwait( &sigpipe, nullptr, &no_wait );
+         }
+         // same as the text mode dmlog appender: a consumer missing records is worse than stopping the node
+         fprintf( stderr, "DMLOG BINARY_WRITE_FAILURE_TERMINATED %s\n", std::strerror( err ) );
+         _stopped = true;
+         kill( getpid(), SIGTERM );
+         return;
+      }
+      data += written;
+      size -= written;
+   }
+}
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <fc/time.hpp>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/signals2/signal.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace eosio::chain {
+
+/**
+ * Opt-in asynchronous delivery of controller signals to a plugin.
+ *
+ * Controller signals are emitted on the main thread and every inline subscriber adds to block processing time. A
+ * subscriber that does not read chain state when signalled can connect through an async_signal_subscriber instead.
+ * The slot then only copies the signal argument (shared_ptrs, ids) into a bounded queue, and the handlers run in
+ * signal order on a strand of the plugin's own io_context. Subscribers that need the chain state of the moment, such
+ * as state history delta capture, must stay connected inline.
+ *
+ * When the queue is full, backpressure::block makes the signalling thread wait for the subscriber, for subscribers
+ * that must see every event. backpressure::drop_oldest discards the oldest queued event instead.
+ */
+class async_signal_subscriber {
+public:
+   enum class backpressure { block, drop_oldest };
+
+   struct stats {
+      std::string      name;
+      size_t           queued = 0;
+      uint64_t         dispatched = 0;
+      uint64_t         dropped = 0;
+      fc::microseconds lag; ///< time the oldest queued event has been waiting
+   };
+
+   /// @param ioc must not be run by the signalling thread when `policy` is backpressure::block
+   async_signal_subscriber( std::string name, boost::asio::io_context& ioc, size_t max_queued, backpressure policy );
+   /// calls stop()
+   ~async_signal_subscriber();
+
+   async_signal_subscriber( const async_signal_subscriber& ) = delete;
+   async_signal_subscriber& operator=( const async_signal_subscriber& ) = delete;
+
+   /// Connect `f` to `sig`. `f` is called on the subscriber's strand with an owning copy of the signal argument,
+   /// tuples of references are copied to tuples of values.
+   template<typename Signal, typename F>
+   boost::signals2::connection connect( Signal& sig, F f ) {
+      using arg_type   = typename Signal::template arg<0>::type;
+      using owned_type = typename owned<std::decay_t<arg_type>>::type;
+      return sig.connect( [impl = _impl, f = std::move( f )]( arg_type a ) {
+         push( impl, [f, a = owned_type( a )]() { f( a ); } );
+      } );
+   }
+
+   /// Waits for a running handler, then runs the handlers of the queued events on the calling thread. Events
+   /// signalled afterwards are handled inline. Call from the signalling thread before the io_context is stopped.
+   void stop();
+
+   stats get_stats() const;
+
+   /// stats of every live subscriber
+   static std::vector<stats> get_all_stats();
+
+private:
+   template<typename T>
+   struct owned { using type = T; };
+   template<typename... Ts>
+   struct owned<std::tuple<Ts...>> { using type = std::tuple<std::decay_t<Ts>...>; };
+
+   struct impl;
+   static void push( const std::shared_ptr<impl>& my, std::function<void()> handler );
+
+   std::shared_ptr<impl> _impl;
+};
+
+} // namespace eosio::chain
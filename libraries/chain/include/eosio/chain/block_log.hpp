@@ -1,5 +1,6 @@
 #pragma once
 #include <fc/filesystem.hpp>
+#include <fc/io/chained_buffer.hpp>
 #include <eosio/chain/block.hpp>
 #include <eosio/chain/genesis_state.hpp>
 #include <eosio/chain/block_log_config.hpp>
@@ -40,6 +41,11 @@ namespace eosio { namespace chain {
     */
 
 
+   /// a signed_block packed for block_log::append(), written to the log with a single writev()
+   using packed_block_buffer = fc::chained_buffer<64*1024>;
+
+   packed_block_buffer pack_block(const signed_block& b);
+
    class block_log {
       public:
          explicit block_log(const std::filesystem::path& data_dir, const block_log_config& config = block_log_config{});
@@ -47,7 +53,7 @@ namespace eosio { namespace chain {
          ~block_log();
 
          void append(const signed_block_ptr& b, const block_id_type& id);
-         void append(const signed_block_ptr& b, const block_id_type& id, const std::vector<char>& packed_block);
+         void append(const signed_block_ptr& b, const block_id_type& id, const packed_block_buffer& packed_block);
 
          void flush();
          void reset( const genesis_state& gs, const signed_block_ptr& genesis_block );
@@ -9,6 +9,7 @@
 #include <eosio/chain/snapshot.hpp>
 #include <eosio/chain/protocol_feature_manager.hpp>
 #include <eosio/chain/webassembly/eos-vm-oc/config.hpp>
+#include <eosio/chain/memory_placement.hpp>
 
 namespace chainbase {
    class database;
@@ -95,12 +96,14 @@ namespace eosio { namespace chain {
             validation_mode          block_validation_mode  = validation_mode::FULL;
 
             pinnable_mapped_file::map_mode db_map_mode      = pinnable_mapped_file::map_mode::mapped;
+            memory_placement         state_placement; ///< only applied in heap and locked db_map_mode
 
             flat_set<account_name>   resource_greylist;
             flat_set<account_name>   trusted_producers;
             uint32_t                 greylist_limit         = chain::config::maximum_elastic_resource_multiplier;
 
             flat_set<account_name>   profile_accounts;
+            flat_set<digest_type>    native_token_code_hashes; ///< eosio.token builds whose transfer is applied natively, see native_token::apply
          };
 
          enum class block_status {
@@ -161,16 +164,56 @@ namespace eosio { namespace chain {
             size_t             total_cpu_usage_us = 0;
             fc::microseconds   total_elapsed_time{};
             fc::microseconds   total_time{};
+
+            // wall clock time of each phase of the block lifecycle on the main thread
+            fc::microseconds   start_block_time{};
+            fc::microseconds   execution_time{};             // applying the transactions of a received block
+            fc::microseconds   key_recovery_wait_time{};     // part of execution_time spent waiting on signature recovery
+            fc::microseconds   finalize_block_time{};        // resource limits, merkle roots, block summary
+            fc::microseconds   signal_time{};                // accepted_block_header and accepted_block subscribers
+            fc::microseconds   log_irreversible_time{};      // irreversible_block subscribers, block log append, db commit
+
+            // chainbase undo sessions
+            size_t             db_squash_count = 0;          // transaction undo sessions merged into the block session
+            fc::microseconds   db_squash_time{};
+            size_t             db_undo_count = 0;            // transaction undo sessions rolled back
+            fc::microseconds   db_undo_time{};
+            fc::microseconds   db_commit_time{};             // part of log_irreversible_time
+            int64_t            undo_stack_depth = 0;         // revisions on the undo stack once irreversible ones are committed
+
+            /// sums the reports of several blocks, undo_stack_depth is taken from `r` as the later block
+            block_report& operator+=( const block_report& r ) {
+               total_net_usage        += r.total_net_usage;
+               total_cpu_usage_us     += r.total_cpu_usage_us;
+               total_elapsed_time     += r.total_elapsed_time;
+               total_time             += r.total_time;
+               start_block_time       += r.start_block_time;
+               execution_time         += r.execution_time;
+               key_recovery_wait_time += r.key_recovery_wait_time;
+               finalize_block_time    += r.finalize_block_time;
+               signal_time            += r.signal_time;
+               log_irreversible_time  += r.log_irreversible_time;
+               db_squash_count        += r.db_squash_count;
+               db_squash_time         += r.db_squash_time;
+               db_undo_count          += r.db_undo_count;
+               db_undo_time           += r.db_undo_time;
+               db_commit_time         += r.db_commit_time;
+               undo_stack_depth        = r.undo_stack_depth;
+               return *this;
+            }
          };
 
          block_state_legacy_ptr finalize_block( block_report& br, const signer_callback_type& signer_callback );
          void sign_block( const signer_callback_type& signer_callback );
          void commit_block();
+         void commit_block( block_report& br );
 
          // thread-safe
          std::future<block_state_legacy_ptr> create_block_state_future( const block_id_type& id, const signed_block_ptr& b );
          // thread-safe
          block_state_legacy_ptr create_block_state( const block_id_type& id, const signed_block_ptr& b ) const;
+         // thread-safe, validates b on top of prev which does not need to be in the fork database yet
+         block_state_legacy_ptr create_block_state( const block_id_type& id, const signed_block_ptr& b, const block_state_legacy& prev ) const;
 
          /**
           * @param br returns statistics for block
@@ -187,6 +230,9 @@ namespace eosio { namespace chain {
 
          const chainbase::database& db()const;
 
+         /// totals over the blocks replayed from the block log and fork database on startup
+         const block_report& replay_report()const;
+
          const fork_database& fork_db()const;
 
          const account_object&                 get_account( account_name n )const;
@@ -337,6 +383,7 @@ namespace eosio { namespace chain {
          signal<void(std::tuple<const transaction_trace_ptr&, const packed_transaction_ptr&>)> applied_transaction;
 
          const apply_handler* find_apply_handler( account_name contract, scope_name scope, action_name act )const;
+         bool is_native_token_code( const digest_type& code_hash )const;
          wasm_interface& get_wasm_interface();
 
       static chain_id_type extract_chain_id(snapshot_reader& snapshot);
@@ -17,6 +17,7 @@ struct signed_transaction;
 struct packed_transaction;
 struct transaction_trace;
 struct ram_trace;
+class deep_mind_writer;
 namespace resource_limits {
    class resource_limits_config_object;
    class resource_limits_state_object;
@@ -52,6 +53,8 @@ public:
    void update_config(deep_mind_config config);
 
    void update_logger(const std::string& logger_name);
+   /// write binary framed records through `writer` instead of text lines to the logger, nullptr to go back to text
+   void update_writer(std::shared_ptr<deep_mind_writer> writer);
    enum class operation_qualifier { none, modify, push };
 
    void on_startup(chainbase::database& db, uint32_t head_block_num);
@@ -97,6 +100,7 @@ private:
    ram_trace        _ram_trace;
    deep_mind_config _config;
    fc::logger       _logger;
+   std::shared_ptr<deep_mind_writer> _writer;
 };
 
 }
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <eosio/chain/types.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace eosio::chain {
+
+/**
+ * Binary framed deep-mind output written by a background thread.
+ *
+ * Each record is framed as a little endian uint32 length of the rest of the record followed by a uint8 record type:
+ *   - text:                a deep-mind line as logged in text mode, without the "DMLOG " prefix and newline
+ *   - accepted_block:      little endian uint32 block number followed by the fc::raw packed block_state_legacy
+ *   - applied_transaction: little endian uint32 block number followed by the fc::raw packed transaction_trace
+ *
+ * Blocks and traces are packed on the writer thread, the main thread only enqueues a packer holding on to them. The
+ * queue is bounded; the main thread blocks when it is full rather than dropping records, as deep-mind consumers
+ * require every record.
+ */
+class deep_mind_writer {
+public:
+   enum class record_type : uint8_t { text = 0, accepted_block = 1, applied_transaction = 2 };
+
+   /// destination is a file or fifo path, "-" for stdout or "unix:<path>" to connect to a listening unix socket
+   deep_mind_writer( const std::string& destination, uint32_t max_queued_records );
+   /// writes out all queued records before returning
+   ~deep_mind_writer();
+
+   deep_mind_writer( const deep_mind_writer& ) = delete;
+   deep_mind_writer& operator=( const deep_mind_writer& ) = delete;
+
+   using packer_type = std::function<std::vector<char>()>;
+
+   void write_text( std::string line );
+   /// `pack` is called on the writer thread, it must only reference immutable data
+   void write_packed( record_type type, uint32_t block_num, packer_type pack );
+
+   /// blocks until every record queued so far has been written
+   void flush();
+
+private:
+   struct record {
+      record_type type;
+      uint32_t    block_num = 0;
+      std::string text;
+      packer_type pack;
+   };
+
+   void push( record&& r );
+   void run();
+   void write_record( const record& r );
+   void write_all( const char* data, size_t size );
+
+   int                     _fd = -1;
+   bool                    _owns_fd = false;
+   bool                    _stopped = false; // write failed, nothing more is written
+   const uint32_t          _max_queued_records;
+   std::mutex              _mtx;
+   std::condition_variable _not_empty;
+   std::condition_variable _not_full;
+   std::condition_variable _drained;
+   std::deque<record>      _queue;     // guarded by _mtx
+   bool                    _writing = false; // guarded by _mtx, a popped record is being written
+   bool                    _done    = false; // guarded by _mtx
+   std::thread             _thread;
+};
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace eosio::chain {
+
+/**
+ * Placement hints for large, long lived, randomly accessed memory regions: the chain state database when it is
+ * loaded in to memory (database-map-mode heap/locked), EOS VM OC wasm memories and the EOS VM OC code cache mapping.
+ */
+struct memory_placement {
+   bool                    huge_pages = false; ///< ask for transparent huge pages via madvise(MADV_HUGEPAGE)
+   std::optional<uint32_t> numa_node;          ///< bind (and migrate already faulted) pages to this NUMA node
+
+   bool empty() const { return !huge_pages && !numa_node; }
+};
+
+/**
+ * Apply placement hints to [addr, addr+size). Failures are logged and otherwise ignored as the hints only affect
+ * performance; e.g. transparent huge pages may be disabled system wide or the NUMA node may not exist.
+ * No-op on platforms without madvise/mbind support.
+ * @param desc description of the memory region used in log messages
+ */
+void apply_memory_placement(void* addr, size_t size, const memory_placement& placement, const char* desc);
+
+} // namespace eosio::chain
@@ -19,4 +19,22 @@ namespace eosio { namespace chain {
     */
    digest_type merkle( deque<digest_type> ids );
 
+   /**
+    *  Calculates the same root as merkle() from digests appended one at a time, as they are produced. Only the roots
+    *  of the complete subtrees are kept, so append() hashes once amortized and get_root() at most log2(n) times.
+    */
+   class merkle_accumulator {
+   public:
+      void append( const digest_type& digest );
+
+      /// merkle() of all the digests appended
+      digest_type get_root() const;
+
+      uint64_t size() const { return _count; }
+
+   private:
+      uint64_t            _count = 0;
+      vector<digest_type> _subtrees; ///< roots of the complete subtrees, largest first, one per bit set in _count
+   };
+
 } } /// eosio::chain
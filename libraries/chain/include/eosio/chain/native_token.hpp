@@ -0,0 +1,22 @@
+#pragma once
+
+namespace eosio { namespace chain {
+
+   class apply_context;
+
+   namespace native_token {
+
+   /**
+    *  Applies eosio.token::transfer without the wasm runtime. It is only called for code hashes listed in
+    *  controller::config::native_token_code_hashes, which must be builds of the reference eosio.token contract.
+    *
+    *  The action is applied through the same apply_context calls the contract makes through intrinsics, in the same
+    *  order and with the same assertion messages, so state changes, RAM deltas, notifications and traces are identical
+    *  to those of the wasm. Returns false, before changing anything, for any other action and for action data or table
+    *  rows the contract would fail to deserialize, so the wasm runs and reports the failure itself.
+    */
+   bool apply( apply_context& context );
+
+   } /// namespace native_token
+
+} } /// namespace eosio::chain
@@ -28,6 +28,9 @@ namespace eosio { namespace chain {
 
    struct by_expiration;
    struct by_trx_id;
+   // by_trx_id is only used for lookups and would be cheaper as a hashed index, but chainbase undo_index supports
+   // ordered_unique indices only; the dedupe, block summary and generated transaction tables stay ordered until
+   // chainbase provides an undo-aware hashed index
    using transaction_multi_index = chainbase::shared_multi_index_container<
       transaction_object,
       indexed_by<
@@ -52,13 +52,13 @@ struct eosvmoc_tier {
       : cc(d, c, db) {
       // Construct exec and mem for the main thread
       exec = std::make_unique<eosvmoc::executor>(cc);
-      mem  = std::make_unique<eosvmoc::memory>(wasm_constraints::maximum_linear_memory/wasm_constraints::wasm_page_size);
+      mem  = std::make_unique<eosvmoc::memory>(wasm_constraints::maximum_linear_memory/wasm_constraints::wasm_page_size, c.placement);
    }
 
    // Called from read-only threads
    void init_thread_local_data() {
       exec = std::make_unique<eosvmoc::executor>(cc);
-      mem  = std::make_unique<eosvmoc::memory>(eosvmoc::memory::sliced_pages_for_ro_thread);
+      mem  = std::make_unique<eosvmoc::memory>(eosvmoc::memory::sliced_pages_for_ro_thread, cc.get_config().placement);
    }
 
    eosvmoc::code_cache_async cc;
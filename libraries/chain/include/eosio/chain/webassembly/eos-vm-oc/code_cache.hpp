@@ -42,6 +42,7 @@ class code_cache_base {
       ~code_cache_base();
 
       const int& fd() const { return _cache_fd; }
+      const eosvmoc::config& get_config() const { return _eosvmoc_config; }
 
       void free_code(const digest_type& code_id, const uint8_t& vm_version);
 
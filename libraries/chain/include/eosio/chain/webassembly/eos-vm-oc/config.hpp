@@ -5,6 +5,8 @@
 #include <vector>
 #include <string>
 
+#include <eosio/chain/memory_placement.hpp>
+
 #include <fc/io/raw.hpp>
 
 #include <sys/resource.h>
@@ -23,6 +25,9 @@ struct config {
    std::optional<rlim_t>   vm_limit  {512u*1024u*1024u};
    std::optional<uint64_t> stack_size_limit {16u*1024u};
    std::optional<size_t>   generated_code_size_limit {16u*1024u*1024u};
+
+   // placement of wasm memories and the code cache mapping in nodeos; not used by, and so not sent to, the compile monitor
+   memory_placement        placement;
 };
 
 //work around unexpected std::optional behavior
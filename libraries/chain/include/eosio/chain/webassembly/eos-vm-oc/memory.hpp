@@ -2,6 +2,7 @@
 #include <fc/exception/exception.hpp>
 
 #include <eosio/chain/wasm_eosio_constraints.hpp>
+#include <eosio/chain/memory_placement.hpp>
 #include <eosio/chain/webassembly/eos-vm-oc/eos-vm-oc.h>
 #include <eosio/chain/webassembly/eos-vm-oc/intrinsic_mapping.hpp>
 #include <eosio/chain/webassembly/eos-vm-oc/gs_seg_helpers.h>
@@ -25,7 +26,7 @@ class memory {
       static constexpr uint64_t total_memory_per_slice = memory_prologue_size + UINT64_C(0x200000000) + UINT64_C(4096);
 
    public:
-      explicit memory(uint64_t sliced_pages);
+      explicit memory(uint64_t sliced_pages, const memory_placement& placement = {});
       ~memory();
       memory(const memory&) = delete;
       memory& operator=(const memory&) = delete;
@@ -0,0 +1,51 @@
+#include <eosio/chain/memory_placement.hpp>
+#include <fc/log/logger.hpp>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace eosio::chain {
+
+void apply_memory_placement(void* addr, size_t size, const memory_placement& placement, const char* desc) {
+   if(placement.empty() || size == 0)
+      return;
+#ifdef __linux__
+   // both madvise and mbind require a page aligned start
+   const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+   const uintptr_t begin = reinterpret_cast<uintptr_t>(addr) & ~(page_size - 1);
+   const uintptr_t end   = reinterpret_cast<uintptr_t>(addr) + size;
+   void* const start = reinterpret_cast<void*>(begin);
+   const size_t len  = end - begin;
+
+   if(placement.huge_pages) {
+      if(madvise(start, len, MADV_HUGEPAGE))
+         wlog("Unable to enable transparent huge pages for ${d}: ${e}", ("d", desc)("e", strerror(errno)));
+      else
+         ilog("Enabled transparent huge pages for ${d} (${s} bytes)", ("d", desc)("s", len));
+   }
+
+   if(placement.numa_node) {
+      constexpr uint32_t max_node = sizeof(unsigned long) * 8;
+      if(*placement.numa_node >= max_node) {
+         wlog("Unable to bind ${d} to NUMA node ${n}: node must be less than ${m}", ("d", desc)("n", *placement.numa_node)("m", max_node));
+         return;
+      }
+      const unsigned long nodemask = 1ul << *placement.numa_node;
+      // MPOL_MF_MOVE so that pages already faulted in, e.g. the state copied in to memory in heap mode, are migrated too
+      if(syscall(SYS_mbind, start, len, MPOL_BIND, &nodemask, max_node, MPOL_MF_MOVE))
+         wlog("Unable to bind ${d} to NUMA node ${n}: ${e}", ("d", desc)("n", *placement.numa_node)("e", strerror(errno)));
+      else
+         ilog("Bound ${d} (${s} bytes) to NUMA node ${n}", ("d", desc)("s", len)("n", *placement.numa_node));
+   }
+#else
+   wlog("Memory placement hints are not supported on this platform, ignoring for ${d}", ("d", desc));
+#endif
+}
+
+} // namespace eosio::chain
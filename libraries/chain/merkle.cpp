@@ -49,4 +49,34 @@ digest_type merkle(deque<digest_type> ids) {
    return ids.front();
 }
 
+void merkle_accumulator::append( const digest_type& digest ) {
+   digest_type node = digest;
+   // like incrementing a binary counter, equal sized subtrees carry into one of the next level
+   for( uint64_t c = _count; c & 1; c >>= 1 ) {
+      node = digest_type::hash( make_canonical_pair( _subtrees.back(), node ) );
+      _subtrees.pop_back();
+   }
+   _subtrees.push_back( node );
+   ++_count;
+}
+
+digest_type merkle_accumulator::get_root() const {
+   if( 0 == _count ) { return digest_type(); }
+
+   // walk up the right edge of the tree, where merkle() pairs a node without a sibling with itself
+   auto subtree = _subtrees.rbegin();
+   std::optional<digest_type> partial; // right edge node of the level, over the leaves past the complete subtrees
+   for( uint32_t level = 0; ; ++level ) {
+      const uint64_t level_size = ((_count - 1) >> level) + 1;
+      const digest_type* complete = ((_count >> level) & 1) ? &*subtree++ : nullptr;
+      if( level_size == 1 )
+         return partial ? *partial : *complete;
+
+      if( partial )
+         partial = digest_type::hash( complete ? make_canonical_pair( *complete, *partial ) : make_canonical_pair( *partial, *partial ) );
+      else if( complete )
+         partial = digest_type::hash( make_canonical_pair( *complete, *complete ) );
+   }
+}
+
 } } // eosio::chain
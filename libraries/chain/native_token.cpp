@@ -0,0 +1,182 @@
+#include <eosio/chain/native_token.hpp>
+#include <eosio/chain/apply_context.hpp>
+#include <eosio/chain/exceptions.hpp>
+
+#include <cstring>
+
+namespace eosio { namespace chain { namespace native_token {
+
+namespace {
+
+   constexpr int64_t max_amount = (1LL << 62) - 1;
+
+   /// the layout the contract packs: int64 amount, uint64 symbol
+   struct asset_data {
+      int64_t  amount = 0;
+      uint64_t symbol = 0;
+
+      uint64_t code()const { return symbol >> 8; }
+   };
+   constexpr size_t packed_asset_size = 16;
+   constexpr size_t packed_currency_stats_size = 2 * packed_asset_size + sizeof(uint64_t); // supply, max_supply, issuer
+
+   /// eosio::check() of the contract
+   void check( bool pred, const char* msg ) {
+      if( !pred )
+         EOS_THROW( eosio_assert_message_exception, "assertion failure with message: ${s}", ("s", msg) );
+   }
+
+   /// eosio::symbol_code::is_valid() of the contract: upper case letters, left aligned, no gaps
+   bool is_valid_symbol_code( uint64_t sym ) {
+      for( int i = 0; i < 7; ++i ) {
+         char c = (char)(sym & 0xFF);
+         if( !('A' <= c && c <= 'Z') ) return false;
+         sym >>= 8;
+         if( !(sym & 0xFF) ) {
+            do {
+               sym >>= 8;
+               if( (sym & 0xFF) ) return false;
+               ++i;
+            } while( i < 7 );
+         }
+      }
+      return true;
+   }
+
+   bool is_valid( const asset_data& a ) {
+      return -max_amount <= a.amount && a.amount <= max_amount && is_valid_symbol_code( a.code() );
+   }
+
+   // wasm integer arithmetic wraps
+   int64_t wrapping_add( int64_t a, int64_t b ) { return static_cast<int64_t>( static_cast<uint64_t>(a) + static_cast<uint64_t>(b) ); }
+   int64_t wrapping_sub( int64_t a, int64_t b ) { return static_cast<int64_t>( static_cast<uint64_t>(a) - static_cast<uint64_t>(b) ); }
+
+   asset_data read_asset( const char* p ) {
+      asset_data a;
+      std::memcpy( &a.amount, p, sizeof(a.amount) );
+      std::memcpy( &a.symbol, p + sizeof(a.amount), sizeof(a.symbol) );
+      return a;
+   }
+
+   void write_asset( char* p, const asset_data& a ) {
+      std::memcpy( p, &a.amount, sizeof(a.amount) );
+      std::memcpy( p + sizeof(a.amount), &a.symbol, sizeof(a.symbol) );
+   }
+
+   struct transfer_args {
+      uint64_t   from = 0;
+      uint64_t   to = 0;
+      asset_data quantity;
+      uint32_t   memo_size = 0;
+   };
+
+   /// false where the contract's datastream would fail; trailing bytes are ignored by the contract as well
+   bool unpack_transfer( const bytes& data, transfer_args& args ) {
+      const char* pos = data.data();
+      const char* const end = pos + data.size();
+      if( end - pos < static_cast<std::ptrdiff_t>( 2 * sizeof(uint64_t) + packed_asset_size ) )
+         return false;
+      std::memcpy( &args.from, pos, sizeof(args.from) );
+      pos += sizeof(args.from);
+      std::memcpy( &args.to, pos, sizeof(args.to) );
+      pos += sizeof(args.to);
+      args.quantity = read_asset( pos );
+      pos += packed_asset_size;
+
+      // varuint32, same decoding as fc::unsigned_int
+      uint64_t v = 0; uint8_t b = 0; uint8_t by = 0;
+      do {
+         if( pos == end ) return false;
+         b = static_cast<uint8_t>( *pos++ );
+         v |= uint32_t( b & 0x7f ) << by;
+         by += 7;
+      } while( (b & 0x80) && by < 32 );
+      args.memo_size = static_cast<uint32_t>( v );
+      return static_cast<uint64_t>( end - pos ) >= args.memo_size;
+   }
+
+   /// iterator to the row and its asset, or false if the row is too short for the contract to deserialize
+   bool find_row( apply_context& context, name scope, name table, uint64_t id, size_t min_size, int& itr, asset_data& a ) {
+      itr = context.db_find_i64( context.get_receiver(), scope, table, id );
+      if( itr < 0 )
+         return true;
+      char buffer[packed_currency_stats_size];
+      const int size = context.db_get_i64( itr, buffer, sizeof(buffer) );
+      if( size < static_cast<int>( min_size ) )
+         return false;
+      a = read_asset( buffer );
+      return true;
+   }
+
+} /// anonymous namespace
+
+bool apply( apply_context& context ) {
+   const action& act = context.get_action();
+   if( act.account != context.get_receiver() || act.name != "transfer"_n )
+      return false;
+
+   transfer_args args;
+   if( !unpack_transfer( act.data, args ) )
+      return false;
+
+   const name from( args.from );
+   const name to( args.to );
+   const asset_data& quantity = args.quantity;
+   const uint64_t sym = quantity.code();
+
+   check( from != to, "cannot transfer to self" );
+   context.require_authorization( from );
+   check( context.is_account( to ), "to account does not exist" );
+
+   int stat_itr = -1;
+   asset_data supply;
+   if( !find_row( context, name( sym ), "stat"_n, sym, packed_currency_stats_size, stat_itr, supply ) )
+      return false;
+   check( stat_itr >= 0, "unable to find key" );
+
+   // the contract reads the balances after require_recipient, reading them first only changes iterator numbering
+   int from_itr = -1, to_itr = -1;
+   asset_data from_balance, to_balance;
+   if( !find_row( context, from, "accounts"_n, sym, packed_asset_size, from_itr, from_balance ) ||
+       !find_row( context, to, "accounts"_n, sym, packed_asset_size, to_itr, to_balance ) )
+      return false;
+
+   context.require_recipient( from );
+   context.require_recipient( to );
+
+   check( is_valid( quantity ), "invalid quantity" );
+   check( quantity.amount > 0, "must transfer positive quantity" );
+   check( quantity.symbol == supply.symbol, "symbol precision mismatch" );
+   check( args.memo_size <= 256, "memo has more than 256 bytes" );
+
+   const name payer = context.has_authorization( to ) ? to : from;
+
+   char buffer[packed_asset_size];
+
+   // sub_balance
+   check( from_itr >= 0, "no balance object found" );
+   check( from_balance.amount >= quantity.amount, "overdrawn balance" );
+   check( quantity.symbol == from_balance.symbol, "attempt to subtract asset with different symbol" );
+   from_balance.amount = wrapping_sub( from_balance.amount, quantity.amount );
+   check( -max_amount <= from_balance.amount, "subtraction underflow" );
+   check( from_balance.amount <= max_amount, "subtraction overflow" );
+   write_asset( buffer, from_balance );
+   context.db_update_i64( from_itr, from, buffer, sizeof(buffer) );
+
+   // add_balance
+   if( to_itr < 0 ) {
+      write_asset( buffer, quantity );
+      context.db_store_i64( to, "accounts"_n, payer, sym, buffer, sizeof(buffer) );
+   } else {
+      check( quantity.symbol == to_balance.symbol, "attempt to add asset with different symbol" );
+      to_balance.amount = wrapping_add( to_balance.amount, quantity.amount );
+      check( -max_amount <= to_balance.amount, "addition underflow" );
+      check( to_balance.amount <= max_amount, "addition overflow" );
+      write_asset( buffer, to_balance );
+      context.db_update_i64( to_itr, name(), buffer, sizeof(buffer) );
+   }
+
+   return true;
+}
+
+} } } /// namespace eosio::chain::native_token
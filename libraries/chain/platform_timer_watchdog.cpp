@@ -0,0 +1,182 @@
+#include <eosio/chain/platform_timer.hpp>
+#include <eosio/chain/platform_timer_accuracy.hpp>
+
+#include <fc/time.hpp>
+#include <fc/fwd_impl.hpp>
+#include <fc/exception/exception.hpp>
+#include <fc/log/logger_config.hpp> //set_thread_name()
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/prctl.h>
+
+namespace eosio { namespace chain {
+
+// A single watchdog thread is shared by all platform_timers (one per execution thread). Arming and disarming a timer
+// is a store to its deadline, a steady_clock time so clock steps do not move it. The watchdog sleeps on a condition
+// variable until the earliest armed deadline and fires the expiration callback on expiry. Arming only wakes the
+// watchdog when the new deadline is earlier than the one it sleeps until, so in the common case of back to back
+// transactions no syscall is made per transaction or per billing pause/resume.
+static constexpr int64_t disarmed = std::numeric_limits<int64_t>::max();
+static constexpr int64_t expiring = std::numeric_limits<int64_t>::min(); // watchdog running callback
+
+static std::mutex                   watchdog_lifecycle_mutex; // serializes starting and joining the watchdog thread
+static std::mutex                   watchdog_mutex;
+static std::condition_variable      watchdog_cv;
+static std::vector<platform_timer*> watchdog_timers; // guarded by watchdog_mutex
+static std::thread                  watchdog_thread;  // guarded by watchdog_lifecycle_mutex
+static bool                         watchdog_running = false; // guarded by watchdog_mutex
+// deadline the watchdog sleeps until, disarmed while it is scanning or has nothing armed
+static std::atomic<int64_t>         watchdog_wake_at = disarmed;
+
+static_assert(std::atomic<int64_t>::is_always_lock_free, "watchdog deadline must be lock-free");
+
+static int64_t steady_now() {
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct platform_timer::impl {
+   std::atomic<int64_t> deadline = disarmed; // steady_clock nanoseconds
+
+   // called on owning thread; replaces any deadline once the watchdog is not in the middle of expiring it
+   void set_deadline(int64_t value) {
+      int64_t d = deadline.load(std::memory_order_acquire);
+      for(;;) {
+         if(d == expiring) {
+            std::this_thread::yield();
+            d = deadline.load(std::memory_order_acquire);
+         } else if(deadline.compare_exchange_weak(d, value, std::memory_order_acq_rel)) {
+            return;
+         }
+      }
+   }
+
+   static void run() {
+      fc::set_thread_name("checktime");
+      // default timer slack of 50us would dominate short deadlines
+      prctl(PR_SET_TIMERSLACK, 1);
+
+      std::vector<platform_timer*> expired_timers;
+      std::unique_lock g(watchdog_mutex);
+      while(watchdog_running) {
+         // publish scanning before reading the deadlines, so an arm that is not seen by the scan notifies
+         watchdog_wake_at.store(disarmed);
+         const int64_t now = steady_now();
+         int64_t earliest = disarmed;
+         for(platform_timer* t : watchdog_timers) {
+            int64_t d = t->my->deadline.load();
+            if(d == disarmed || d == expiring)
+               continue;
+            // only expire the deadline that was observed; owner may have disarmed or re-armed in the meantime
+            if(d <= now) {
+               if(t->my->deadline.compare_exchange_strong(d, expiring, std::memory_order_acq_rel))
+                  expired_timers.push_back(t);
+               else if(d != disarmed && d != expiring)
+                  earliest = std::min(earliest, d);
+            } else {
+               earliest = std::min(earliest, d);
+            }
+         }
+
+         if(!expired_timers.empty()) {
+            // an expiring timer cannot be destroyed: its owner waits in set_deadline() until it is disarmed below
+            g.unlock();
+            for(platform_timer* t : expired_timers) {
+               t->expired = 1;
+               t->call_expiration_callback();
+               t->my->deadline.store(disarmed, std::memory_order_release);
+            }
+            expired_timers.clear();
+            g.lock();
+            continue;
+         }
+
+         watchdog_wake_at.store(earliest);
+         if(earliest == disarmed) {
+            watchdog_cv.wait(g);
+         } else {
+            watchdog_cv.wait_until(g, std::chrono::steady_clock::time_point(std::chrono::nanoseconds(earliest)));
+         }
+      }
+   }
+
+   // called on owning thread after arming `d`
+   static void wake_watchdog_before(int64_t d) {
+      if(d < watchdog_wake_at.load()) {
+         // taking the mutex orders the notify after the watchdog has started waiting
+         std::lock_guard g(watchdog_mutex);
+         watchdog_cv.notify_one();
+      }
+   }
+};
+
+platform_timer::platform_timer() {
+   static_assert(sizeof(impl) <= fwd_size);
+
+   {
+      std::lock_guard lifecycle(watchdog_lifecycle_mutex);
+      std::lock_guard g(watchdog_mutex);
+      watchdog_timers.push_back(this);
+      if(!watchdog_running) {
+         watchdog_running = true;
+         watchdog_thread = std::thread(&impl::run);
+      }
+   }
+
+   compute_and_print_timer_accuracy(*this);
+}
+
+platform_timer::~platform_timer() {
+   // unlike stop(), also waits for an expiration callback the watchdog is still running on this timer
+   my->set_deadline(disarmed);
+   // held until the watchdog thread is joined, so a timer constructed meanwhile cannot start a second thread
+   std::lock_guard lifecycle(watchdog_lifecycle_mutex);
+   bool join = false;
+   {
+      std::lock_guard g(watchdog_mutex);
+      watchdog_timers.erase(std::remove(watchdog_timers.begin(), watchdog_timers.end(), this), watchdog_timers.end());
+      if(watchdog_timers.empty()) {
+         watchdog_running = false;
+         watchdog_cv.notify_one();
+         join = true;
+      }
+   }
+   if(join)
+      watchdog_thread.join();
+}
+
+void platform_timer::start(fc::time_point tp) {
+   if(tp == fc::time_point::maximum()) {
+      my->set_deadline(disarmed);
+      expired = 0;
+      return;
+   }
+   // tp is a wall clock time; only the remaining duration is carried over to the steady clock
+   fc::microseconds x = tp.time_since_epoch() - fc::time_point::now().time_since_epoch();
+   if(x.count() <= 0) {
+      my->set_deadline(disarmed);
+      expired = 1;
+   } else {
+      const int64_t d = steady_now() + x.count() * 1000;
+      my->set_deadline(disarmed);
+      expired = 0;
+      // seq_cst store pairs with the watchdog publishing wake_at before it scans the deadlines
+      my->deadline.store(d);
+      impl::wake_watchdog_before(d);
+   }
+}
+
+void platform_timer::stop() {
+   if(expired)
+      return;
+   my->set_deadline(disarmed);
+   expired = 1;
+}
+
+}}
@@ -149,6 +149,7 @@ executor::executor(const code_cache_base& cc) {
    FC_ASSERT(code_mapping != MAP_FAILED, "failed to map code cache in to executor");
    code_mapping_size = s.st_size;
    mapping_is_executable = true;
+   apply_memory_placement(code_mapping, code_mapping_size, cc.get_config().placement, "EOS VM OC code cache");
 }
 
 void executor::execute(const code_descriptor& code, memory& mem, apply_context& context) {
@@ -10,7 +10,7 @@
 
 namespace eosio { namespace chain { namespace eosvmoc {
 
-memory::memory(uint64_t sliced_pages) {
+memory::memory(uint64_t sliced_pages, const memory_placement& placement) {
    uint64_t number_slices = sliced_pages + 1;
    uint64_t wasm_memory_size = sliced_pages * wasm_constraints::wasm_page_size;
    int fd = exec_sealed_memfd_create("eosvmoc_mem");
@@ -33,6 +33,14 @@ memory::memory(uint64_t sliced_pages) {
    }
 
    FC_ASSERT(last != nullptr, "expected last not nullptr");
+
+   //every slice maps the same memfd, so the last and largest mapping covers all of it. Only NUMA binding is applied:
+   // slices are not 2MB aligned relative to the memfd (stride is fixed by existing PIC) so huge pages can't back them
+   if(placement.numa_node) {
+      memory_placement numa_only = placement;
+      numa_only.huge_pages = false;
+      apply_memory_placement(last, memory_prologue_size+64u*1024u*(number_slices-1), numa_only, "EOS VM OC memory");
+   }
    zeropage_base = mapbase + memory_prologue_size;
    fullpage_base = last + memory_prologue_size;
 
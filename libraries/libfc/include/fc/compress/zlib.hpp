@@ -7,4 +7,7 @@ namespace fc
 
    std::string zlib_compress(const std::string& in);
 
+   /// gzip framed deflate, as used for HTTP `Content-Encoding: gzip`
+   std::string gzip_compress(const std::string& in);
+
 } // namespace fc
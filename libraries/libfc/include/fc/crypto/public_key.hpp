@@ -42,6 +42,15 @@ namespace fc { namespace crypto {
          explicit public_key(const std::string& base58str);
          std::string to_string(const fc::yield_function_t& yield) const;
 
+         /**
+          * Bound the number of K1/R1 public key string encodings remembered by to_string(). Keys such as producer
+          * keys are encoded over and over again in API responses; a hit skips the checksum and base58 encoding.
+          * The cache is direct mapped so a colliding key simply replaces the previous entry. It is disabled until this is
+          * called; nodeos sizes it from the chain_plugin option public-key-string-cache-size.
+          * @param max_entries maximum number of cached strings, 0 disables the cache
+          */
+         static void set_string_cache_size(size_t max_entries);
+
          storage_type _storage;
 
       private:
@@ -1,10 +1,14 @@
 #pragma once
 #include <fc/filesystem.hpp>
 #include <fc/io/datastream.hpp>
+#include <algorithm>
+#include <climits>
 #include <cstdio>
 #include <ios>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 #include <boost/interprocess/file_mapping.hpp>
 
@@ -150,6 +154,39 @@ public:
       }
    }
 
+   /// Gather write of count buffers at the current position with pwritev(), so discontiguous data such as a
+   /// chained_buffer is written without first being copied into the stdio buffer. Pending buffered writes are
+   /// flushed first and the position is advanced past the written data. As with write(), a file opened in
+   /// append mode is always written at its end.
+   void writev( const iovec* iov, size_t count ) {
+      flush();
+      size_t pos = tellp();
+      const int fd = fileno();
+      while( count > 0 ) {
+         const ssize_t r = ::pwritev( fd, iov, std::min<size_t>( count, IOV_MAX ), pos );
+         if( r < 0 ) {
+            if( errno == EINTR )
+               continue;
+            throw std::ios_base::failure( "cfile: " + _file_path.generic_string() +
+                                          " unable to writev at " + std::to_string( pos ) + ", error: " + std::to_string( errno ) );
+         }
+         pos += r;
+         size_t written = r;
+         for( ; count > 0 && written >= iov->iov_len; ++iov, --count )
+            written -= iov->iov_len;
+         if( written > 0 ) {
+            // short write ended inside a buffer, write the rest of it on its own
+            iovec rest{ static_cast<char*>( iov->iov_base ) + written, iov->iov_len - written };
+            seek( pos );
+            writev( &rest, 1 );
+            pos += rest.iov_len;
+            ++iov;
+            --count;
+         }
+      }
+      seek( pos );
+   }
+
    void flush() {
       if( 0 != fflush( _file.get() ) ) {
          int err = ferror( _file.get() );
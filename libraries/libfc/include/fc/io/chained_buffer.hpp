@@ -0,0 +1,198 @@
+#pragma once
+#include <boost/asio/buffer.hpp>
+#include <fc/io/datastream.hpp>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <sys/uio.h>
+
+namespace fc {
+  template <uint32_t buffer_len>
+  class cb_datastream;
+
+  /**
+   *  @brief append only buffer that spans a chain of physical buffers
+   *
+   *  Write side counterpart of message_buffer. Data is packed through cb_datastream without first computing the
+   *  packed size and without reallocating or copying as it grows. The first chunk holds min_chunk_len bytes and each
+   *  following chunk doubles in size up to max_chunk_len, so the memory held stays within about twice the data
+   *  size whether a small or a large object is packed. The result is consumed in place, either as a sequence of
+   *  boost const_buffers for async_write() or as an iovec array for writev().
+   */
+  template <uint32_t max_chunk_len>
+  class chained_buffer {
+  public:
+    static constexpr uint32_t min_chunk_len = std::min<uint32_t>(256, max_chunk_len);
+
+    chained_buffer() = default;
+    chained_buffer(const chained_buffer&) = delete;
+    chained_buffer& operator=(const chained_buffer&) = delete;
+
+    chained_buffer(chained_buffer&& other) noexcept
+    : chunks(std::move(other.chunks)), _size(other._size), _capacity(other._capacity) {
+      other.chunks.clear();
+      other._size = 0;
+      other._capacity = 0;
+    }
+
+    chained_buffer& operator=(chained_buffer&& other) noexcept {
+      if (this != &other) {
+        clear();
+        std::swap(chunks, other.chunks);
+        std::swap(_size, other._size);
+        std::swap(_capacity, other._capacity);
+      }
+      return *this;
+    }
+
+    /*
+     *  Returns the number of bytes written to the buffer chain.
+     */
+    size_t size() const { return _size; }
+
+    /*
+     *  Returns the number of bytes allocated by the buffer chain.
+     */
+    size_t capacity() const { return _capacity; }
+
+    bool empty() const { return _size == 0; }
+
+    /*
+     *  Frees all chunks.
+     */
+    void clear() {
+      chunks.clear();
+      _size = 0;
+      _capacity = 0;
+    }
+
+    /*
+     *  Appends size bytes to the end of the buffer chain, adding chunks as needed.
+     */
+    void write(const char* d, size_t size) {
+      while (size > 0) {
+        if (chunks.empty() || chunks.back().size == chunks.back().capacity)
+          add_chunk();
+        chunk& c = chunks.back();
+        const size_t n = std::min<size_t>(size, c.capacity - c.size);
+        memcpy(c.data.get() + c.size, d, n);
+        c.size += n;
+        d      += n;
+        size   -= n;
+        _size  += n;
+      }
+    }
+
+    /*
+     *  Overwrites size bytes previously written at position pos, e.g. to fill in a length prefix that is only
+     *  known once the payload following it has been packed.
+     */
+    void write_at(size_t pos, const char* d, size_t size) {
+      FC_ASSERT(pos + size <= _size, "write_at ${p} + ${s} past end of chained_buffer ${e}",
+                ("p", pos)("s", size)("e", _size));
+      for (auto& c : chunks) {
+        if (size == 0)
+          break;
+        if (pos >= c.size) {
+          pos -= c.size;
+          continue;
+        }
+        const size_t n = std::min<size_t>(size, c.size - pos);
+        memcpy(c.data.get() + pos, d, n);
+        d    += n;
+        size -= n;
+        pos   = 0;
+      }
+    }
+
+    /*
+     *  Calls f(const char* data, size_t size) for each physical buffer in order.
+     */
+    template <typename F>
+    void for_each_buffer(F&& f) const {
+      for (const auto& c : chunks)
+        f(c.data.get(), c.size);
+    }
+
+    /*
+     *  Creates and returns a vector of boost const_buffers that can be passed to boost async_write().
+     *  The buffer chain must outlive the write.
+     */
+    std::vector<boost::asio::const_buffer> get_buffer_sequence_for_boost_async_write() const {
+      std::vector<boost::asio::const_buffer> seq;
+      seq.reserve(chunks.size());
+      for_each_buffer([&](const char* d, size_t n) { seq.emplace_back(d, n); });
+      return seq;
+    }
+
+    /*
+     *  Creates and returns a vector of iovec that can be passed to writev(), e.g. through cfile::writev().
+     *  The buffer chain must outlive the write.
+     */
+    std::vector<iovec> get_iovec() const {
+      std::vector<iovec> seq;
+      seq.reserve(chunks.size());
+      for_each_buffer([&](const char* d, size_t n) { seq.push_back(iovec{const_cast<char*>(d), n}); });
+      return seq;
+    }
+
+    /*
+     *  Copies the buffer chain into one contiguous vector.
+     */
+    std::vector<char> to_vector() const {
+      std::vector<char> result;
+      result.reserve(_size);
+      for_each_buffer([&](const char* d, size_t n) { result.insert(result.end(), d, d + n); });
+      return result;
+    }
+
+    /*
+     *  Creates a cb_datastream object that can be used with the
+     *  fc library's pack functionality.
+     */
+    cb_datastream<max_chunk_len> create_datastream();
+
+  private:
+    struct chunk {
+      std::unique_ptr<char[]> data;
+      size_t                  capacity = 0;
+      size_t                  size = 0;
+    };
+
+    void add_chunk() {
+      const size_t len = chunks.empty() ? min_chunk_len : std::min<size_t>(chunks.back().capacity * 2, max_chunk_len);
+      chunks.push_back(chunk{std::unique_ptr<char[]>(new char[len]), len, 0});
+      _capacity += len;
+    }
+
+    std::vector<chunk> chunks;
+    size_t             _size = 0;
+    size_t             _capacity = 0;
+  };
+
+  /*
+   *  @brief datastream adapter that adapts chained_buffer for use with fc pack
+   *
+   *  This class supports pack functionality but not unpack.
+   */
+  template <uint32_t buffer_len>
+  class cb_datastream {
+     public:
+        explicit cb_datastream( chained_buffer<buffer_len>& c ) : cb(c) {}
+
+        inline bool write( const char* d, size_t s ) { cb.write(d, s); return true; }
+        inline bool put( char c ) { cb.write(&c, 1); return true; }
+
+        inline size_t tellp()const { return cb.size(); }
+
+     private:
+        chained_buffer<buffer_len>& cb;
+  };
+
+  template <uint32_t buffer_len>
+  inline cb_datastream<buffer_len> chained_buffer<buffer_len>::create_datastream() {
+    return cb_datastream<buffer_len>(*this);
+  }
+
+} // namespace fc
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <fc/time.hpp>
+#include <fc/variant.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace fc::tracing {
+
+   /**
+    * Span recorder for building a timeline of what every thread was doing, exported as Chrome trace-event JSON
+    * (chrome://tracing, ui.perfetto.dev).
+    *
+    * Each thread records completed spans into its own fixed size ring buffer, so recording takes no lock and does
+    * not allocate after the first span of a thread. When disabled a span costs one relaxed atomic load. Span names
+    * and categories must be string literals (or otherwise outlive the recorder), they are stored by pointer.
+    */
+
+   namespace detail {
+      extern std::atomic<uint32_t> spans_per_thread;
+   }
+
+   /// Enable recording, keeping the last `spans_per_thread` spans of every thread. 0 disables recording.
+   void set_spans_per_thread( uint32_t spans_per_thread );
+
+   inline bool spans_enabled() {
+      return detail::spans_per_thread.load( std::memory_order_relaxed ) != 0;
+   }
+
+   /// record a completed span on the calling thread, times in microseconds since epoch
+   void record_span( const char* name, const char* category, int64_t start_us, int64_t end_us, uint64_t arg = 0 );
+
+   /// Chrome trace-event object `{"traceEvents": [...]}` of the spans of all threads that ended within `window` of now
+   fc::variant get_spans( const fc::microseconds& window );
+
+   /// records a span covering its lifetime, `arg` is reported as args.n (block number, message type, ...)
+   class scoped_span {
+   public:
+      scoped_span( const char* name, const char* category, uint64_t arg = 0 )
+         : _name( spans_enabled() ? name : nullptr )
+         , _category( category )
+         , _arg( arg )
+         , _start( _name ? fc::time_point::now().time_since_epoch().count() : 0 ) {}
+
+      ~scoped_span() {
+         if( _name )
+            record_span( _name, _category, _start, fc::time_point::now().time_since_epoch().count(), _arg );
+      }
+
+      void set_arg( uint64_t arg ) { _arg = arg; }
+
+      scoped_span( const scoped_span& ) = delete;
+      scoped_span& operator=( const scoped_span& ) = delete;
+
+   private:
+      const char* _name;
+      const char* _category;
+      uint64_t    _arg;
+      int64_t     _start;
+   };
+
+} // namespace fc::tracing
+
+#define FC_TRACE_SPAN_CAT_(a, b) a##b
+#define FC_TRACE_SPAN_CAT(a, b) FC_TRACE_SPAN_CAT_(a, b)
+#define FC_TRACE_SPAN(...) ::fc::tracing::scoped_span FC_TRACE_SPAN_CAT(fc_trace_span_, __LINE__){ __VA_ARGS__ }
@@ -2,6 +2,7 @@
 
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
 
 namespace bio = boost::iostreams;
@@ -18,4 +19,15 @@ namespace fc
     bio::close(comp);
     return out;
   }
+
+  std::string gzip_compress(const std::string& in)
+  {
+    std::string out;
+    bio::filtering_ostream comp;
+    comp.push(bio::gzip_compressor(bio::gzip::default_compression));
+    comp.push(bio::back_inserter(out));
+    bio::write(comp, in.data(), in.size());
+    bio::close(comp);
+    return out;
+  }
 }
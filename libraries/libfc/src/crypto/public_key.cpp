@@ -1,6 +1,12 @@
 #include <fc/crypto/public_key.hpp>
 #include <fc/crypto/common.hpp>
 #include <fc/exception/exception.hpp>
+#include <fc/crypto/city.hpp>
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <optional>
 
 namespace fc { namespace crypto {
 
@@ -72,16 +78,98 @@ namespace fc { namespace crypto {
       return std::visit(is_valid_visitor(), _storage);
    }
 
+   namespace {
+      // split into independently locked shards so API threads encoding keys concurrently rarely contend
+      struct string_cache {
+         struct entry {
+            public_key::storage_type key;
+            std::string              str;
+         };
+
+         struct shard {
+            std::mutex                          mtx;
+            std::vector<std::optional<entry>>   entries;
+         };
+
+         static constexpr size_t num_shards = 16;
+
+         std::atomic<size_t>                 max_entries = 0; // read without a lock, 0 skips the cache entirely
+         std::array<shard, num_shards>       shards;
+
+         static string_cache& instance() {
+            static string_cache cache;
+            return cache;
+         }
+
+         bool enabled() const {
+            return max_entries.load(std::memory_order_relaxed) != 0;
+         }
+
+         // only the fixed size K1/R1 keys are cached, webauthn keys are rare and carry a variable length rpid
+         static std::optional<size_t> hash(const public_key::storage_type& key) {
+            return std::visit([&](const auto& k) -> std::optional<size_t> {
+               using key_type = std::decay_t<decltype(k)>;
+               if constexpr (std::is_same_v<key_type, webauthn::public_key>) {
+                  return {};
+               } else {
+                  const auto& data = k.serialize();
+                  return city_hash_size_t(data.data, sizeof(data.data)) ^ key.index();
+               }
+            }, key);
+         }
+
+         std::optional<std::string> find(const public_key::storage_type& key, size_t h) {
+            auto& s = shards[h % num_shards];
+            std::lock_guard g(s.mtx);
+            if (s.entries.empty())
+               return {};
+            const auto& e = s.entries[h / num_shards % s.entries.size()];
+            if (e && eq_comparator<public_key::storage_type>::apply(e->key, key))
+               return e->str;
+            return {};
+         }
+
+         void insert(const public_key::storage_type& key, size_t h, const std::string& str) {
+            auto& s = shards[h % num_shards];
+            std::lock_guard g(s.mtx);
+            if (!s.entries.empty())
+               s.entries[h / num_shards % s.entries.size()].emplace(entry{key, str});
+         }
+
+         void resize(size_t n) {
+            max_entries.store(n, std::memory_order_relaxed);
+            const size_t per_shard = (n + num_shards - 1) / num_shards;
+            for (auto& s : shards) {
+               std::lock_guard g(s.mtx);
+               s.entries.clear();
+               s.entries.resize(per_shard);
+               s.entries.shrink_to_fit();
+            }
+         }
+      };
+   }
+
+   void public_key::set_string_cache_size(size_t max_entries) {
+      string_cache::instance().resize(max_entries);
+   }
+
    std::string public_key::to_string(const fc::yield_function_t& yield) const
    {
+      auto& cache = string_cache::instance();
+      const auto h = cache.enabled() ? string_cache::hash(_storage) : std::optional<size_t>{};
+      if (h) {
+         if (auto cached = cache.find(_storage, *h))
+            return std::move(*cached);
+      }
+
       auto data_str = std::visit(base58str_visitor<storage_type, config::public_key_prefix, 0>(yield), _storage);
 
       auto which = _storage.index();
-      if (which == 0) {
-         return std::string(config::public_key_legacy_prefix) + data_str;
-      } else {
-         return std::string(config::public_key_base_prefix) + "_" + data_str;
-      }
+      std::string result = which == 0 ? std::string(config::public_key_legacy_prefix) + data_str
+                                      : std::string(config::public_key_base_prefix) + "_" + data_str;
+      if (h)
+         cache.insert(_storage, *h, result);
+      return result;
    }
 
    std::ostream& operator<<(std::ostream& s, const public_key& k) {
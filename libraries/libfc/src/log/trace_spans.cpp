@@ -0,0 +1,161 @@
+#include <fc/log/trace_spans.hpp>
+#include <fc/log/logger_config.hpp> // get_thread_name()
+#include <fc/variant_object.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace fc::tracing {
+
+   namespace detail {
+      std::atomic<uint32_t> spans_per_thread{0};
+   }
+
+   namespace {
+
+      // Slots are written only by the owning thread, which bumps `begin` before and `head` after writing a slot. A
+      // reader may see a slot being overwritten; it re-reads `begin` after copying and drops any slot the writer has
+      // started on since. Slot fields are relaxed atomics so that race is benign rather than undefined.
+      struct span_slot {
+         std::atomic<const char*> name{nullptr};
+         std::atomic<const char*> category{nullptr};
+         std::atomic<int64_t>     start{0};
+         std::atomic<int64_t>     end{0};
+         std::atomic<uint64_t>    arg{0};
+      };
+
+      struct thread_buffer {
+         thread_buffer( uint32_t capacity, uint32_t tid, std::string thread_name )
+            : slots( capacity ), tid( tid ), thread_name( std::move( thread_name ) ) {}
+
+         std::vector<span_slot> slots;
+         std::atomic<uint64_t>  begin{0}; // number of spans ever started to be written
+         std::atomic<uint64_t>  head{0};  // number of spans ever recorded
+         const uint32_t         tid;
+         const std::string      thread_name;
+      };
+      using thread_buffer_ptr = std::shared_ptr<thread_buffer>;
+
+      struct registry {
+         std::mutex                     mtx;
+         std::vector<thread_buffer_ptr> buffers;
+         uint32_t                       next_tid = 1;
+
+         static registry& get() {
+            static registry r;
+            return r;
+         }
+
+         thread_buffer_ptr add( uint32_t capacity, const thread_buffer_ptr& replacing ) {
+            std::lock_guard g( mtx );
+            auto b = std::make_shared<thread_buffer>( capacity, replacing ? replacing->tid : next_tid++, get_thread_name() );
+            if( replacing )
+               std::replace( buffers.begin(), buffers.end(), replacing, b );
+            else
+               buffers.push_back( b );
+            return b;
+         }
+
+         void remove( const thread_buffer_ptr& b ) {
+            std::lock_guard g( mtx );
+            buffers.erase( std::remove( buffers.begin(), buffers.end(), b ), buffers.end() );
+         }
+
+         std::vector<thread_buffer_ptr> snapshot() {
+            std::lock_guard g( mtx );
+            return buffers;
+         }
+      };
+
+      // unregisters the buffer of a thread when the thread exits
+      struct thread_buffer_holder {
+         thread_buffer_ptr buffer;
+         ~thread_buffer_holder() {
+            if( buffer )
+               registry::get().remove( buffer );
+         }
+      };
+
+      thread_local thread_buffer_holder this_thread_buffer;
+
+   } // anonymous namespace
+
+   void set_spans_per_thread( uint32_t spans_per_thread ) {
+      detail::spans_per_thread.store( spans_per_thread, std::memory_order_relaxed );
+   }
+
+   void record_span( const char* name, const char* category, int64_t start_us, int64_t end_us, uint64_t arg ) {
+      const uint32_t capacity = detail::spans_per_thread.load( std::memory_order_relaxed );
+      if( capacity == 0 )
+         return;
+      auto& buffer = this_thread_buffer.buffer;
+      if( !buffer || buffer->slots.size() != capacity )
+         buffer = registry::get().add( capacity, buffer );
+
+      const uint64_t h = buffer->head.load( std::memory_order_relaxed );
+      buffer->begin.store( h + 1, std::memory_order_relaxed );
+      std::atomic_thread_fence( std::memory_order_release );
+      auto& slot = buffer->slots[h % capacity];
+      slot.name.store( name, std::memory_order_relaxed );
+      slot.category.store( category, std::memory_order_relaxed );
+      slot.start.store( start_us, std::memory_order_relaxed );
+      slot.end.store( end_us, std::memory_order_relaxed );
+      slot.arg.store( arg, std::memory_order_relaxed );
+      buffer->head.store( h + 1, std::memory_order_release );
+   }
+
+   fc::variant get_spans( const fc::microseconds& window ) {
+      const int64_t since = ( fc::time_point::now() - window ).time_since_epoch().count();
+
+      fc::variants events;
+      for( const auto& buffer : registry::get().snapshot() ) {
+         const uint64_t capacity = buffer->slots.size();
+         const uint64_t head     = buffer->head.load( std::memory_order_acquire );
+         const uint64_t first    = head > capacity ? head - capacity : 0;
+
+         struct span { const char* name; const char* category; int64_t start; int64_t end; uint64_t arg; };
+         std::vector<span> spans;
+         spans.reserve( head - first );
+         for( uint64_t i = first; i < head; ++i ) {
+            const auto& slot = buffer->slots[i % capacity];
+            spans.push_back( {slot.name.load( std::memory_order_relaxed ), slot.category.load( std::memory_order_relaxed ),
+                              slot.start.load( std::memory_order_relaxed ), slot.end.load( std::memory_order_relaxed ),
+                              slot.arg.load( std::memory_order_relaxed )} );
+         }
+         // the owning thread kept recording while copying; slots it may have reached since are not trustworthy
+         std::atomic_thread_fence( std::memory_order_acquire );
+         const uint64_t begin_after = buffer->begin.load( std::memory_order_relaxed );
+         const uint64_t valid_from  = begin_after > capacity ? begin_after - capacity : 0;
+
+         bool any = false;
+         for( uint64_t i = std::max( first, valid_from ); i < head; ++i ) {
+            const auto& s = spans[i - first];
+            if( s.end < since )
+               continue;
+            any = true;
+            events.emplace_back( fc::mutable_variant_object()
+                                    ( "name", s.name )
+                                    ( "cat", s.category )
+                                    ( "ph", "X" )
+                                    ( "ts", s.start )
+                                    ( "dur", s.end - s.start )
+                                    ( "pid", 1 )
+                                    ( "tid", buffer->tid )
+                                    ( "args", fc::mutable_variant_object()( "n", s.arg ) ) );
+         }
+         if( any ) {
+            events.emplace_back( fc::mutable_variant_object()
+                                    ( "name", "thread_name" )
+                                    ( "ph", "M" )
+                                    ( "pid", 1 )
+                                    ( "tid", buffer->tid )
+                                    ( "args", fc::mutable_variant_object()( "name", buffer->thread_name ) ) );
+         }
+      }
+
+      return fc::mutable_variant_object()( "traceEvents", std::move( events ) )( "displayTimeUnit", "ms" );
+   }
+
+} // namespace fc::tracing
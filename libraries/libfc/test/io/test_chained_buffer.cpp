@@ -0,0 +1,153 @@
+#include <fc/io/cfile.hpp>
+#include <fc/io/chained_buffer.hpp>
+#include <fc/io/raw.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstring>
+
+BOOST_AUTO_TEST_SUITE(chained_buffer_tests)
+
+constexpr uint32_t def_buffer_size = 16;
+
+/// Test writes that fill, span and exactly end on buffer boundaries
+BOOST_AUTO_TEST_CASE(chained_buffer_write)
+{
+  try {
+    fc::chained_buffer<def_buffer_size> cb;
+    BOOST_CHECK(cb.empty());
+    BOOST_CHECK(cb.get_buffer_sequence_for_boost_async_write().empty());
+
+    std::vector<char> expected;
+    for (size_t len : {1u, 15u, 16u, 3u, 40u, 13u}) {
+      std::vector<char> data(len);
+      for (size_t i = 0; i < len; ++i)
+        data[i] = static_cast<char>(expected.size() + i);
+      cb.write(data.data(), data.size());
+      expected.insert(expected.end(), data.begin(), data.end());
+      BOOST_CHECK_EQUAL(cb.size(), expected.size());
+      BOOST_CHECK(cb.to_vector() == expected);
+    }
+
+    auto seq = cb.get_buffer_sequence_for_boost_async_write();
+    BOOST_CHECK_EQUAL(seq.size(), (expected.size() + def_buffer_size - 1) / def_buffer_size);
+    BOOST_CHECK_EQUAL(boost::asio::buffer_size(seq), expected.size());
+    for (size_t i = 0; i + 1 < seq.size(); ++i)
+      BOOST_CHECK_EQUAL(seq[i].size(), def_buffer_size);
+
+    BOOST_CHECK_EQUAL(cb.capacity(), seq.size() * def_buffer_size);
+
+    fc::chained_buffer<def_buffer_size> moved(std::move(cb));
+    BOOST_CHECK(cb.empty());
+    BOOST_CHECK(moved.to_vector() == expected);
+  }
+  FC_LOG_AND_RETHROW()
+}
+
+/// Test chunks grow geometrically so small and large contents both hold memory proportional to their size
+BOOST_AUTO_TEST_CASE(chained_buffer_growth)
+{
+  try {
+    constexpr uint32_t max_chunk_len = 64*1024;
+    using buffer_type = fc::chained_buffer<max_chunk_len>;
+
+    buffer_type small;
+    const std::vector<char> data(200, 'x');
+    small.write(data.data(), data.size());
+    BOOST_CHECK_EQUAL(small.capacity(), buffer_type::min_chunk_len);
+
+    buffer_type large;
+    const std::vector<char> block(1024*1024 + 17, 'y');
+    for (size_t pos = 0; pos < block.size(); pos += 1000)
+      large.write(block.data() + pos, std::min<size_t>(1000, block.size() - pos));
+    BOOST_CHECK(large.to_vector() == block);
+    BOOST_CHECK_GE(large.capacity(), large.size());
+    BOOST_CHECK_LE(large.capacity(), large.size() + max_chunk_len);
+
+    auto seq = large.get_buffer_sequence_for_boost_async_write();
+    BOOST_CHECK_EQUAL(seq.front().size(), buffer_type::min_chunk_len);
+    for (size_t i = 1; i + 1 < seq.size(); ++i)
+      BOOST_CHECK_EQUAL(seq[i].size(), std::min<size_t>(seq[i-1].size() * 2, max_chunk_len));
+
+    // back patch spanning the first two chunks
+    const char patch[4] = {'a', 'b', 'c', 'd'};
+    large.write_at(buffer_type::min_chunk_len - 2, patch, sizeof(patch));
+    auto result = large.to_vector();
+    BOOST_CHECK(std::equal(patch, patch + sizeof(patch), result.begin() + buffer_type::min_chunk_len - 2));
+
+    large.clear();
+    BOOST_CHECK(large.empty());
+    BOOST_CHECK_EQUAL(large.capacity(), 0u);
+  }
+  FC_LOG_AND_RETHROW()
+}
+
+/// Test packing through cb_datastream matches fc::raw::pack, including a back patched size prefix
+BOOST_AUTO_TEST_CASE(chained_buffer_pack)
+{
+  try {
+    const std::vector<std::string> value = {"a", std::string(100, 'b'), "", std::string(17, 'c')};
+
+    fc::chained_buffer<def_buffer_size> cb;
+    auto ds = cb.create_datastream();
+    const uint32_t placeholder = 0;
+    ds.write(reinterpret_cast<const char*>(&placeholder), sizeof(placeholder));
+    fc::raw::pack(ds, value);
+    const uint32_t payload_size = cb.size() - sizeof(payload_size);
+    cb.write_at(0, reinterpret_cast<const char*>(&payload_size), sizeof(payload_size));
+
+    auto packed = fc::raw::pack(value);
+    BOOST_REQUIRE_EQUAL(payload_size, packed.size());
+    auto result = cb.to_vector();
+    BOOST_CHECK(std::equal(packed.begin(), packed.end(), result.begin() + sizeof(payload_size)));
+
+    fc::datastream<const char*> in(result.data(), result.size());
+    uint32_t size = 0;
+    std::vector<std::string> unpacked;
+    fc::raw::unpack(in, size);
+    fc::raw::unpack(in, unpacked);
+    BOOST_CHECK_EQUAL(size, payload_size);
+    BOOST_CHECK(unpacked == value);
+
+    BOOST_CHECK_THROW(cb.write_at(cb.size() - 1, reinterpret_cast<const char*>(&payload_size), sizeof(payload_size)),
+                      fc::assert_exception);
+  }
+  FC_LOG_AND_RETHROW()
+}
+
+/// Test the buffer chain written with cfile::writev lands between buffered writes, at the right position
+BOOST_AUTO_TEST_CASE(chained_buffer_writev)
+{
+  try {
+    fc::chained_buffer<def_buffer_size> cb;
+    std::vector<char> data(100);
+    for (size_t i = 0; i < data.size(); ++i)
+      data[i] = static_cast<char>(i);
+    cb.write(data.data(), data.size());
+
+    fc::temp_cfile tmp("w+b");
+    auto& f = tmp.file();
+    f.write("head", 4);
+    auto iov = cb.get_iovec();
+    BOOST_CHECK_EQUAL(iov.size(), (data.size() + def_buffer_size - 1) / def_buffer_size);
+    uint64_t trailer = 0x0102030405060708;
+    iov.push_back(iovec{&trailer, sizeof(trailer)});
+    f.writev(iov.data(), iov.size());
+    BOOST_CHECK_EQUAL(f.tellp(), 4 + data.size() + sizeof(trailer));
+    f.write("tail", 4);
+    f.flush();
+
+    std::vector<char> result(4 + data.size() + sizeof(trailer) + 4);
+    f.seek(0);
+    f.read(result.data(), result.size());
+    BOOST_CHECK(std::equal(result.begin(), result.begin() + 4, "head"));
+    BOOST_CHECK(std::equal(data.begin(), data.end(), result.begin() + 4));
+    uint64_t read_trailer = 0;
+    memcpy(&read_trailer, result.data() + 4 + data.size(), sizeof(read_trailer));
+    BOOST_CHECK_EQUAL(read_trailer, trailer);
+    BOOST_CHECK(std::equal(result.end() - 4, result.end(), "tail"));
+  }
+  FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
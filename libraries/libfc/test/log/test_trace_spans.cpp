@@ -0,0 +1,84 @@
+#include <fc/log/trace_spans.hpp>
+#include <fc/log/logger_config.hpp>
+#include <fc/variant_object.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <thread>
+
+using namespace fc;
+
+namespace {
+   size_t count_spans( const fc::variant& trace, const std::string& name ) {
+      size_t n = 0;
+      for( const auto& e : trace["traceEvents"].get_array() )
+         if( e["ph"].as_string() == "X" && e["name"].as_string() == name )
+            ++n;
+      return n;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE(trace_spans_test_suite)
+
+BOOST_AUTO_TEST_CASE(disabled_records_nothing) {
+   tracing::set_spans_per_thread( 0 );
+   { FC_TRACE_SPAN( "disabled", "test" ); }
+   BOOST_TEST( count_spans( tracing::get_spans( fc::seconds( 60 ) ), "disabled" ) == 0u );
+}
+
+BOOST_AUTO_TEST_CASE(ring_keeps_last_spans) {
+   tracing::set_spans_per_thread( 16 );
+   for( uint64_t i = 0; i < 40; ++i ) {
+      FC_TRACE_SPAN( "ring", "test", i );
+   }
+   auto trace = tracing::get_spans( fc::seconds( 60 ) );
+   BOOST_TEST( count_spans( trace, "ring" ) == 16u );
+
+   uint64_t min_arg = UINT64_MAX;
+   for( const auto& e : trace["traceEvents"].get_array() ) {
+      if( e["name"].as_string() == "ring" ) {
+         min_arg = std::min( min_arg, e["args"]["n"].as_uint64() );
+         BOOST_TEST( e["dur"].as_int64() >= 0 );
+      }
+   }
+   BOOST_TEST( min_arg == 24u );
+   tracing::set_spans_per_thread( 0 );
+}
+
+BOOST_AUTO_TEST_CASE(spans_of_all_threads) {
+   tracing::set_spans_per_thread( 64 );
+   std::thread t( []() {
+      fc::set_thread_name( "span-thread" );
+      FC_TRACE_SPAN( "other_thread", "test" );
+   } );
+   t.join();
+   { FC_TRACE_SPAN( "this_thread", "test" ); }
+
+   // buffers of exited threads are dropped
+   auto trace = tracing::get_spans( fc::seconds( 60 ) );
+   BOOST_TEST( count_spans( trace, "this_thread" ) == 1u );
+   BOOST_TEST( count_spans( trace, "other_thread" ) == 0u );
+
+   std::atomic_bool done = false;
+   std::atomic_bool recorded = false;
+   std::thread live( [&]() {
+      fc::set_thread_name( "span-thread" );
+      { FC_TRACE_SPAN( "other_thread", "test" ); }
+      recorded = true;
+      while( !done ) std::this_thread::yield();
+   } );
+   while( !recorded ) std::this_thread::yield();
+   trace = tracing::get_spans( fc::seconds( 60 ) );
+   done = true;
+   live.join();
+
+   BOOST_TEST( count_spans( trace, "other_thread" ) == 1u );
+   bool named = false;
+   for( const auto& e : trace["traceEvents"].get_array() )
+      if( e["ph"].as_string() == "M" && e["args"]["name"].as_string() == "span-thread" )
+         named = true;
+   BOOST_TEST( named );
+   tracing::set_spans_per_thread( 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,92 @@
+#include <boost/test/unit_test.hpp>
+
+#include <fc/crypto/base58.hpp>
+#include <fc/crypto/hex.hpp>
+#include <fc/crypto/public_key.hpp>
+#include <fc/crypto/private_key.hpp>
+#include <fc/exception/exception.hpp>
+
+using namespace fc;
+using namespace std::literals;
+
+BOOST_AUTO_TEST_SUITE(base58)
+
+static const std::vector<std::pair<std::string, std::string>> vectors = {
+   { ""s, ""s },
+   { "61"s, "2g"s },
+   { "626262"s, "a3gV"s },
+   { "636363"s, "aPEr"s },
+   { "73696d706c792061206c6f6e6720737472696e67"s, "2cFupjhnEsSn59qHXstmK2ffpLv2"s },
+   { "00eb15231dfceb60925886b67d065299925915aeb172c06647"s, "1NS17iag9jJgTHD1VXjvLCEnZuQ3rJDE9L"s },
+   { "516b6fcd0f"s, "ABnLTmg"s },
+   { "bf4f89001e670274dd"s, "3SEo3LWLoPntC"s },
+   { "572e4794"s, "3EFU7m"s },
+   { "ecac89cad93923c02321"s, "EJDM8drfXA6uyA"s },
+   { "10c8511e"s, "Rt5zm"s },
+   { "00000000000000000000"s, "1111111111"s },
+};
+
+BOOST_AUTO_TEST_CASE(base58enc) try {
+   for (const auto& [hex, expected] : vectors) {
+      std::vector<char> data(hex.size() / 2);
+      from_hex(hex, data.data(), data.size());
+      BOOST_CHECK_EQUAL(expected, to_base58(data, {}));
+   }
+} FC_LOG_AND_RETHROW();
+
+BOOST_AUTO_TEST_CASE(base58dec) try {
+   for (const auto& [expected, b58] : vectors) {
+      auto data = from_base58(b58);
+      BOOST_CHECK_EQUAL(expected, to_hex(data.data(), data.size()));
+   }
+   // surrounding whitespace is ignored
+   auto data = from_base58(" \t2cFupjhnEsSn59qHXstmK2ffpLv2 \n"s);
+   BOOST_CHECK_EQUAL("simply a long string"s, std::string(data.begin(), data.end()));
+} FC_LOG_AND_RETHROW();
+
+BOOST_AUTO_TEST_CASE(base58dec_invalid) try {
+   BOOST_CHECK_THROW(from_base58("3SEo3LW0oPntC"s), parse_error_exception);  // '0' not in alphabet
+   BOOST_CHECK_THROW(from_base58("3SEo3LW oPntC"s), parse_error_exception);  // embedded whitespace
+   BOOST_CHECK_THROW(from_base58("3SEo3LWLoPntC!"s), parse_error_exception);
+
+   char out[4];
+   BOOST_CHECK_THROW(from_base58("ABnLTmg"s, out, sizeof(out)), assert_exception);
+} FC_LOG_AND_RETHROW();
+
+BOOST_AUTO_TEST_CASE(base58roundtrip) try {
+   for (size_t len = 0; len < 100; ++len) {
+      std::vector<char> data(len);
+      for (size_t i = 0; i < len; ++i)
+         data[i] = static_cast<char>(i < len / 3 ? 0 : (i * 131 + len * 7) & 0xff);
+      BOOST_CHECK(data == from_base58(to_base58(data, {})));
+   }
+} FC_LOG_AND_RETHROW();
+
+BOOST_AUTO_TEST_CASE(public_key_string_cache) try {
+   const auto k1 = "EOS6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV"s;
+   const auto r1 = crypto::private_key::generate<crypto::r1::private_key_shim>().get_public_key();
+   const auto r1_str = r1.to_string({});
+
+   crypto::public_key::set_string_cache_size(16);
+   for (int i = 0; i < 3; ++i) {
+      BOOST_CHECK_EQUAL(k1, crypto::public_key(k1).to_string({}));
+      BOOST_CHECK_EQUAL(r1_str, r1.to_string({}));
+   }
+
+   // more keys than entries, colliding entries are replaced
+   std::vector<std::pair<crypto::public_key, std::string>> keys;
+   crypto::public_key::set_string_cache_size(0);
+   for (int i = 0; i < 64; ++i) {
+      auto pub = crypto::private_key::generate().get_public_key();
+      keys.emplace_back(pub, pub.to_string({}));
+   }
+   crypto::public_key::set_string_cache_size(16);
+   for (int i = 0; i < 2; ++i) {
+      for (const auto& [pub, str] : keys)
+         BOOST_CHECK_EQUAL(str, pub.to_string({}));
+   }
+   crypto::public_key::set_string_cache_size(0);
+   BOOST_CHECK_EQUAL(k1, crypto::public_key(k1).to_string({}));
+} FC_LOG_AND_RETHROW();
+
+BOOST_AUTO_TEST_SUITE_END()
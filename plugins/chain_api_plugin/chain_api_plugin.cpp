@@ -176,9 +176,10 @@ void chain_api_plugin::plugin_startup() {
    });
 
    if (chain.transaction_finality_status_enabled()) {
-      _http_plugin.add_api({
+      // only reads the finality status storage under its shared lock, does not need the main thread
+      _http_plugin.add_async_api({
          CHAIN_RO_CALL_WITH_400(get_transaction_status, 200, http_params_types::params_required),
-      }, appbase::exec_queue::read_only);
+      });
    }
 
 }
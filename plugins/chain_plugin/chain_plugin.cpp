@@ -13,6 +13,7 @@
 #include <eosio/chain/snapshot.hpp>
 #include <eosio/chain/subjective_billing.hpp>
 #include <eosio/chain/deep_mind.hpp>
+#include <eosio/chain/deep_mind_writer.hpp>
 #include <eosio/chain_plugin/trx_finality_status_processing.hpp>
 #include <eosio/chain/permission_link_object.hpp>
 #include <eosio/chain/global_property_object.hpp>
@@ -290,6 +291,9 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
          )
          ("profile-account", boost::program_options::value<vector<string>>()->composing(),
           "The name of an account whose code will be profiled")
+         ("native-token-code-hash", boost::program_options::value<vector<string>>()->composing(),
+          "Code hash of a build of the reference eosio.token contract. Its transfer action is applied natively instead of in the wasm runtime, "
+          "with identical state changes and traces. Only list hashes of builds verified against the native implementation.")
          ("abi-serializer-max-time-ms", bpo::value<uint32_t>()->default_value(config::default_abi_serializer_max_time_us / 1000),
           "Override default maximum ABI serialization time allowed in ms")
          ("chain-state-db-size-mb", bpo::value<uint64_t>()->default_value(config::default_state_size / (1024  * 1024)), "Maximum size (in MiB) of the chain state database")
@@ -302,6 +306,11 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
           "print contract's output to console")
          ("deep-mind", bpo::bool_switch()->default_value(false),
           "print deeper information about chain operations")
+         ("deep-mind-binary-output", bpo::value<std::string>(),
+          "Write deep mind as length prefixed binary records from a background thread instead of DMLOG text lines. "
+          "File or fifo path, '-' for stdout, or 'unix:<path>' to connect to a listening unix socket.")
+         ("deep-mind-binary-queue-size", bpo::value<uint32_t>()->default_value(4096),
+          "Maximum number of deep mind records queued for the binary output writer before block processing waits on it")
          ("actor-whitelist", boost::program_options::value<vector<string>>()->composing()->multitoken(),
           "Account added to actor whitelist (may specify multiple times)")
          ("actor-blacklist", boost::program_options::value<vector<string>>()->composing()->multitoken(),
@@ -347,6 +356,10 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
           "In \"locked\" mode database is preloaded, locked in to memory, and will use huge pages if available.\n"
 #endif
          )
+         ("memory-huge-pages", bpo::bool_switch()->default_value(false),
+          "Request transparent huge pages for the chain state database in \"heap\" or \"locked\" database-map-mode and for the EOS VM OC code cache mapping")
+         ("memory-numa-node", bpo::value<uint32_t>(),
+          "Bind the chain state database in \"heap\" or \"locked\" database-map-mode, EOS VM OC memory and the EOS VM OC code cache to this NUMA node")
 
 #ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
          ("eos-vm-oc-cache-size-mb", bpo::value<uint64_t>()->default_value(eosvmoc::config().cache_size / (1024u*1024u)), "Maximum size (in MiB) of the EOS VM OC code cache")
@@ -363,6 +376,8 @@ void chain_plugin::set_program_options(options_description& cli, options_descrip
           "'none' - EOS VM OC tier-up is completely disabled.\n")
 #endif
          ("enable-account-queries", bpo::value<bool>()->default_value(false), "enable queries to find accounts by various metadata.")
+         ("public-key-string-cache-size", bpo::value<uint32_t>()->default_value(4096),
+          "Number of public key string representations to cache for API responses. Set to 0 to disable.")
          ("transaction-retry-max-storage-size-gb", bpo::value<uint64_t>(),
           "Maximum size (in GiB) allowed to be allocated for the Transaction Retry feature. Setting above 0 enables this feature.")
          ("transaction-retry-interval-sec", bpo::value<uint32_t>()->default_value(20),
@@ -599,8 +614,15 @@ void chain_plugin_impl::plugin_initialize(const variables_map& options) {
 
       LOAD_VALUE_SET( options, "profile-account", chain_config->profile_accounts );
 
+      if( options.count( "native-token-code-hash" )) {
+         for( const auto& h : options.at( "native-token-code-hash" ).as<vector<string>>() )
+            chain_config->native_token_code_hashes.emplace( digest_type( h ) );
+      }
+
       abi_serializer_max_time_us = fc::microseconds(options.at("abi-serializer-max-time-ms").as<uint32_t>() * 1000);
 
+      fc::crypto::public_key::set_string_cache_size(options.at("public-key-string-cache-size").as<uint32_t>());
+
       chain_config->blocks_dir = blocks_dir;
       chain_config->state_dir = state_dir;
       chain_config->read_only = readonly;
@@ -921,6 +943,11 @@ void chain_plugin_impl::plugin_initialize(const variables_map& options) {
 
       chain_config->db_map_mode = options.at("database-map-mode").as<pinnable_mapped_file::map_mode>();
 
+      chain_config->state_placement.huge_pages = options.at("memory-huge-pages").as<bool>();
+      if( options.count("memory-numa-node") )
+         chain_config->state_placement.numa_node = options.at("memory-numa-node").as<uint32_t>();
+      chain_config->eosvmoc_config.placement = chain_config->state_placement;
+
 #ifdef EOSIO_EOS_VM_OC_RUNTIME_ENABLED
       if( options.count("eos-vm-oc-cache-size-mb") )
          chain_config->eosvmoc_config.cache_size = options.at( "eos-vm-oc-cache-size-mb" ).as<uint64_t>() * 1024u * 1024u;
@@ -989,6 +1016,11 @@ void chain_plugin_impl::plugin_initialize(const variables_map& options) {
          EOS_ASSERT( options.at("p2p-accept-transactions").as<bool>() == false, plugin_config_exception,
             "p2p-accept-transactions must be set to false in order to enable deep-mind logging.");
 
+         if( options.count( "deep-mind-binary-output" ) ) {
+            _deep_mind_log.update_writer( std::make_shared<deep_mind_writer>( options.at( "deep-mind-binary-output" ).as<std::string>(),
+                                                                              options.at( "deep-mind-binary-queue-size" ).as<uint32_t>() ) );
+         }
+
          chain->enable_deep_mind( &_deep_mind_log );
       }
 
@@ -1148,6 +1180,8 @@ void chain_plugin_impl::plugin_shutdown() {
    applied_transaction_connection.reset();
    block_start_connection.reset();
    chain.reset();
+   // writes out any queued deep mind records
+   _deep_mind_log.update_writer( nullptr );
 }
 
 void chain_plugin::plugin_shutdown() {
@@ -2206,9 +2240,18 @@ void api_base::send_transaction_gen(API &api, send_transaction_params_t params,
                              [ptrx, next](const next_function_variant<std::unique_ptr<fc::variant>>& result ) {
                                 if( std::holds_alternative<fc::exception_ptr>( result ) ) {
                                    next( std::get<fc::exception_ptr>( result ) );
-                                } else {
+                                } else if( std::holds_alternative<std::unique_ptr<fc::variant>>( result ) ) {
                                    fc::variant& output = *std::get<std::unique_ptr<fc::variant>>( result );
                                    next( Result{ptrx->id(), std::move( output )} );
+                                } else {
+                                   // trace variant is created on the http thread pool
+                                   using return_type = t_or_exception<Result>;
+                                   next([ptrx, trace_fn = std::get<std::function<t_or_exception<std::unique_ptr<fc::variant>>()>>( result )]() {
+                                      auto output = trace_fn();
+                                      if( std::holds_alternative<fc::exception_ptr>( output ) )
+                                         return return_type( std::get<fc::exception_ptr>( output ) );
+                                      return return_type( Result{ptrx->id(), std::move( *std::get<std::unique_ptr<fc::variant>>( output ) )} );
+                                   });
                                 }
                              } );
                         retried = true;
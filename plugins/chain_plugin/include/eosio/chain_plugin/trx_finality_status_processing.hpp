@@ -11,6 +11,10 @@ namespace eosio::chain_apis {
    using trx_finality_status_processing_impl_ptr = std::unique_ptr<trx_finality_status_processing_impl>;
    /**
     * This class manages the processing related to the transaction finality status feature.
+    *
+    * The signal_* calls only queue a compact copy of the signal; the tracked transactions are maintained on a
+    * dedicated thread. The get_* calls may be made from any thread and never wait for that thread to catch up, so
+    * they may not yet reflect the most recent signals.
     */
    class trx_finality_status_processing {
    public:
@@ -53,6 +57,9 @@ namespace eosio::chain_apis {
 
       size_t get_storage_memory_size() const;
 
+      /// block until every signal queued before the call has been processed
+      void wait_for_processed() const;
+
    private:
       trx_finality_status_processing_impl_ptr _my;
    };
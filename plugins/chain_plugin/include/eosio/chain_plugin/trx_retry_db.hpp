@@ -44,7 +44,8 @@ public:
    /**
     * @param ptrx trx to retry if not see in a block for retry_interval
     * @param num_blocks ack seen in a block after num_blocks have been accepted, LIB if optional !has_value()
-    * @param next report result to user by calling next
+    * @param next report result to user by calling next, the trace variant is reported as a function to be run on
+    *             the http thread pool as converting the trace with its abis is deferred until then
     * @throws throw tx_resource_exhaustion if trx would exceeds max_mem_usage_size
     */
    void track_transaction( chain::packed_transaction_ptr ptrx, std::optional<uint16_t> num_blocks, eosio::chain::next_function<std::unique_ptr<fc::variant>> next );
@@ -190,6 +190,7 @@ BOOST_AUTO_TEST_CASE(trx_finality_status_logic) { try {
    add(trx_pairs_20, no_bs);
    add(trx_pairs_20, no_bs);
 
+   status.wait_for_processed();
    auto cs = status.get_chain_state();
    BOOST_CHECK(cs.head_id == eosio::chain::block_id_type{});
    BOOST_TEST(!std::get<0>(trx_pairs_20[0])->producer_block_id.has_value());
@@ -257,6 +258,7 @@ BOOST_AUTO_TEST_CASE(trx_finality_status_logic) { try {
    status.signal_accepted_block(bs_20->block, bs_20->id);
 
 
+   status.wait_for_processed();
    cs = status.get_chain_state();
    BOOST_CHECK(cs.head_id == bs_20->id);
    BOOST_CHECK(cs.head_id == *std::get<0>(trx_pairs_20[0])->producer_block_id);
@@ -323,6 +325,7 @@ BOOST_AUTO_TEST_CASE(trx_finality_status_logic) { try {
    add(trx_pairs_21, bs_21);
    status.signal_accepted_block(bs_21->block, bs_21->id);
 
+   status.wait_for_processed();
    cs = status.get_chain_state();
    BOOST_CHECK(cs.head_id == bs_21->id);
    BOOST_CHECK(cs.head_id == *std::get<0>(trx_pairs_21[0])->producer_block_id);
@@ -392,6 +395,7 @@ BOOST_AUTO_TEST_CASE(trx_finality_status_logic) { try {
    add(trx_pairs_22, bs_22);
    status.signal_accepted_block(bs_22->block, bs_22->id);
 
+   status.wait_for_processed();
    cs = status.get_chain_state();
    BOOST_CHECK(cs.head_id == bs_22->id);
    BOOST_CHECK(cs.head_id == *std::get<0>(trx_pairs_22[0])->producer_block_id);
@@ -470,6 +474,7 @@ BOOST_AUTO_TEST_CASE(trx_finality_status_logic) { try {
    add(trx_pairs_22_alt, bs_22_alt);
    status.signal_accepted_block(bs_22_alt->block, bs_22_alt->id);
 
+   status.wait_for_processed();
    cs = status.get_chain_state();
    BOOST_CHECK(cs.head_id == bs_22_alt->id);
    BOOST_CHECK(cs.head_id == *std::get<0>(trx_pairs_22_alt[0])->producer_block_id);
@@ -555,6 +560,7 @@ BOOST_AUTO_TEST_CASE(trx_finality_status_logic) { try {
    add(trx_pairs_19, bs_19);
    status.signal_accepted_block(bs_19->block, bs_19->id);
 
+   status.wait_for_processed();
    cs = status.get_chain_state();
    BOOST_CHECK(cs.head_id == bs_19->id);
    BOOST_CHECK(cs.head_id == *std::get<0>(trx_pairs_19[0])->producer_block_id);
@@ -663,6 +669,7 @@ BOOST_AUTO_TEST_CASE(trx_finality_status_logic) { try {
 
    status.signal_accepted_block(bs_19_alt->block, bs_19_alt->id);
 
+   status.wait_for_processed();
    cs = status.get_chain_state();
    BOOST_CHECK(cs.head_id == bs_19_alt->id);
    BOOST_CHECK(cs.head_id == *std::get<0>(trx_pairs_19[0])->producer_block_id);
@@ -752,6 +759,7 @@ BOOST_AUTO_TEST_CASE(trx_finality_status_logic) { try {
    // irreversible
    status.signal_irreversible_block(bs_19_alt->block, bs_19_alt->id);
 
+   status.wait_for_processed();
    cs = status.get_chain_state();
    BOOST_CHECK(cs.head_id == bs_19_alt->id);
    BOOST_CHECK(cs.irr_id == bs_19_alt->id);
@@ -899,6 +907,7 @@ namespace {
          }
 
          status.signal_accepted_block(bs->block, bs->id);
+         status.wait_for_processed();
       }
 
       void send_spec_block() {
@@ -911,6 +920,7 @@ namespace {
 
             status.signal_applied_transaction(trace, txn);
          }
+         status.wait_for_processed();
       }
 
    private:
@@ -131,6 +131,16 @@ uint64_t get_id( const transaction& trx ) {
    return t.id;
 }
 
+// trace variant is reported as a function to be run on the http thread pool
+bool has_trace_variant( const next_function_variant<std::unique_ptr<fc::variant>>& result ) {
+   using trace_variant_fn = std::function<t_or_exception<std::unique_ptr<fc::variant>>()>;
+   if( !std::holds_alternative<trace_variant_fn>(result) ) return false;
+   auto output = std::get<trace_variant_fn>(result)();
+   if( !std::holds_alternative<std::unique_ptr<fc::variant>>(output) ) return false;
+   const auto& v = std::get<std::unique_ptr<fc::variant>>(output);
+   return v && v->is_object() && v->get_object().contains("id");
+}
+
 uint64_t get_id( const packed_transaction_ptr& ptr ) {
    return get_id( ptr->get_transaction() );
 }
@@ -361,8 +371,7 @@ BOOST_AUTO_TEST_CASE(trx_retry_logic) {
       auto trx_5 = make_unique_trx(chain->get_chain_id(), fc::seconds(30), 5);
       bool trx_5_variant = false;
       trx_retry.track_transaction( trx_5, lib, [&trx_5_variant](const next_function_variant<std::unique_ptr<fc::variant>>& result){
-         BOOST_REQUIRE( std::holds_alternative<std::unique_ptr<fc::variant>>(result) );
-         BOOST_CHECK( !!std::get<std::unique_ptr<fc::variant>>(result) );
+         BOOST_CHECK( has_trace_variant(result) );
          trx_5_variant = true;
       } );
       // increase time by 1 seconds, so trx_6 retry interval diff than 5
@@ -371,8 +380,7 @@ BOOST_AUTO_TEST_CASE(trx_retry_logic) {
       auto trx_6 = make_unique_trx(chain->get_chain_id(), fc::seconds(30), 6);
       bool trx_6_variant = false;
       trx_retry.track_transaction( trx_6, std::optional<uint32_t>(2), [&trx_6_variant](const next_function_variant<std::unique_ptr<fc::variant>>& result){
-         BOOST_REQUIRE( std::holds_alternative<std::unique_ptr<fc::variant>>(result) );
-         BOOST_CHECK( !!std::get<std::unique_ptr<fc::variant>>(result) );
+         BOOST_CHECK( has_trace_variant(result) );
          trx_6_variant = true;
       } );
       // not in block 7, so not returned to user
@@ -430,8 +438,7 @@ BOOST_AUTO_TEST_CASE(trx_retry_logic) {
       auto trx_7 = make_unique_trx(chain->get_chain_id(), fc::seconds(30), 7);
       bool trx_7_variant = false;
       trx_retry.track_transaction( trx_7, lib, [&trx_7_variant](const next_function_variant<std::unique_ptr<fc::variant>>& result){
-         BOOST_REQUIRE( std::holds_alternative<std::unique_ptr<fc::variant>>(result) );
-         BOOST_CHECK( !!std::get<std::unique_ptr<fc::variant>>(result) );
+         BOOST_CHECK( has_trace_variant(result) );
          trx_7_variant = true;
       } );
       // increase time by 1 seconds, so trx_8 retry interval diff than 7
@@ -440,8 +447,7 @@ BOOST_AUTO_TEST_CASE(trx_retry_logic) {
       auto trx_8 = make_unique_trx(chain->get_chain_id(), fc::seconds(30), 8);
       bool trx_8_variant = false;
       trx_retry.track_transaction( trx_8, std::optional<uint32_t>(3), [&trx_8_variant](const next_function_variant<std::unique_ptr<fc::variant>>& result){
-         BOOST_REQUIRE( std::holds_alternative<std::unique_ptr<fc::variant>>(result) );
-         BOOST_CHECK( !!std::get<std::unique_ptr<fc::variant>>(result) );
+         BOOST_CHECK( has_trace_variant(result) );
          trx_8_variant = true;
       } );
       // one to expire, will be forked out never to return
@@ -589,15 +595,13 @@ BOOST_AUTO_TEST_CASE(trx_retry_logic) {
       auto trx_10 = make_unique_trx(chain->get_chain_id(), fc::seconds(30), 10);
       bool trx_10_variant = false;
       trx_retry.track_transaction( trx_10, std::optional<uint32_t>(0), [&trx_10_variant](const next_function_variant<std::unique_ptr<fc::variant>>& result){
-         BOOST_REQUIRE( std::holds_alternative<std::unique_ptr<fc::variant>>(result) );
-         BOOST_CHECK( !!std::get<std::unique_ptr<fc::variant>>(result) );
+         BOOST_CHECK( has_trace_variant(result) );
          trx_10_variant = true;
       } );
       auto trx_11 = make_unique_trx(chain->get_chain_id(), fc::seconds(30), 11);
       bool trx_11_variant = false;
       trx_retry.track_transaction( trx_11, std::optional<uint32_t>(1), [&trx_11_variant](const next_function_variant<std::unique_ptr<fc::variant>>& result){
-         BOOST_REQUIRE( std::holds_alternative<std::unique_ptr<fc::variant>>(result) );
-         BOOST_CHECK( !!std::get<std::unique_ptr<fc::variant>>(result) );
+         BOOST_CHECK( has_trace_variant(result) );
          trx_11_variant = true;
       } );
       // seen in block immediately
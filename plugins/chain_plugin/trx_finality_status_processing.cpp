@@ -1,21 +1,95 @@
 #include <eosio/chain_plugin/trx_finality_status_processing.hpp>
 #include <eosio/chain_plugin/finality_status_object.hpp>
 
+#include <fc/log/logger_config.hpp> //set_thread_name()
+
+#include <condition_variable>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <utility>
+#include <variant>
 
 using namespace eosio;
 using namespace eosio::finality_status;
 
 namespace eosio::chain_apis {
 
+   // compact copies of the controller signals, queued on the main thread and processed on the status thread
+   struct applied_trx_event {
+      chain::transaction_id_type          trx_id;
+      fc::time_point                      trx_expiry;
+      std::optional<chain::block_id_type> block_id;
+      chain::block_timestamp_type         block_time;
+      bool                                track = false; // executed incoming trx, otherwise only the block is of interest
+   };
+   struct accepted_block_event {
+      chain::block_id_type        id;
+      chain::block_timestamp_type timestamp;
+   };
+   struct irreversible_block_event {
+      chain::block_id_type        id;
+      chain::block_timestamp_type timestamp;
+   };
+   struct block_start_event {};
+
+   struct queued_event {
+      fc::time_point now; // time of the signal, so processing is not affected by queueing delay
+      std::variant<applied_trx_event, accepted_block_event, irreversible_block_event, block_start_event> event;
+   };
+
    struct trx_finality_status_processing_impl {
       trx_finality_status_processing_impl( uint64_t max_storage, const fc::microseconds& success_duration, const fc::microseconds& failure_duration )
       : _max_storage(max_storage),
         _success_duration(success_duration),
-        _failure_duration(failure_duration) {}
+        _failure_duration(failure_duration),
+        _thread( [this]() { run(); } ) {}
+
+      ~trx_finality_status_processing_impl() {
+         {
+            std::lock_guard g( _queue_mtx );
+            _done = true;
+         }
+         _queue_cv.notify_one();
+         _thread.join();
+      }
+
+      // block events are bounded by the block rate, so only transaction events are dropped when the status thread
+      // falls behind; a dropped transaction reports UNKNOWN
+      void push( queued_event&& e ) {
+         {
+            std::lock_guard g( _queue_mtx );
+            if (_queue.size() >= max_queued_events && std::holds_alternative<applied_trx_event>( e.event )) {
+               ++_dropped_count;
+               ++_queued_count;
+               return;
+            }
+            _queue.emplace_back( std::move( e ) );
+            ++_queued_count;
+         }
+         _queue_cv.notify_one();
+      }
+
+      // readers never wait on the queue, they see the state as of the last processed batch
+      std::shared_lock<std::shared_mutex> read_lock() const {
+         return std::shared_lock( _storage_mtx );
+      }
+
+      void wait_for_processed() const {
+         std::unique_lock g( _queue_mtx );
+         const uint64_t queued = _queued_count;
+         _processed_cv.wait( g, [&]() { return _processed_count >= queued; } );
+      }
+
+      void run();
 
-      void signal_applied_transaction( const chain::transaction_trace_ptr& trace, const chain::packed_transaction_ptr& ptrx );
+      void process( const fc::time_point& now, const applied_trx_event& e );
 
-      void signal_accepted_block( const chain::signed_block_ptr& block, const chain::block_id_type& id );
+      void process( const fc::time_point& now, const accepted_block_event& e );
+
+      void process( const fc::time_point& now, const irreversible_block_event& e );
+
+      void process( const fc::time_point& now, const block_start_event& e );
 
       void handle_rollback();
 
@@ -27,6 +101,8 @@ namespace eosio::chain_apis {
 
       void determine_earliest_tracked_block_id();
 
+      static constexpr size_t max_queued_events = 100'000;
+
       const uint64_t                                   _max_storage;
       fc::tracked_storage<finality_status_multi_index> _storage;
       uint32_t                                         _last_proc_block_num = finality_status::no_block_num;
@@ -38,6 +114,18 @@ namespace eosio::chain_apis {
       const fc::microseconds                           _success_duration;
       const fc::microseconds                           _failure_duration;
       std::deque<chain::transaction_id_type>           _speculative_trxs;
+
+      // everything above is only modified on _thread while holding _storage_mtx exclusively
+      mutable std::shared_mutex                        _storage_mtx;
+      mutable std::mutex                               _queue_mtx;
+      std::condition_variable                          _queue_cv;
+      mutable std::condition_variable                  _processed_cv;
+      std::vector<queued_event>                        _queue;              // guarded by _queue_mtx
+      uint64_t                                         _queued_count = 0;   // guarded by _queue_mtx
+      uint64_t                                         _processed_count = 0;// guarded by _queue_mtx
+      uint64_t                                         _dropped_count = 0;  // guarded by _queue_mtx
+      bool                                             _done = false;       // guarded by _queue_mtx
+      std::thread                                      _thread;
    };
 
    trx_finality_status_processing::trx_finality_status_processing( uint64_t max_storage, const fc::microseconds& success_duration, const fc::microseconds& failure_duration )
@@ -49,42 +137,91 @@ namespace eosio::chain_apis {
 
    void trx_finality_status_processing::signal_irreversible_block( const chain::signed_block_ptr& block, const chain::block_id_type& id ) {
       try {
-         _my->_irr_block_id = id;
-         _my->_irr_block_timestamp = block->timestamp;
+         _my->push( {fc::time_point::now(), irreversible_block_event{id, block->timestamp}} );
       } FC_LOG_AND_DROP(("Failed to signal irreversible block for finality status"));
    }
 
    void trx_finality_status_processing::signal_block_start( uint32_t block_num ) {
       try {
-         // since a new block is started, no block state was received, so the speculative block did not get eventually produced
-         _my->_speculative_trxs.clear();
+         _my->push( {fc::time_point::now(), block_start_event{}} );
       } FC_LOG_AND_DROP(("Failed to signal block start for finality status"));
    }
 
    void trx_finality_status_processing::signal_applied_transaction( const chain::transaction_trace_ptr& trace, const chain::packed_transaction_ptr& ptrx ) {
       try {
-         _my->signal_applied_transaction(trace, ptrx);
+         const bool track = trace->receipt && trace->receipt->status == chain::transaction_receipt_header::executed &&
+                            !trace->scheduled && !chain::is_onblock(*trace);
+         // speculative trxs not tracked have nothing to report
+         if (!track && !trace->producer_block_id)
+            return;
+         _my->push( {fc::time_point::now(),
+                     applied_trx_event{.trx_id = trace->id,
+                                       .trx_expiry = track ? ptrx->expiration().to_time_point() : fc::time_point{},
+                                       .block_id = trace->producer_block_id,
+                                       .block_time = trace->block_time,
+                                       .track = track}} );
       } FC_LOG_AND_DROP(("Failed to signal applied transaction for finality status"));
    }
 
    void trx_finality_status_processing::signal_accepted_block( const chain::signed_block_ptr& block, const chain::block_id_type& id ) {
       try {
-         _my->signal_accepted_block(block, id);
+         _my->push( {fc::time_point::now(), accepted_block_event{id, block->timestamp}} );
       } FC_LOG_AND_DROP(("Failed to signal accepted block for finality status"));
    }
 
-   void trx_finality_status_processing_impl::signal_applied_transaction( const chain::transaction_trace_ptr& trace, const chain::packed_transaction_ptr& ptrx ) {
-      const fc::time_point now = fc::time_point::now();
+   void trx_finality_status_processing_impl::run() {
+      fc::set_thread_name( "trx-finality" );
+      std::vector<queued_event> batch;
+      std::unique_lock g( _queue_mtx );
+      for (;;) {
+         _queue_cv.wait( g, [this]() { return !_queue.empty() || _done; } );
+         if (_queue.empty())
+            break; // _done and drained
+         std::swap( batch, _queue );
+         const uint64_t dropped = std::exchange( _dropped_count, 0 );
+         g.unlock();
+
+         if (dropped > 0)
+            wlog( "Transaction finality status queue full, status of ${n} transactions not tracked", ("n", dropped) );
+
+         {
+            std::unique_lock w( _storage_mtx );
+            for (const auto& e : batch) {
+               try {
+                  std::visit( [&]( const auto& ev ) { process( e.now, ev ); }, e.event );
+               } FC_LOG_AND_DROP(("Failed to process signal for finality status"));
+            }
+         }
+         const auto processed = batch.size() + dropped;
+         batch.clear();
+
+         g.lock();
+         _processed_count += processed;
+         _processed_cv.notify_all();
+      }
+   }
+
+   void trx_finality_status_processing_impl::process( const fc::time_point& now, const irreversible_block_event& e ) {
+      _irr_block_id = e.id;
+      _irr_block_timestamp = e.timestamp;
+   }
+
+   void trx_finality_status_processing_impl::process( const fc::time_point& now, const block_start_event& e ) {
+      // since a new block is started, no block state was received, so the speculative block did not get eventually produced
+      _speculative_trxs.clear();
+   }
+
+   void trx_finality_status_processing_impl::process( const fc::time_point& now, const applied_trx_event& e ) {
       // use the head block num if we are in a block, otherwise don't provide block number for speculative blocks
       chain::block_id_type block_id;
       chain::block_timestamp_type block_timestamp;
       bool modified = false;
-      if (trace->producer_block_id) {
-         block_id = *trace->producer_block_id;
+      if (e.block_id) {
+         block_id = *e.block_id;
          const bool block_changed = block_id != _head_block_id;
          if (block_changed) {
             _head_block_id = block_id;
-            _head_block_timestamp = trace->block_time;
+            _head_block_timestamp = e.block_time;
          }
          block_timestamp = _head_block_timestamp;
 
@@ -101,22 +238,17 @@ namespace eosio::chain_apis {
          }
       }
 
-      if (!trace->receipt) return;
-      if (trace->receipt->status != chain::transaction_receipt_header::executed) {
-         return;
-      }
-      if (trace->scheduled) return;
-      if (chain::is_onblock(*trace)) return;
+      if (!e.track) return;
 
-      if (!trace->producer_block_id) {
-         _speculative_trxs.push_back(trace->id);
+      if (!e.block_id) {
+         _speculative_trxs.push_back(e.trx_id);
       }
 
       if(ensure_storage()) {
          modified = true;
       }
 
-      const auto& trx_id = trace->id;
+      const auto& trx_id = e.trx_id;
       auto iter = _storage.find(trx_id);
       if (iter != _storage.index().cend()) {
          _storage.modify( iter, [&block_id,&block_timestamp]( finality_status_object& obj ) {
@@ -128,7 +260,7 @@ namespace eosio::chain_apis {
       else {
          _storage.insert(
             finality_status_object{.trx_id = trx_id,
-                                   .trx_expiry = ptrx->expiration().to_time_point(),
+                                   .trx_expiry = e.trx_expiry,
                                    .received = now,
                                    .block_id = block_id,
                                    .block_timestamp = block_timestamp});
@@ -139,21 +271,20 @@ namespace eosio::chain_apis {
       }
    }
 
-   void trx_finality_status_processing_impl::signal_accepted_block( const chain::signed_block_ptr& block, const chain::block_id_type& id ) {
+   void trx_finality_status_processing_impl::process( const fc::time_point& now, const accepted_block_event& e ) {
       // if this block had any transactions, then we have processed everything we need to already
-      if (id == _head_block_id) {
+      if (e.id == _head_block_id) {
          return;
       }
 
-      _head_block_id = id;
-      _head_block_timestamp = block->timestamp;
+      _head_block_id = e.id;
+      _head_block_timestamp = e.timestamp;
 
       const auto head_block_num = chain::block_header::num_from_id(_head_block_id);
       if (head_block_num <= _last_proc_block_num) {
          handle_rollback();
       }
 
-      const fc::time_point now = fc::time_point::now();
       bool status_expiry = status_expiry_of_trxs(now);
       if (status_expiry) {
          determine_earliest_tracked_block_id();
@@ -304,10 +435,12 @@ namespace eosio::chain_apis {
    }
 
    trx_finality_status_processing::chain_state trx_finality_status_processing::get_chain_state() const {
+      auto g = _my->read_lock();
       return { .head_id = _my->_head_block_id, .head_block_timestamp = _my->_head_block_timestamp, .irr_id = _my->_irr_block_id, .irr_block_timestamp = _my->_irr_block_timestamp, .earliest_tracked_block_id = _my->_earliest_tracked_block_id };
    }
 
    std::optional<trx_finality_status_processing::trx_state> trx_finality_status_processing::get_trx_state( const chain::transaction_id_type& id ) const {
+      auto g = _my->read_lock();
       auto iter = _my->_storage.find(id);
       if (iter == _my->_storage.index().cend()) {
          return {};
@@ -331,9 +464,14 @@ namespace eosio::chain_apis {
    }
 
    size_t trx_finality_status_processing::get_storage_memory_size() const {
+      auto g = _my->read_lock();
       return _my->_storage.memory_size();
    }
 
+   void trx_finality_status_processing::wait_for_processed() const {
+      _my->wait_for_processed();
+   }
+
    void trx_finality_status_processing_impl::determine_earliest_tracked_block_id() {
       const auto& indx = _storage.index().get<by_status_expiry>();
 
@@ -2,6 +2,7 @@
 #include <eosio/chain_plugin/chain_plugin.hpp>
 
 #include <eosio/chain/types.hpp>
+#include <eosio/chain/account_object.hpp>
 #include <eosio/chain/contract_types.hpp>
 #include <eosio/chain/controller.hpp>
 
@@ -26,11 +27,17 @@ namespace {
 
 constexpr uint16_t lib_totem = std::numeric_limits<uint16_t>::max();
 
+using pinned_abi_ptr = std::shared_ptr<const std::vector<char>>;
+// raw abi of each account in a trace as of when the trace was applied, null if the account has no abi
+using pinned_abis_t = std::vector<std::pair<account_name, pinned_abi_ptr>>;
+
 struct tracked_transaction {
    const packed_transaction_ptr                              ptrx;
    const uint16_t                                            num_blocks = 0; // lib is lib_totem
    uint32_t                                                  block_num = 0;
-   fc::variant                                               trx_trace_v;
+   transaction_trace_ptr                                     trx_trace;
+   pinned_abis_t                                             trx_trace_abis;
+   size_t                                                    trx_trace_size = 0;
    fc::time_point                                            last_try;
    next_function<std::unique_ptr<fc::variant>>               next;
 
@@ -52,9 +59,62 @@ struct tracked_transaction {
       return block_num != 0;
    }
 
-   size_t memory_size()const { return ptrx->get_estimated_size() + trx_trace_v.estimated_size() + sizeof(*this); }
+   // pinned abis are shared between traces and counted once by trx_retry_db_impl
+   size_t memory_size()const {
+      return ptrx->get_estimated_size() + trx_trace_size + trx_trace_abis.capacity() * sizeof(pinned_abis_t::value_type) + sizeof(*this);
+   }
+
+   void clear_trace() {
+      trx_trace.reset();
+      trx_trace_abis.clear();
+      trx_trace_size = 0;
+   }
 };
 
+// in-memory size of a trace; its packed size leaves out the fixed size members and container overhead
+size_t estimated_trace_size( const transaction_trace& trace ) {
+   size_t size = sizeof(trace) + trace.action_traces.capacity() * sizeof(action_trace);
+   for( const auto& at : trace.action_traces ) {
+      size += at.act.data.capacity() +
+              at.act.authorization.capacity() * sizeof(permission_level) +
+              at.console.capacity() +
+              at.return_value.capacity() +
+              at.account_ram_deltas.capacity() * sizeof(account_delta);
+      if( at.receipt )
+         size += at.receipt->auth_sequence.capacity() * sizeof(std::pair<account_name, uint64_t>);
+   }
+   if( trace.failed_dtrx_trace )
+      size += estimated_trace_size( *trace.failed_dtrx_trace );
+   return size;
+}
+
+using trace_variant_fn = std::function<t_or_exception<std::unique_ptr<fc::variant>>()>;
+
+// send_transaction trace output format, to be run on the http thread pool
+trace_variant_fn make_trace_variant_fn( transaction_trace_ptr trace, pinned_abis_t abis, fc::microseconds abi_max_time ) {
+   return [trace=std::move(trace), abis=std::move(abis), abi_max_time]() -> t_or_exception<std::unique_ptr<fc::variant>> {
+      using return_type = t_or_exception<std::unique_ptr<fc::variant>>;
+      try {
+         auto resolver = abi_resolver( abi_serializer_cache_builder( [&abis, abi_max_time]( const account_name& name ) -> std::optional<abi_serializer> {
+            auto itr = std::find_if( abis.begin(), abis.end(), [&name]( const auto& a ) { return a.first == name; } );
+            if( itr != abis.end() && itr->second ) {
+               if( abi_def abi; abi_serializer::to_abi( *itr->second, abi ) ) {
+                  return abi_serializer( std::move( abi ), abi_serializer::create_yield_function( abi_max_time ) );
+               }
+            }
+            return {};
+         } ).add_serializers( trace ).get() );
+         auto output = std::make_unique<fc::variant>();
+         try {
+            abi_serializer::to_variant( *trace, *output, resolver, abi_max_time );
+         } catch( chain::abi_exception& ) {
+            *output = *trace;
+         }
+         return return_type( std::move( output ) );
+      } CATCH_AND_RETURN(return_type);
+   };
+}
+
 struct by_trx_id;
 struct by_expiry;
 struct by_ready_block_num;
@@ -105,9 +165,13 @@ struct trx_retry_db_impl {
       return _tracked_trxs.index().size();
    }
 
+   size_t memory_size()const {
+      return _tracked_trxs.memory_size() + _pinned_abis_size;
+   }
+
    void track_transaction( packed_transaction_ptr ptrx, std::optional<uint16_t> num_blocks, next_function<std::unique_ptr<fc::variant>> next ) {
-      EOS_ASSERT( _tracked_trxs.memory_size() < _max_mem_usage_size, tx_resource_exhaustion,
-                  "Transaction exceeded  transaction-retry-max-storage-size-gb limit: ${m} bytes", ("m", _tracked_trxs.memory_size()) );
+      EOS_ASSERT( memory_size() < _max_mem_usage_size, tx_resource_exhaustion,
+                  "Transaction exceeded  transaction-retry-max-storage-size-gb limit: ${m} bytes", ("m", memory_size()) );
       auto i = _tracked_trxs.index().get<by_trx_id>().find( ptrx->id() );
       if( i == _tracked_trxs.index().end() ) {
          _tracked_trxs.insert( {std::move(ptrx),
@@ -139,24 +203,23 @@ struct trx_retry_db_impl {
       auto& idx = _tracked_trxs.index().get<by_trx_id>();
       auto itr = idx.find(trace->id);
       if( itr != idx.end() ) {
-         _tracked_trxs.modify( itr, [&trace, &control=_controller, &abi_max_time=_abi_serializer_max_time]( tracked_transaction& tt ) {
+         // The abi could change in the very next transaction, so pin the raw abis the trace needs now and leave the
+         // abi parsing and variant conversion to the http thread pool when the user is replied to.
+         pinned_abis_t abis = pin_abis( *trace );
+         const size_t trace_size = estimated_trace_size( *trace );
+         _tracked_trxs.modify( itr, [&]( tracked_transaction& tt ) {
             tt.block_num = trace->block_num;
-            try {
-               // send_transaction trace output format.
-               // Convert to variant with abi here and now because abi could change in very next transaction.
-               // Alternatively, we could store off all the abis needed and do the conversion later, but as this is designed
-               // to run on an API node, probably the best trade off to perform the abi serialization during block processing.
-               auto resolver = get_serializers_cache(control, trace, abi_max_time);
-               tt.trx_trace_v.clear();
-               abi_serializer::to_variant(*trace, tt.trx_trace_v, resolver, abi_max_time);
-            } catch( chain::abi_exception& ) {
-               tt.trx_trace_v = *trace;
-            }
+            tt.trx_trace = trace;
+            tt.trx_trace_abis = std::move( abis );
+            tt.trx_trace_size = trace_size;
          } );
       }
    }
 
    void on_block_start( uint32_t block_num ) {
+      // abi_sequence is only unique for the abis of the current block; an aborted or forked out block can reuse it
+      _pinned_abis.clear();
+      release_abis();
       // on forks rollback any accepted block transactions
       rollback_to( block_num );
    }
@@ -196,7 +259,7 @@ private:
                tt.last_try += fc::seconds( 10 );
             }
             tt.block_num = 0;
-            tt.trx_trace_v.clear();
+            tt.clear_trace();
          } );
       }
    }
@@ -235,8 +298,8 @@ private:
       // ack
       for( auto& i: to_process ) {
          _tracked_trxs.modify( i, [&]( tracked_transaction& tt ) {
-            tt.next( std::make_unique<fc::variant>( std::move( tt.trx_trace_v ) ) );
-            tt.trx_trace_v.clear();
+            tt.next( make_trace_variant_fn( std::move( tt.trx_trace ), std::move( tt.trx_trace_abis ), _abi_serializer_max_time ) );
+            tt.clear_trace();
          } );
          _tracked_trxs.erase( i );
       }
@@ -253,13 +316,63 @@ private:
       // ack
       for( auto& i: to_process ) {
          _tracked_trxs.modify( i, [&]( tracked_transaction& tt ) {
-            tt.next( std::make_unique<fc::variant>( std::move( tt.trx_trace_v ) ) );
-            tt.trx_trace_v.clear();
+            tt.next( make_trace_variant_fn( std::move( tt.trx_trace ), std::move( tt.trx_trace_abis ), _abi_serializer_max_time ) );
+            tt.clear_trace();
          } );
          _tracked_trxs.erase( i );
       }
    }
 
+   pinned_abis_t pin_abis( const transaction_trace& trace ) {
+      pinned_abis_t abis;
+      for( const auto& at : trace.action_traces ) {
+         const account_name& account = at.act.account;
+         if( std::find_if( abis.begin(), abis.end(), [&account]( const auto& a ) { return a.first == account; } ) == abis.end() ) {
+            abis.emplace_back( account, pin_abi( account ) );
+         }
+      }
+      return abis;
+   }
+
+   // copies the raw abi only once per abi_sequence, traces of the same contract share it
+   pinned_abi_ptr pin_abi( const account_name& account ) {
+      const auto& db = _controller.db();
+      const auto* meta = db.find<account_metadata_object, by_name>( account );
+      const auto* accnt = db.find<account_object, by_name>( account );
+      if( meta == nullptr || accnt == nullptr || accnt->abi.size() == 0 )
+         return {};
+      auto& pinned = _pinned_abis[account];
+      if( !pinned.second || pinned.first != meta->abi_sequence ) {
+         pinned.first = meta->abi_sequence;
+         pinned.second = share_abi( accnt->abi );
+      }
+      return pinned.second;
+   }
+
+   // traces held until lib span many blocks, they share a single copy of each distinct abi
+   pinned_abi_ptr share_abi( const shared_blob& abi ) {
+      auto& shared = _abis_by_hash[fc::sha256::hash( abi.data(), abi.size() )];
+      if( auto p = shared.lock() )
+         return p;
+      auto p = std::make_shared<const std::vector<char>>( abi.data(), abi.data() + abi.size() );
+      shared = p;
+      _pinned_abis_size += p->size();
+      return p;
+   }
+
+   // forget abis no longer held by any trace, the last reference may have been released on the http thread pool
+   void release_abis() {
+      _pinned_abis_size = 0;
+      for( auto i = _abis_by_hash.begin(); i != _abis_by_hash.end(); ) {
+         if( auto p = i->second.lock() ) {
+            _pinned_abis_size += p->size();
+            ++i;
+         } else {
+            i = _abis_by_hash.erase( i );
+         }
+      }
+   }
+
    void clear_expired(const block_timestamp_type& block_timestamp) {
       const fc::time_point block_time = block_timestamp;
       auto& idx = _tracked_trxs.index().get<by_expiry>();
@@ -285,6 +398,9 @@ private:
    const fc::microseconds _retry_interval; ///< how often to resend not seen transactions
    const fc::microseconds _max_expiration_time; ///< limit to expiration on transactions that are tracked
    fc::tracked_storage<tracked_transaction_index_t> _tracked_trxs;
+   std::unordered_map<account_name, std::pair<uint64_t, pinned_abi_ptr>> _pinned_abis; ///< abi_sequence and raw abi, for the current block
+   std::unordered_map<fc::sha256, std::weak_ptr<const std::vector<char>>> _abis_by_hash; ///< distinct raw abis pinned by traces
+   size_t _pinned_abis_size = 0; ///< total size of the abis in _abis_by_hash, may count released ones until release_abis()
 };
 
 trx_retry_db::trx_retry_db( const chain::controller& controller, size_t max_mem_usage_size,
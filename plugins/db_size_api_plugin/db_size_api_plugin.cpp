@@ -3,6 +3,8 @@
 #include <eosio/db_size_api_plugin/db_size_api_plugin.hpp>
 #include <eosio/http_plugin/http_plugin.hpp>
 
+#include <algorithm>
+
 namespace eosio {
 
    static auto _db_size_api_plugin = application::register_plugin<db_size_api_plugin>();
@@ -14,7 +16,6 @@ using namespace eosio;
    api_category::db_size, \
    [api_handle](string&&, string&& body, url_response_callback&& cb) mutable { \
           try { \
-             body = parse_params<std::string, http_params_types::no_params>(body); \
              INVOKE \
              cb(http_response_code, fc::variant(result)); \
           } catch (...) { \
@@ -23,13 +24,30 @@ using namespace eosio;
        }}
 
 #define INVOKE_R_V(api_handle, call_name) \
+     body = parse_params<std::string, http_params_types::no_params>(body); \
      auto result = api_handle->call_name();
 
+#define INVOKE_R_R_II(api_handle, call_name, in_param) \
+     auto params = parse_params<in_param, http_params_types::possible_no_params>(body); \
+     auto result = api_handle->call_name(std::move(params));
+
 
 void db_size_api_plugin::plugin_startup() {
    app().get_plugin<http_plugin>().add_api({
        CALL_WITH_400(db_size, this, get,  INVOKE_R_V(this, get), 200),
+       CALL_WITH_400(db_size, this, get_top_growth,  INVOKE_R_R_II(this, get_top_growth, db_size_top_growth_params), 200),
    }, appbase::exec_queue::read_only);
+
+   auto& chain = app().get_plugin<chain_plugin>().chain();
+   _accepted_block_connection.emplace(chain.accepted_block.connect([this](const chain::block_signal_params&) {
+      if (_samples.empty() || fc::time_point::now() - _samples.back().time >= sample_interval)
+         take_sample();
+   }));
+   take_sample();
+}
+
+void db_size_api_plugin::plugin_shutdown() {
+   _accepted_block_connection.reset();
 }
 
 db_size_stats db_size_api_plugin::get() {
@@ -47,7 +65,47 @@ db_size_stats db_size_api_plugin::get() {
    return ret;
 }
 
+void db_size_api_plugin::take_sample() {
+   const chainbase::database& db = app().get_plugin<chain_plugin>().chain().db();
+   sample s{.time = fc::time_point::now(),
+            .used_bytes = db.get_segment_manager()->get_size() - db.get_segment_manager()->get_free_memory()};
+   for(const auto& i : db.row_count_per_index())
+      s.index_rows[i.second] = i.first;
+
+   if(_samples.size() == max_samples)
+      _samples.pop_front();
+   _samples.emplace_back(std::move(s));
+}
+
+db_size_top_growth db_size_api_plugin::get_top_growth(const db_size_top_growth_params& params) {
+   db_size_top_growth ret;
+   if(_samples.size() < 2)
+      return ret;
+
+   const auto& oldest = _samples.front();
+   const auto& newest = _samples.back();
+   const auto window = newest.time - oldest.time;
+   ret.window_seconds = window.to_seconds();
+   ret.used_bytes_delta = static_cast<int64_t>(newest.used_bytes) - static_cast<int64_t>(oldest.used_bytes);
+
+   const double hours = static_cast<double>(window.count()) / fc::hours(1).count();
+   for(const auto& [index, rows] : newest.index_rows) {
+      auto itr = oldest.index_rows.find(index);
+      const int64_t delta = static_cast<int64_t>(rows) - static_cast<int64_t>(itr == oldest.index_rows.end() ? 0 : itr->second);
+      ret.indices.emplace_back(db_size_index_growth{index, rows, delta, hours > 0 ? delta / hours : 0});
+   }
+
+   const auto limit = std::min<size_t>(params.limit, ret.indices.size());
+   std::partial_sort(ret.indices.begin(), ret.indices.begin() + limit, ret.indices.end(), [](const auto& a, const auto& b) {
+      return std::abs(a.row_delta) > std::abs(b.row_delta);
+   });
+   ret.indices.resize(limit);
+
+   return ret;
+}
+
+#undef INVOKE_R_R_II
 #undef INVOKE_R_V
-#undef CALL
+#undef CALL_WITH_400
 
 }
@@ -5,6 +5,10 @@
 
 #include <eosio/chain/application.hpp>
 
+#include <boost/signals2/connection.hpp>
+
+#include <deque>
+
 namespace eosio {
 
 using namespace appbase;
@@ -21,6 +25,23 @@ struct db_size_stats {
    vector<db_size_index_count> indices;
 };
 
+struct db_size_top_growth_params {
+   uint32_t limit = 10;
+};
+
+struct db_size_index_growth {
+   string   index;
+   uint64_t row_count = 0;
+   int64_t  row_delta = 0;     // change in row count over the window
+   double   rows_per_hour = 0;
+};
+
+struct db_size_top_growth {
+   uint32_t                     window_seconds = 0; // time between the oldest and newest sample
+   int64_t                      used_bytes_delta = 0;
+   vector<db_size_index_growth> indices;            // ordered by absolute row_delta, largest first
+};
+
 class db_size_api_plugin : public plugin<db_size_api_plugin> {
 public:
    APPBASE_PLUGIN_REQUIRES((http_plugin) (chain_plugin))
@@ -35,14 +56,32 @@ public:
    virtual void set_program_options(options_description& cli, options_description& cfg) override {}
    void plugin_initialize(const variables_map& vm) {}
    void plugin_startup();
-   void plugin_shutdown() {}
+   void plugin_shutdown();
 
    db_size_stats get();
+   db_size_top_growth get_top_growth(const db_size_top_growth_params& params);
 
 private:
+   // row counts sampled every sample_interval as blocks are accepted, covering the last max_samples intervals
+   static constexpr auto   sample_interval = fc::seconds(10);
+   static constexpr size_t max_samples     = 360;
+
+   struct sample {
+      fc::time_point             time;
+      uint64_t                   used_bytes = 0;
+      std::map<string, uint64_t> index_rows;
+   };
+
+   void take_sample();
+
+   std::deque<sample>                                _samples; // written on the main thread, read by read-only api calls
+   std::optional<boost::signals2::scoped_connection> _accepted_block_connection;
 };
 
 }
 
 FC_REFLECT( eosio::db_size_index_count, (index)(row_count) )
 FC_REFLECT( eosio::db_size_stats, (free_bytes)(used_bytes)(size)(indices) )
+FC_REFLECT( eosio::db_size_top_growth_params, (limit) )
+FC_REFLECT( eosio::db_size_index_growth, (index)(row_count)(row_delta)(rows_per_hour) )
+FC_REFLECT( eosio::db_size_top_growth, (window_seconds)(used_bytes_delta)(indices) )
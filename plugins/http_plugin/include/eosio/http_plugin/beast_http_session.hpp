@@ -3,6 +3,7 @@
 #include <eosio/http_plugin/common.hpp>
 #include <eosio/http_plugin/api_category.hpp>
 
+#include <fc/compress/zlib.hpp>
 #include <fc/io/json.hpp>
 #include <fc/time.hpp>
 
@@ -91,6 +92,9 @@ class beast_http_session : public detail::abstract_conn,
    // whether response should be sent back to client when an exception occurs
    bool is_send_exception_response_ = true;
 
+   // whether the body of the current response is gzip encoded; only plaintext responses are, when the client accepts it
+   bool gzip_response_ = false;
+
    void set_content_type_header(http_content_type content_type) {
       switch (content_type) {
          case http_content_type::plaintext:
@@ -110,6 +114,7 @@ class beast_http_session : public detail::abstract_conn,
          class Body, class Allocator>
    void
    handle_request(http::request<Body, http::basic_fields<Allocator>>&& req) {
+      gzip_response_ = false;
       res_->version(req.version());
       res_->set(http::field::content_type, "application/json");
       res_->keep_alive(req.keep_alive());
@@ -165,6 +170,10 @@ class beast_http_session : public detail::abstract_conn,
             std::string body = req.body();
             auto content_type = handler_itr->second.content_type;
             set_content_type_header(content_type);
+            if (content_type == http_content_type::plaintext) {
+               res_->set(http::field::vary, "Accept-Encoding");
+               gzip_response_ = req[http::field::accept_encoding].find("gzip") != beast::string_view::npos;
+            }
 
             if (plugin_state_->update_metrics)
                plugin_state_->update_metrics({resource});
@@ -218,6 +227,7 @@ private:
 public:
 
    virtual void send_busy_response(std::string&& what) final {
+      gzip_response_ = false;
       error_results::error_info ei;
       ei.code = static_cast<int64_t>(http::status::service_unavailable);
       ei.name = "Busy";
@@ -446,6 +456,7 @@ public:
 
 
       if(is_send_exception_response_) {
+         gzip_response_ = false;
          set_content_type_header(http_content_type::json);
          res_->keep_alive(false);
          res_->set(http::field::server, BOOST_BEAST_VERSION_STRING);
@@ -464,6 +475,10 @@ public:
    }
 
    virtual void send_response(std::string&& json, unsigned int code) final {
+      if (gzip_response_) {
+         json = fc::gzip_compress(json);
+         res_->set(http::field::content_encoding, "gzip");
+      }
       auto payload_size = json.size();
       increment_bytes_in_flight(payload_size);
       write_begin_ = steady_clock::now();
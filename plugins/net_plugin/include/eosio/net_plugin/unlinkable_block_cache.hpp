@@ -0,0 +1,149 @@
+#pragma once
+#include <eosio/chain/block.hpp>
+#include <eosio/chain/types.hpp>
+
+#include <fc/io/raw.hpp>
+#include <fc/mutex.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
+
+#include <vector>
+
+namespace eosio {
+
+   using chain::block_id_type;
+   using chain::block_header;
+   using chain::block_timestamp_type;
+   using chain::signed_block_ptr;
+
+   struct unlinkable_block_state {
+      block_id_type    id;
+      signed_block_ptr block;
+      uint32_t         connection_id = 0;
+      size_t           size = 0; ///< packed size of block
+
+      uint32_t block_num() const { return block_header::num_from_id(id); }
+      const block_id_type& prev() const { return block->previous; }
+      const block_timestamp_type& timestamp() const { return block->timestamp; }
+   };
+
+   /// Blocks received before their parent, kept until the parent arrives. Bounded in total blocks, blocks per
+   /// connection and total packed bytes; thread safe.
+   class unlinkable_block_state_cache {
+   private:
+      struct by_timestamp;
+      struct by_block_num_id;
+      struct by_prev;
+      struct by_connection_timestamp;
+      using unlinkable_block_state_index = boost::multi_index_container<
+            eosio::unlinkable_block_state,
+            boost::multi_index::indexed_by<
+                  boost::multi_index::ordered_unique<boost::multi_index::tag<by_block_num_id>,
+                        boost::multi_index::composite_key<unlinkable_block_state,
+                              boost::multi_index::const_mem_fun<unlinkable_block_state, uint32_t, &eosio::unlinkable_block_state::block_num>,
+                              boost::multi_index::member<unlinkable_block_state, block_id_type, &eosio::unlinkable_block_state::id>
+                        >,
+                        boost::multi_index::composite_key_compare<std::less<>, chain::sha256_less>
+                  >,
+                  boost::multi_index::ordered_non_unique<boost::multi_index::tag<by_timestamp>,
+                        boost::multi_index::const_mem_fun<unlinkable_block_state, const block_timestamp_type&, &unlinkable_block_state::timestamp>
+                  >,
+                  boost::multi_index::ordered_non_unique<boost::multi_index::tag<by_prev>,
+                        boost::multi_index::const_mem_fun<unlinkable_block_state, const block_id_type&, &unlinkable_block_state::prev>
+                  >,
+                  boost::multi_index::ordered_non_unique<boost::multi_index::tag<by_connection_timestamp>,
+                        boost::multi_index::composite_key<unlinkable_block_state,
+                              boost::multi_index::member<unlinkable_block_state, uint32_t, &eosio::unlinkable_block_state::connection_id>,
+                              boost::multi_index::const_mem_fun<unlinkable_block_state, const block_timestamp_type&, &unlinkable_block_state::timestamp>
+                        >
+                  >
+            >
+      >;
+
+      mutable fc::mutex            unlinkable_blk_state_mtx;
+      unlinkable_block_state_index unlinkable_blk_state GUARDED_BY(unlinkable_blk_state_mtx);
+      size_t                       unlinkable_blk_state_bytes GUARDED_BY(unlinkable_blk_state_mtx) = 0;
+      const size_t                 max_blocks;
+      const size_t                 max_blocks_per_connection;
+      const size_t                 max_bytes;
+
+   public:
+      // 30 should be plenty large enough as any unlinkable block that will be usable is likely to be usable
+      // almost immediately (blocks came in from multiple peers out of order). 30 allows for one block per
+      // producer round until lib. When queue larger than max, remove by block timestamp farthest in the past.
+      static constexpr size_t default_max_blocks = 30;
+      // a single peer can not push out the blocks of all the others
+      static constexpr size_t default_max_blocks_per_connection = 10;
+      static constexpr size_t default_max_bytes = 32*1024*1024;
+
+      explicit unlinkable_block_state_cache( size_t max_blocks = default_max_blocks,
+                                             size_t max_blocks_per_connection = default_max_blocks_per_connection,
+                                             size_t max_bytes = default_max_bytes )
+      : max_blocks( max_blocks ), max_blocks_per_connection( max_blocks_per_connection ), max_bytes( max_bytes ) {}
+
+      // returns block ids of any blocks removed because of a full cache
+      std::vector<block_id_type> add_unlinkable_block( signed_block_ptr b, const block_id_type& id, uint32_t connection_id ) {
+         const size_t size = fc::raw::pack_size( *b );
+         fc::lock_guard g(unlinkable_blk_state_mtx);
+         // does not insert if already there
+         if( !unlinkable_blk_state.insert( {id, std::move(b), connection_id, size} ).second )
+            return {};
+         unlinkable_blk_state_bytes += size;
+
+         std::vector<block_id_type> removed;
+         auto& conn_index = unlinkable_blk_state.get<by_connection_timestamp>();
+         auto conn_blocks = conn_index.equal_range( connection_id );
+         if( static_cast<size_t>(std::distance( conn_blocks.first, conn_blocks.second )) > max_blocks_per_connection ) {
+            removed.push_back( conn_blocks.first->id );
+            unlinkable_blk_state_bytes -= conn_blocks.first->size;
+            conn_index.erase( conn_blocks.first );
+         }
+         auto& index = unlinkable_blk_state.get<by_timestamp>();
+         while( unlinkable_blk_state.size() > max_blocks ||
+                (unlinkable_blk_state_bytes > max_bytes && unlinkable_blk_state.size() > 1) ) {
+            auto begin = index.begin();
+            removed.push_back( begin->id );
+            unlinkable_blk_state_bytes -= begin->size;
+            index.erase( begin );
+         }
+         return removed;
+      }
+
+      // removes and returns the blocks that link to blkid
+      std::vector<unlinkable_block_state> pop_possible_linkable_blocks(const block_id_type& blkid) {
+         fc::lock_guard g(unlinkable_blk_state_mtx);
+         auto& index = unlinkable_blk_state.get<by_prev>();
+         auto children = index.equal_range( blkid );
+         std::vector<unlinkable_block_state> result( children.first, children.second );
+         for( const auto& r : result )
+            unlinkable_blk_state_bytes -= r.size;
+         index.erase( children.first, children.second );
+         return result;
+      }
+
+      void expire_blocks( uint32_t lib_num ) {
+         fc::lock_guard g(unlinkable_blk_state_mtx);
+         auto& stale_blk = unlinkable_blk_state.get<by_block_num_id>();
+         auto end = stale_blk.upper_bound( lib_num );
+         for( auto i = stale_blk.lower_bound( 1 ); i != end; ++i )
+            unlinkable_blk_state_bytes -= i->size;
+         stale_blk.erase( stale_blk.lower_bound( 1 ), end );
+      }
+
+      size_t size() const {
+         fc::lock_guard g(unlinkable_blk_state_mtx);
+         return unlinkable_blk_state.size();
+      }
+
+      // total packed size of the cached blocks
+      size_t bytes() const {
+         fc::lock_guard g(unlinkable_blk_state_mtx);
+         return unlinkable_blk_state_bytes;
+      }
+   };
+
+} // namespace eosio
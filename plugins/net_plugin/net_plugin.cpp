@@ -2,6 +2,7 @@
 #include <eosio/net_plugin/protocol.hpp>
 #include <eosio/net_plugin/net_utils.hpp>
 #include <eosio/net_plugin/auto_bp_peering.hpp>
+#include <eosio/net_plugin/unlinkable_block_cache.hpp>
 #include <eosio/chain/types.hpp>
 #include <eosio/chain/controller.hpp>
 #include <eosio/chain/exceptions.hpp>
@@ -13,11 +14,13 @@
 
 #include <fc/bitutil.hpp>
 #include <fc/network/message_buffer.hpp>
+#include <fc/io/chained_buffer.hpp>
 #include <fc/io/json.hpp>
 #include <fc/io/raw.hpp>
 #include <fc/reflect/variant.hpp>
 #include <fc/crypto/rand.hpp>
 #include <fc/exception/exception.hpp>
+#include <fc/log/trace_spans.hpp>
 #include <fc/time.hpp>
 #include <fc/mutex.hpp>
 #include <fc/network/listener.hpp>
@@ -147,81 +150,6 @@ namespace eosio {
       >
       > peer_block_state_index;
 
-   struct unlinkable_block_state {
-      block_id_type    id;
-      signed_block_ptr block;
-
-      uint32_t block_num() const { return block_header::num_from_id(id); }
-      const block_id_type& prev() const { return block->previous; }
-      const block_timestamp_type& timestamp() const { return block->timestamp; }
-   };
-
-   class unlinkable_block_state_cache {
-   private:
-      struct by_timestamp;
-      struct by_block_num_id;
-      struct by_prev;
-      using unlinkable_block_state_index = multi_index_container<
-            eosio::unlinkable_block_state,
-            indexed_by<
-                  ordered_unique<tag<by_block_num_id>,
-                        composite_key<unlinkable_block_state,
-                              const_mem_fun<unlinkable_block_state, uint32_t, &eosio::unlinkable_block_state::block_num>,
-                              member<unlinkable_block_state, block_id_type, &eosio::unlinkable_block_state::id>
-                        >,
-                        composite_key_compare<std::less<>, sha256_less>
-                  >,
-                  ordered_non_unique<tag<by_timestamp>,
-                        const_mem_fun<unlinkable_block_state, const block_timestamp_type&, &unlinkable_block_state::timestamp>
-                  >,
-                  ordered_non_unique<tag<by_prev>,
-                        const_mem_fun<unlinkable_block_state, const block_id_type&, &unlinkable_block_state::prev>
-                  >
-            >
-      >;
-
-      alignas(hardware_destructive_interference_size)
-      mutable fc::mutex            unlinkable_blk_state_mtx;
-      unlinkable_block_state_index unlinkable_blk_state GUARDED_BY(unlinkable_blk_state_mtx);
-      // 30 should be plenty large enough as any unlinkable block that will be usable is likely to be usable
-      // almost immediately (blocks came in from multiple peers out of order). 30 allows for one block per
-      // producer round until lib. When queue larger than max, remove by block timestamp farthest in the past.
-      static constexpr size_t max_unlinkable_cache_size = 30;
-
-   public:
-      // returns block id of any block removed because of a full cache
-      std::optional<block_id_type> add_unlinkable_block( signed_block_ptr b, const block_id_type& id ) {
-         fc::lock_guard g(unlinkable_blk_state_mtx);
-         unlinkable_blk_state.insert( {id, std::move(b)} ); // does not insert if already there
-         if (unlinkable_blk_state.size() > max_unlinkable_cache_size) {
-            auto& index = unlinkable_blk_state.get<by_timestamp>();
-            auto begin = index.begin();
-            block_id_type rm_block_id = begin->id;
-            index.erase( begin );
-            return rm_block_id;
-         }
-         return {};
-      }
-
-      unlinkable_block_state pop_possible_linkable_block(const block_id_type& blkid) {
-         fc::lock_guard g(unlinkable_blk_state_mtx);
-         auto& index = unlinkable_blk_state.get<by_prev>();
-         auto blk_itr = index.find( blkid );
-         if (blk_itr != index.end()) {
-            unlinkable_block_state result = *blk_itr;
-            index.erase(blk_itr);
-            return result;
-         }
-         return {};
-      }
-
-      void expire_blocks( uint32_t lib_num ) {
-         fc::lock_guard g(unlinkable_blk_state_mtx);
-         auto& stale_blk = unlinkable_blk_state.get<by_block_num_id>();
-         stale_blk.erase( stale_blk.lower_bound( 1 ), stale_blk.upper_bound( lib_num ) );
-      }
-   };
-
    class sync_manager {
    private:
       enum stages {
@@ -281,6 +209,7 @@ namespace eosio {
       mutable fc::mutex      local_txns_mtx;
       node_transaction_index  local_txns GUARDED_BY(local_txns_mtx);
 
+      alignas(hardware_destructive_interference_size)
       unlinkable_block_state_cache unlinkable_block_cache;
 
    public:
@@ -310,15 +239,14 @@ namespace eosio {
       bool have_txn( const transaction_id_type& tid ) const;
       void expire_txns();
 
-      void add_unlinkable_block( signed_block_ptr b, const block_id_type& id ) {
-         std::optional<block_id_type> rm_blk_id = unlinkable_block_cache.add_unlinkable_block(std::move(b), id);
-         if (rm_blk_id) {
+      void add_unlinkable_block( signed_block_ptr b, const block_id_type& id, uint32_t connection_id ) {
+         for( const auto& rm_blk_id : unlinkable_block_cache.add_unlinkable_block(std::move(b), id, connection_id) ) {
             // rm_block since we are no longer tracking this not applied block, allowing it to flow back in if needed
-            rm_block(*rm_blk_id);
+            rm_block(rm_blk_id);
          }
       }
-      unlinkable_block_state pop_possible_linkable_block( const block_id_type& blkid ) {
-         return unlinkable_block_cache.pop_possible_linkable_block(blkid);
+      std::vector<unlinkable_block_state> pop_possible_linkable_blocks( const block_id_type& blkid ) {
+         return unlinkable_block_cache.pop_possible_linkable_blocks(blkid);
       }
    };
 
@@ -337,11 +265,21 @@ namespace eosio {
    constexpr auto     def_resp_expected_wait = std::chrono::seconds(5);
    constexpr auto     def_sync_fetch_span = 1000;
    constexpr auto     def_keepalive_interval = 10000;
+   constexpr uint32_t def_block_send_chunk_size = 64*1024; // largest chunk signed_blocks are packed into
 
    constexpr auto     message_header_size = sizeof(uint32_t);
    constexpr uint32_t signed_block_which       = fc::get_index<net_message, signed_block>();       // see protocol net_message
    constexpr uint32_t packed_transaction_which = fc::get_index<net_message, packed_transaction>(); // see protocol net_message
 
+   using chained_send_buffer = fc::chained_buffer<def_block_send_chunk_size>;
+   /// serialized net_message: signed_blocks are packed in a single pass into a chain of chunks, everything else into one vector
+   using send_buffer_type = std::variant<std::shared_ptr<std::vector<char>>, std::shared_ptr<chained_send_buffer>>;
+
+   /// memory held by a queued send buffer, which is what the write queue limits bound
+   inline size_t send_buffer_size( const send_buffer_type& buff ) {
+      return std::visit( []( const auto& b ) -> size_t { return b->capacity(); }, buff );
+   }
+
    class connections_manager {
    public:
       struct connection_detail {
@@ -349,6 +287,8 @@ namespace eosio {
          connection_ptr c;
          tcp::endpoint active_ip;
          tcp::resolver::results_type ips;
+
+         uint32_t connection_id() const;
       };
 
       using connection_details_index = multi_index_container<
@@ -361,6 +301,10 @@ namespace eosio {
             ordered_unique<
                tag<struct by_connection>,
                key<&connection_detail::c>
+            >,
+            ordered_unique<
+               tag<struct by_connection_id>,
+               key<&connection_detail::connection_id>
             >
          >
       >;
@@ -424,6 +368,7 @@ namespace eosio {
 
       std::optional<connection_status> status(const string& host) const;
       vector<connection_status> connection_statuses() const;
+      connection_ptr find_connection(uint32_t connection_id) const;
 
       template <typename Function>
       bool any_of_supplied_peers(Function&& f) const;
@@ -715,7 +660,7 @@ namespace eosio {
       }
 
       // @param callback must not callback into queued_buffer
-      bool add_write_queue( const std::shared_ptr<vector<char>>& buff,
+      bool add_write_queue( const send_buffer_type& buff,
                             std::function<void( boost::system::error_code, std::size_t )> callback,
                             bool to_sync_queue ) {
          fc::lock_guard g( _mtx );
@@ -724,7 +669,7 @@ namespace eosio {
          } else {
             _write_queue.push_back( {buff, std::move(callback)} );
          }
-         _write_queue_size += buff->size();
+         _write_queue_size += send_buffer_size( buff );
          if( _write_queue_size > 2 * def_max_write_queue_size ) {
             return false;
          }
@@ -754,8 +699,13 @@ namespace eosio {
                             deque<queued_write>& w_queue ) REQUIRES(_mtx) {
          while ( !w_queue.empty() ) {
             auto& m = w_queue.front();
-            bufs.emplace_back( m.buff->data(), m.buff->size() );
-            _write_queue_size -= m.buff->size();
+            std::visit( chain::overloaded{
+               [&]( const std::shared_ptr<vector<char>>& b ) { bufs.emplace_back( b->data(), b->size() ); },
+               [&]( const std::shared_ptr<chained_send_buffer>& b ) {
+                  b->for_each_buffer( [&]( const char* d, size_t n ) { bufs.emplace_back( d, n ); } );
+               }
+            }, m.buff );
+            _write_queue_size -= send_buffer_size( m.buff );
             _out_queue.emplace_back( m );
             w_queue.pop_front();
          }
@@ -763,7 +713,7 @@ namespace eosio {
 
    private:
       struct queued_write {
-         std::shared_ptr<vector<char>> buff;
+         send_buffer_type buff;
          std::function<void( boost::system::error_code, std::size_t )> callback;
       };
 
@@ -1048,7 +998,7 @@ namespace eosio {
 
       void enqueue( const net_message &msg );
       size_t enqueue_block( const signed_block_ptr& sb, bool to_sync_queue = false);
-      void enqueue_buffer( const std::shared_ptr<std::vector<char>>& send_buffer,
+      void enqueue_buffer( const send_buffer_type& send_buffer,
                            go_away_reason close_after_send,
                            bool to_sync_queue = false);
       void cancel_sync(go_away_reason reason);
@@ -1062,7 +1012,7 @@ namespace eosio {
       void sync_timeout(boost::system::error_code ec);
       void fetch_timeout(boost::system::error_code ec);
 
-      void queue_write(const std::shared_ptr<vector<char>>& buff,
+      void queue_write(const send_buffer_type& buff,
                        std::function<void(boost::system::error_code, std::size_t)> callback,
                        bool to_sync_queue = false);
       void do_queue_write();
@@ -1100,6 +1050,9 @@ namespace eosio {
 
       void process_signed_block( const block_id_type& id, signed_block_ptr block, block_state_legacy_ptr bsp );
 
+      // thread safe, validates the headers of the cached unlinkable descendants of parent on the chain thread pool
+      void validate_linkable_blocks( const block_state_legacy_ptr& parent );
+
       fc::variant_object get_logger_variant() const {
          fc::mutable_variant_object mvo;
          mvo( "_name", log_p2p_address)
@@ -1642,7 +1595,7 @@ namespace eosio {
    }
 
    // called from connection strand
-   void connection::queue_write(const std::shared_ptr<vector<char>>& buff,
+   void connection::queue_write(const send_buffer_type& buff,
                                 std::function<void(boost::system::error_code, std::size_t)> callback,
                                 bool to_sync_queue) {
       if( !buffer_queue.add_write_queue( buff, std::move(callback), to_sync_queue )) {
@@ -1788,12 +1741,10 @@ namespace eosio {
 
    //------------------------------------------------------------------------
 
-   using send_buffer_type = std::shared_ptr<std::vector<char>>;
-
    struct buffer_factory {
 
       /// caches result for subsequent calls, only provide same net_message instance for each invocation
-      const send_buffer_type& get_send_buffer( const net_message& m ) {
+      const std::shared_ptr<std::vector<char>>& get_send_buffer( const net_message& m ) {
          if( !send_buffer ) {
             send_buffer = create_send_buffer( m );
          }
@@ -1801,10 +1752,10 @@ namespace eosio {
       }
 
    protected:
-      send_buffer_type send_buffer;
+      std::shared_ptr<std::vector<char>> send_buffer;
 
    protected:
-      static send_buffer_type create_send_buffer( const net_message& m ) {
+      static std::shared_ptr<std::vector<char>> create_send_buffer( const net_message& m ) {
          const uint32_t payload_size = fc::raw::pack_size( m );
 
          const char* const header = reinterpret_cast<const char* const>(&payload_size); // avoid variable size encoding of uint32_t
@@ -1819,7 +1770,7 @@ namespace eosio {
       }
 
       template< typename T>
-      static send_buffer_type create_send_buffer( uint32_t which, const T& v ) {
+      static std::shared_ptr<std::vector<char>> create_send_buffer( uint32_t which, const T& v ) {
          // match net_message static_variant pack
          const uint32_t which_size = fc::raw::pack_size( unsigned_int( which ) );
          const uint32_t payload_size = which_size + fc::raw::pack_size( v );
@@ -1838,10 +1789,10 @@ namespace eosio {
 
    };
 
-   struct block_buffer_factory : public buffer_factory {
+   struct block_buffer_factory {
 
       /// caches result for subsequent calls, only provide same signed_block_ptr instance for each invocation.
-      const send_buffer_type& get_send_buffer( const signed_block_ptr& sb ) {
+      const std::shared_ptr<chained_send_buffer>& get_send_buffer( const signed_block_ptr& sb ) {
          if( !send_buffer ) {
             send_buffer = create_send_buffer( sb );
          }
@@ -1849,20 +1800,32 @@ namespace eosio {
       }
 
    private:
+      std::shared_ptr<chained_send_buffer> send_buffer;
 
-      static std::shared_ptr<std::vector<char>> create_send_buffer( const signed_block_ptr& sb ) {
+      // packs directly into pooled chunks in a single pass, no pack_size traversal and no block sized allocation
+      static std::shared_ptr<chained_send_buffer> create_send_buffer( const signed_block_ptr& sb ) {
          static_assert( signed_block_which == fc::get_index<net_message, signed_block>() );
          // this implementation is to avoid copy of signed_block to net_message
          // matches which of net_message for signed_block
          fc_dlog( logger, "sending block ${bn}", ("bn", sb->block_num()) );
-         return buffer_factory::create_send_buffer( signed_block_which, *sb );
+
+         auto send_buffer = std::make_shared<chained_send_buffer>();
+         auto ds = send_buffer->create_datastream();
+         uint32_t payload_size = 0; // filled in once the block is packed
+         ds.write( reinterpret_cast<const char*>(&payload_size), message_header_size ); // avoid variable size encoding of uint32_t
+         fc::raw::pack( ds, unsigned_int( signed_block_which ) );
+         fc::raw::pack( ds, *sb );
+         payload_size = send_buffer->size() - message_header_size;
+         send_buffer->write_at( 0, reinterpret_cast<const char*>(&payload_size), message_header_size );
+
+         return send_buffer;
       }
    };
 
    struct trx_buffer_factory : public buffer_factory {
 
       /// caches result for subsequent calls, only provide same packed_transaction_ptr instance for each invocation.
-      const send_buffer_type& get_send_buffer( const packed_transaction_ptr& trx ) {
+      const std::shared_ptr<std::vector<char>>& get_send_buffer( const packed_transaction_ptr& trx ) {
          if( !send_buffer ) {
             send_buffer = create_send_buffer( trx );
          }
@@ -1907,7 +1870,7 @@ namespace eosio {
    }
 
    // called from connection strand
-   void connection::enqueue_buffer( const std::shared_ptr<std::vector<char>>& send_buffer,
+   void connection::enqueue_buffer( const send_buffer_type& send_buffer,
                                     go_away_reason close_after_send,
                                     bool to_sync_queue)
    {
@@ -3029,6 +2992,7 @@ namespace eosio {
          auto peek_ds = pending_message_buffer.create_peek_datastream();
          unsigned_int which{};
          fc::raw::unpack( peek_ds, which );
+         FC_TRACE_SPAN( "net_message", "net", which.value );
          if( which == signed_block_which ) {
             latest_blk_time = std::chrono::system_clock::now();
             return process_next_block_message( message_length );
@@ -3700,6 +3664,7 @@ namespace eosio {
    void connection::handle_message( const block_id_type& id, signed_block_ptr ptr ) {
       // post to dispatcher strand so that we don't have multiple threads validating the block header
       my_impl->dispatcher->strand.post([id, c{shared_from_this()}, ptr{std::move(ptr)}, cid=connection_id]() mutable {
+         FC_TRACE_SPAN( "net_block_header", "net", block_header::num_from_id(id) );
          controller& cc = my_impl->chain_plug->chain();
 
          // may have come in on a different connection and posted into dispatcher strand before this one
@@ -3758,6 +3723,7 @@ namespace eosio {
    void connection::process_signed_block( const block_id_type& blk_id, signed_block_ptr block, block_state_legacy_ptr bsp ) {
       controller& cc = my_impl->chain_plug->chain();
       uint32_t blk_num = block_header::num_from_id(blk_id);
+      FC_TRACE_SPAN( "net_signed_block", "net", blk_num );
       // use c in this method instead of this to highlight that all methods called on c-> must be thread safe
       connection_ptr c = shared_from_this();
 
@@ -3814,19 +3780,20 @@ namespace eosio {
          boost::asio::post( my_impl->thread_pool.get_executor(), [dispatcher = my_impl->dispatcher.get(), c, blk_id, blk_num]() {
             fc_dlog( logger, "accepted signed_block : #${n} ${id}...", ("n", blk_num)("id", blk_id.str().substr(8,16)) );
             dispatcher->add_peer_block( blk_id, c->connection_id );
-
-            while (true) { // attempt previously unlinkable blocks where prev_unlinkable->block->previous == blk_id
-               unlinkable_block_state prev_unlinkable = dispatcher->pop_possible_linkable_block(blk_id);
-               if (!prev_unlinkable.block)
-                  break;
-               fc_dlog( logger, "retrying previous unlinkable block #${n} ${id}...",
-                        ("n", block_header::num_from_id(prev_unlinkable.id))("id", prev_unlinkable.id.str().substr(8,16)) );
-               // post at medium_high since this is likely the next block that should be processed (other block processing is at priority::medium)
-               app().executor().post(priority::medium_high, exec_queue::read_write, [prev_unlinkable{std::move(prev_unlinkable)}, c]() mutable {
-                  c->process_signed_block( prev_unlinkable.id, std::move(prev_unlinkable.block), {} );
+         });
+         // attempt previously unlinkable blocks where prev_unlinkable->block->previous == blk_id
+         if( block_state_legacy_ptr accepted_bsp = bsp ? bsp : cc.fetch_block_state_by_id( blk_id ) ) {
+            c->validate_linkable_blocks( accepted_bsp );
+         } else {
+            // no longer in the fork database, the controller validates them against it
+            for( auto& prev_unlinkable : my_impl->dispatcher->pop_possible_linkable_blocks( blk_id ) ) {
+               // processed on behalf of the connection that sent it, so a bad block is blamed on that connection
+               connection_ptr from = my_impl->connections.find_connection( prev_unlinkable.connection_id );
+               app().executor().post(priority::medium_high, exec_queue::read_write, [prev_unlinkable{std::move(prev_unlinkable)}, from{from ? from : c}]() mutable {
+                  from->process_signed_block( prev_unlinkable.id, std::move(prev_unlinkable.block), {} );
                });
             }
-         });
+         }
          c->strand.post( [sync_master = my_impl->sync_master.get(), dispatcher = my_impl->dispatcher.get(), c, blk_id, blk_num]() {
             dispatcher->recv_block( c, blk_id, blk_num );
             sync_master->sync_recv_block( c, blk_id, blk_num, true );
@@ -3835,7 +3802,7 @@ namespace eosio {
          c->strand.post( [sync_master = my_impl->sync_master.get(), dispatcher = my_impl->dispatcher.get(), c,
                           block{std::move(block)}, blk_id, blk_num, reason]() mutable {
             if( reason == unlinkable || reason == no_reason ) {
-               dispatcher->add_unlinkable_block( std::move(block), blk_id );
+               dispatcher->add_unlinkable_block( std::move(block), blk_id, c->connection_id );
             }
             // reason==no_reason means accept_block() return false because we are producing, don't call rejected_block which sends handshake
             if( reason != no_reason ) {
@@ -3846,6 +3813,49 @@ namespace eosio {
       }
    }
 
+   // thread safe
+   void connection::validate_linkable_blocks( const block_state_legacy_ptr& parent ) {
+      controller& cc = my_impl->chain_plug->chain();
+      for( auto& prev_unlinkable : my_impl->dispatcher->pop_possible_linkable_blocks( parent->id ) ) {
+         fc_dlog( logger, "retrying previous unlinkable block #${n} ${id}...",
+                  ("n", block_header::num_from_id(prev_unlinkable.id))("id", prev_unlinkable.id.str().substr(8,16)) );
+         // Siblings are validated in parallel. A block's own children stay in the cache until it has been accepted,
+         // process_signed_block then validates them, so they are not lost if its apply fails.
+         boost::asio::post( cc.get_thread_pool(), [prev_unlinkable{std::move(prev_unlinkable)}, parent, c{shared_from_this()}]() mutable {
+            controller& cc = my_impl->chain_plug->chain();
+            const auto& id = prev_unlinkable.id;
+            block_state_legacy_ptr bsp;
+            try {
+               bsp = cc.create_block_state( id, prev_unlinkable.block, *parent );
+            } catch( const fc::exception& ex ) {
+               fc_ilog( logger, "bad block exception connection ${cid}: #${n} ${id}...: ${m}",
+                        ("cid", prev_unlinkable.connection_id)("n", block_header::num_from_id(id))("id", id.str().substr(8,16))("m",ex.to_string()));
+            } catch( ... ) {
+               fc_wlog( logger, "bad block connection ${cid}: #${n} ${id}...: unknown exception",
+                        ("cid", prev_unlinkable.connection_id)("n", block_header::num_from_id(id))("id", id.str().substr(8,16)));
+            }
+            // the block came from the connection recorded in the cache, not necessarily the one that sent its parent
+            connection_ptr from = my_impl->connections.find_connection( prev_unlinkable.connection_id );
+            if( !bsp ) {
+               if( from ) {
+                  from->strand.post( [from, id]() {
+                     my_impl->sync_master->rejected_block( from, block_header::num_from_id(id) );
+                     my_impl->dispatcher->rejected_block( id );
+                  });
+               } else {
+                  c->strand.post( [id]() { my_impl->dispatcher->rejected_block( id ); } );
+               }
+               return;
+            }
+
+            // post at medium_high since this is likely the next block that should be processed (other block processing is at priority::medium)
+            app().executor().post(priority::medium_high, exec_queue::read_write, [prev_unlinkable, bsp, from{from ? from : c}]() mutable {
+               from->process_signed_block( prev_unlinkable.id, std::move(prev_unlinkable.block), std::move(bsp) );
+            });
+         });
+      }
+   }
+
    // thread safe
    void net_plugin_impl::start_expire_timer() {
       if( in_shutdown ) return;
@@ -4603,6 +4613,20 @@ namespace eosio {
       return result;
    }
 
+   uint32_t connections_manager::connection_detail::connection_id()const {
+      return c->connection_id;
+   }
+
+   // thread safe, null if the connection has gone away
+   connection_ptr connections_manager::find_connection( uint32_t connection_id )const {
+      std::shared_lock g( connections_mtx );
+      auto& index = connections.get<by_connection_id>();
+      auto iter = index.find( connection_id );
+      if( iter != index.end() )
+         return iter->c;
+      return {};
+   }
+
    // call with connections_mtx
    connection_ptr connections_manager::find_connection_i( const string& host )const {
       auto& index = connections.get<by_host>();
@@ -0,0 +1,134 @@
+#include <boost/test/unit_test.hpp>
+#include <eosio/net_plugin/unlinkable_block_cache.hpp>
+#include <fc/bitutil.hpp>
+
+using namespace eosio;
+using namespace eosio::chain;
+
+namespace {
+
+// block in `slot` whose parent is `prev`; padding grows its packed size
+signed_block_ptr make_block(const block_id_type& prev, uint32_t slot, size_t padding = 0) {
+   auto b = std::make_shared<signed_block>();
+   b->previous  = prev;
+   b->timestamp = block_timestamp_type(slot);
+   if (padding)
+      b->block_extensions.emplace_back(0, std::vector<char>(padding));
+   return b;
+}
+
+// parent ids that are never in the cache, so every cached block is unlinkable
+block_id_type missing_parent(uint32_t n) {
+   block_id_type id;
+   id._hash[0] = fc::endian_reverse_u32(n);
+   id._hash[1] = n;
+   return id;
+}
+
+struct cached_block {
+   block_id_type id;
+   size_t        size = 0;
+};
+
+cached_block add(unlinkable_block_state_cache& cache, uint32_t slot, uint32_t connection_id, size_t padding = 0,
+                 std::vector<block_id_type>* removed = nullptr) {
+   auto b = make_block(missing_parent(slot), slot, padding);
+   cached_block r{b->calculate_id(), fc::raw::pack_size(*b)};
+   auto rm = cache.add_unlinkable_block(b, r.id, connection_id);
+   if (removed)
+      *removed = std::move(rm);
+   return r;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(unlinkable_block_cache_tests)
+
+BOOST_AUTO_TEST_CASE(per_connection_bound) {
+   unlinkable_block_state_cache cache(30, 3);
+   std::vector<block_id_type> removed;
+
+   // an older block of another connection is not evicted by a busy connection
+   add(cache, 1, 2);
+   std::vector<cached_block> blocks;
+   for (uint32_t slot = 10; slot < 13; ++slot) {
+      blocks.push_back(add(cache, slot, 1, 0, &removed));
+      BOOST_CHECK(removed.empty());
+   }
+   BOOST_CHECK_EQUAL(cache.size(), 4u);
+
+   // the oldest block of the connection goes first, regardless of insertion order
+   add(cache, 20, 1, 0, &removed);
+   BOOST_REQUIRE_EQUAL(removed.size(), 1u);
+   BOOST_CHECK(removed[0] == blocks[0].id);
+   const auto older = add(cache, 5, 1, 0, &removed);
+   BOOST_REQUIRE_EQUAL(removed.size(), 1u);
+   BOOST_CHECK(removed[0] == older.id);
+   BOOST_CHECK_EQUAL(cache.size(), 4u);
+
+   BOOST_CHECK_EQUAL(cache.pop_possible_linkable_blocks(missing_parent(1)).size(), 1u);
+   BOOST_CHECK_EQUAL(cache.pop_possible_linkable_blocks(missing_parent(20)).size(), 1u);
+   BOOST_CHECK_EQUAL(cache.pop_possible_linkable_blocks(missing_parent(10)).size(), 0u);
+   BOOST_CHECK_EQUAL(cache.size(), 2u);
+   BOOST_CHECK_EQUAL(cache.bytes(), blocks[1].size + blocks[2].size);
+}
+
+BOOST_AUTO_TEST_CASE(total_block_bound) {
+   unlinkable_block_state_cache cache(4, 10);
+   std::vector<block_id_type> removed;
+
+   std::vector<cached_block> blocks;
+   for (uint32_t slot = 1; slot <= 4; ++slot)
+      blocks.push_back(add(cache, slot, slot % 2));
+
+   // oldest by timestamp across all connections is evicted
+   add(cache, 10, 7, 0, &removed);
+   BOOST_REQUIRE_EQUAL(removed.size(), 1u);
+   BOOST_CHECK(removed[0] == blocks[0].id);
+   BOOST_CHECK_EQUAL(cache.size(), 4u);
+
+   // duplicates are neither added nor counted
+   const size_t bytes = cache.bytes();
+   auto b = make_block(missing_parent(4), 4);
+   BOOST_CHECK(cache.add_unlinkable_block(b, b->calculate_id(), 3).empty());
+   BOOST_CHECK_EQUAL(cache.size(), 4u);
+   BOOST_CHECK_EQUAL(cache.bytes(), bytes);
+}
+
+BOOST_AUTO_TEST_CASE(total_byte_bound) {
+   const size_t padding = 1000;
+   const size_t block_size = fc::raw::pack_size(*make_block(missing_parent(1), 1, padding));
+   unlinkable_block_state_cache cache(30, 10, 3 * block_size);
+   std::vector<block_id_type> removed;
+
+   std::vector<cached_block> blocks;
+   for (uint32_t slot = 1; slot <= 3; ++slot) {
+      blocks.push_back(add(cache, slot, slot, padding, &removed));
+      BOOST_CHECK(removed.empty());
+   }
+   BOOST_CHECK_EQUAL(cache.bytes(), 3 * block_size);
+
+   // a small block over the limit evicts the oldest
+   const auto small = add(cache, 4, 4, 0, &removed);
+   BOOST_REQUIRE_EQUAL(removed.size(), 1u);
+   BOOST_CHECK(removed[0] == blocks[0].id);
+   BOOST_CHECK_EQUAL(cache.bytes(), 2 * block_size + small.size);
+
+   // a block larger than the limit evicts everything older, but is kept itself
+   const auto large = add(cache, 5, 5, 4 * padding, &removed);
+   BOOST_CHECK_EQUAL(removed.size(), 3u);
+   BOOST_CHECK_EQUAL(cache.size(), 1u);
+   BOOST_CHECK_EQUAL(cache.bytes(), large.size);
+
+   add(cache, 6, 6, 0, &removed);
+   BOOST_REQUIRE_EQUAL(removed.size(), 1u);
+   BOOST_CHECK(removed[0] == large.id);
+   BOOST_CHECK_EQUAL(cache.size(), 1u);
+
+   // expired blocks are no longer counted
+   cache.expire_blocks(block_header::num_from_id(missing_parent(6)) + 1);
+   BOOST_CHECK_EQUAL(cache.size(), 0u);
+   BOOST_CHECK_EQUAL(cache.bytes(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
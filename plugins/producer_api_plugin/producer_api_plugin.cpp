@@ -113,6 +113,8 @@ void producer_api_plugin::plugin_startup() {
                      INVOKE_R_R_D(producer, get_unapplied_transactions, producer_plugin::get_unapplied_transactions_params), 200),
        CALL_WITH_400(producer, producer_ro, producer, get_snapshot_requests,
                      INVOKE_R_V(producer, get_snapshot_requests), 201),
+       CALL_WITH_400(producer, producer_ro, producer, get_trace_spans,
+                     INVOKE_R_R_II(producer, get_trace_spans, producer_plugin::get_trace_spans_params), 200),
    }, appbase::exec_queue::read_only, appbase::priority::medium_high);
 
    // Not safe to run in parallel
@@ -101,6 +101,13 @@ public:
    chain::snapshot_scheduler::snapshot_schedule_result unschedule_snapshot(const chain::snapshot_scheduler::snapshot_request_id_information& schedule);
    chain::snapshot_scheduler::get_snapshot_requests_result get_snapshot_requests() const;
 
+   struct get_trace_spans_params {
+      uint32_t seconds = 10; ///< spans that ended within this many seconds
+   };
+
+   /// Chrome trace-event JSON of the recorded spans of all threads, requires trace-spans-per-thread
+   fc::variant get_trace_spans(const get_trace_spans_params& params) const;
+
    scheduled_protocol_feature_activations get_scheduled_protocol_feature_activations() const;
    void schedule_protocol_feature_activations(const scheduled_protocol_feature_activations& schedule);
 
@@ -159,6 +166,27 @@ public:
       int64_t      block_other_time_us   = 0;
    };
 
+   // wall clock time of each phase of applying a block, see controller::block_report
+   struct block_phase_metrics {
+      int64_t block_state_wait_us    = 0; // waiting on header and producer signature validation of a received block
+      int64_t start_block_us         = 0;
+      int64_t execution_us           = 0;
+      int64_t key_recovery_wait_us   = 0;
+      int64_t finalize_block_us      = 0;
+      int64_t signal_us              = 0;
+      int64_t log_irreversible_us    = 0;
+   };
+
+   // chainbase undo session activity of a block, see controller::block_report
+   struct block_db_metrics {
+      std::size_t squash_count     = 0;
+      int64_t     squash_us        = 0;
+      std::size_t undo_count       = 0;
+      int64_t     undo_us          = 0;
+      int64_t     commit_us        = 0;
+      int64_t     undo_stack_depth = 0;
+   };
+
    struct produced_block_metrics : public speculative_block_metrics {
       std::size_t unapplied_transactions_total       = 0;
       std::size_t subjective_bill_account_size_total = 0;
@@ -168,6 +196,8 @@ public:
       int64_t     total_elapsed_time_us              = 0;
       int64_t     total_time_us                      = 0;
       uint64_t    net_usage_us                       = 0;
+      block_phase_metrics phases;
+      block_db_metrics    db;
 
       uint32_t last_irreversible = 0;
       uint32_t head_block_num    = 0;
@@ -180,6 +210,8 @@ public:
       int64_t     total_time_us         = 0;
       uint64_t    net_usage_us          = 0;
       int64_t     block_latency_us      = 0;
+      block_phase_metrics phases;
+      block_db_metrics    db;
 
       uint32_t last_irreversible = 0;
       uint32_t head_block_num    = 0;
@@ -205,6 +237,7 @@ FC_REFLECT(eosio::producer_plugin::scheduled_protocol_feature_activations, (prot
 FC_REFLECT(eosio::producer_plugin::get_supported_protocol_features_params, (exclude_disabled)(exclude_unactivatable))
 FC_REFLECT(eosio::producer_plugin::get_account_ram_corrections_params, (lower_bound)(upper_bound)(limit)(reverse))
 FC_REFLECT(eosio::producer_plugin::get_account_ram_corrections_result, (rows)(more))
+FC_REFLECT(eosio::producer_plugin::get_trace_spans_params, (seconds))
 FC_REFLECT(eosio::producer_plugin::get_unapplied_transactions_params, (lower_bound)(limit)(time_limit_ms))
 FC_REFLECT(eosio::producer_plugin::unapplied_trx, (trx_id)(expiration)(trx_type)(first_auth)(first_receiver)(first_action)(total_actions)(billed_cpu_time_us)(size))
 FC_REFLECT(eosio::producer_plugin::get_unapplied_transactions_result, (size)(incoming_size)(trxs)(more))
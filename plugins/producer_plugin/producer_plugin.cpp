@@ -12,6 +12,7 @@
 
 #include <fc/io/json.hpp>
 #include <fc/log/logger_config.hpp>
+#include <fc/log/trace_spans.hpp>
 #include <fc/scoped_exit.hpp>
 #include <fc/time.hpp>
 
@@ -93,6 +94,26 @@ bool exception_is_exhausted(const fc::exception& e) {
           (code == deadline_exception::code_value) ||
           (code == ro_trx_vm_oc_compile_temporary_failure::code_value);
 }
+
+producer_plugin::block_phase_metrics to_phase_metrics(const controller::block_report& br,
+                                                      fc::microseconds block_state_wait = fc::microseconds{}) {
+   return {.block_state_wait_us  = block_state_wait.count(),
+           .start_block_us       = br.start_block_time.count(),
+           .execution_us         = br.execution_time.count(),
+           .key_recovery_wait_us = br.key_recovery_wait_time.count(),
+           .finalize_block_us    = br.finalize_block_time.count(),
+           .signal_us            = br.signal_time.count(),
+           .log_irreversible_us  = br.log_irreversible_time.count()};
+}
+
+producer_plugin::block_db_metrics to_db_metrics(const controller::block_report& br) {
+   return {.squash_count     = br.db_squash_count,
+           .squash_us        = br.db_squash_time.count(),
+           .undo_count       = br.db_undo_count,
+           .undo_us          = br.db_undo_time.count(),
+           .commit_us        = br.db_commit_time.count(),
+           .undo_stack_depth = br.undo_stack_depth};
+}
 } // namespace
 
 namespace {
@@ -707,8 +728,11 @@ public:
       };
 
       controller::block_report br;
+      fc::microseconds         block_state_wait{};
       try {
+         const auto wait_start = fc::time_point::now();
          const block_state_legacy_ptr& bspr = bsp ? bsp : bsf.get();
+         block_state_wait = fc::time_point::now() - wait_start;
          chain.push_block(
             br,
             bspr,
@@ -762,6 +786,8 @@ public:
                                          .total_time_us         = br.total_time.count(),
                                          .net_usage_us          = br.total_net_usage,
                                          .block_latency_us      = (now - block->timestamp).count(),
+                                         .phases                = to_phase_metrics(br, block_state_wait),
+                                         .db                    = to_db_metrics(br),
                                          .last_irreversible     = chain.last_irreversible_block_num(),
                                          .head_block_num        = blk_num});
       }
@@ -1088,6 +1114,8 @@ void producer_plugin::set_program_options(
           "Time in microseconds the write window lasts.")
          ("read-only-read-window-time-us", bpo::value<uint32_t>()->default_value(my->_ro_read_window_time_us.count()),
           "Time in microseconds the read window lasts.")
+         ("trace-spans-per-thread", bpo::value<uint32_t>()->default_value(0),
+          "Number of most recent block and transaction processing spans kept per thread for /v1/producer/get_trace_spans. 0 disables span recording.")
          ;
    config_file_options.add(producer_options);
 }
@@ -1256,6 +1284,8 @@ void producer_plugin_impl::plugin_initialize(const boost::program_options::varia
    }
    app().executor().init_read_threads(_ro_thread_pool_size);
 
+   fc::tracing::set_spans_per_thread(options.at("trace-spans-per-thread").as<uint32_t>());
+
    // Make sure _ro_max_trx_time_us is always set.
    // Make sure a read-only transaction can finish within the read
    // window if scheduled at the very beginning of the window.
@@ -1558,6 +1588,11 @@ producer_plugin::unschedule_snapshot(const chain::snapshot_scheduler::snapshot_r
    return my->_snapshot_scheduler.unschedule_snapshot(sri.snapshot_request_id);
 }
 
+fc::variant producer_plugin::get_trace_spans(const get_trace_spans_params& params) const {
+   EOS_ASSERT(fc::tracing::spans_enabled(), unsupported_feature, "span recording is disabled, see trace-spans-per-thread");
+   return fc::tracing::get_spans(fc::seconds(params.seconds));
+}
+
 chain::snapshot_scheduler::get_snapshot_requests_result producer_plugin::get_snapshot_requests() const {
    return my->_snapshot_scheduler.get_snapshot_requests();
 }
@@ -2646,7 +2681,7 @@ void producer_plugin_impl::produce_block() {
       return sigs;
    });
 
-   chain.commit_block();
+   chain.commit_block(br);
 
    block_state_legacy_ptr new_bs = chain.head_block_state();
    producer_plugin::produced_block_metrics metrics;
@@ -2671,6 +2706,8 @@ void producer_plugin_impl::produce_block() {
       metrics.total_elapsed_time_us = br.total_elapsed_time.count();
       metrics.total_time_us = br.total_time.count();
       metrics.net_usage_us = br.total_net_usage;
+      metrics.phases = to_phase_metrics(br);
+      metrics.db = to_db_metrics(br);
       metrics.last_irreversible = chain.last_irreversible_block_num();
       metrics.head_block_num = chain.head_block_num();
       _update_produced_block_metrics(metrics);
@@ -2792,6 +2829,7 @@ void producer_plugin_impl::switch_to_read_window() {
 
 // Called from a read only thread. Run in parallel with app and other read only threads
 bool producer_plugin_impl::read_only_execution_task(uint32_t pending_block_num) {
+   FC_TRACE_SPAN("read_only_window", "producer", pending_block_num);
    // We have 3 ways to break out the while loop:
    // 1. pass read window deadline
    // 2. net_plugin receives a block
@@ -2842,6 +2880,7 @@ void producer_plugin_impl::repost_exhausted_transactions(const fc::time_point& d
 // Called from a read_only_trx execution thread, or from app thread when executing exclusively
 // Return whether the trx needs to be retried in next read window
 bool producer_plugin_impl::push_read_only_transaction(transaction_metadata_ptr trx, next_function<transaction_trace_ptr> next) {
+   FC_TRACE_SPAN("push_read_only_transaction", "producer");
    auto retry = false;
 
    try {
@@ -3,18 +3,107 @@
 #include <eosio/http_plugin/http_plugin.hpp>
 #include <eosio/net_plugin/net_plugin.hpp>
 #include <eosio/producer_plugin/producer_plugin.hpp>
+#include <eosio/chain/async_signal_subscriber.hpp>
 
 #include <prometheus/counter.h>
+#include <prometheus/histogram.h>
 #include <prometheus/info.h>
 #include <prometheus/registry.h>
 #include <prometheus/text_serializer.h>
 #include <fc/log/logger.hpp>
+
+#include <boost/signals2/connection.hpp>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string_view>
+#include <vector>
+
 namespace eosio::metrics {
 
+/**
+ * Counters labeled by key that any thread increments without taking a lock, aggregated into prometheus counters only
+ * when scraped. Each thread counts into its own map, which only that thread inserts into (taking the map's mutex) and
+ * the scrape walks under the same mutex, so incrementing an already seen key is a map lookup and a relaxed atomic add.
+ */
+class per_thread_counters {
+public:
+   per_thread_counters(prometheus::Family<prometheus::Counter>& family, std::string label)
+      : _family(family), _label(std::move(label)) {}
+
+   void increment(const std::string& key) {
+      auto& counts = this_thread_counts();
+      auto itr = counts.values.find(key);
+      if (itr == counts.values.end()) {
+         std::lock_guard g(counts.mtx);
+         itr = counts.values.try_emplace(key, 0).first;
+      }
+      itr->second.fetch_add(1, std::memory_order_relaxed);
+   }
+
+   /// add the increments since the last call to the prometheus counters; not thread safe, call from the scrape only
+   void aggregate() {
+      std::map<std::string, uint64_t> totals;
+      {
+         std::lock_guard g(_mtx);
+         for (const auto& counts : _threads) {
+            std::lock_guard tg(counts->mtx);
+            for (const auto& [key, value] : counts->values)
+               totals[key] += value.load(std::memory_order_relaxed);
+         }
+      }
+      for (const auto& [key, total] : totals) {
+         auto& r = _reported[key];
+         if (!r.counter)
+            r.counter = &_family.Add({{_label, key}});
+         if (total > r.count) {
+            r.counter->Increment(total - r.count);
+            r.count = total;
+         }
+      }
+   }
+
+private:
+   struct thread_counts {
+      std::mutex                                   mtx;
+      std::map<std::string, std::atomic<uint64_t>> values;
+   };
+
+   // counts of threads that have exited are kept, prometheus counters never go down
+   thread_counts& this_thread_counts() {
+      thread_local std::pair<const per_thread_counters*, std::shared_ptr<thread_counts>> counts;
+      if (counts.first != this) {
+         auto c = std::make_shared<thread_counts>();
+         {
+            std::lock_guard g(_mtx);
+            _threads.push_back(c);
+         }
+         counts = {this, std::move(c)};
+      }
+      return *counts.second;
+   }
+
+   struct reported {
+      prometheus::Counter* counter = nullptr;
+      uint64_t             count   = 0;
+   };
+
+   prometheus::Family<prometheus::Counter>&    _family;
+   const std::string                           _label;
+   std::mutex                                  _mtx;
+   std::vector<std::shared_ptr<thread_counts>> _threads; // guarded by _mtx
+   std::map<std::string, reported>             _reported;
+};
+
 struct catalog_type {
 
-   using Gauge   = prometheus::Gauge;
-   using Counter = prometheus::Counter;
+   using Gauge     = prometheus::Gauge;
+   using Counter   = prometheus::Counter;
+   using Histogram = prometheus::Histogram;
 
    template <typename T>
    prometheus::Family<T>& family(const std::string& name, const std::string& help) {
@@ -32,6 +121,7 @@ struct catalog_type {
    prometheus::Info info_details;
    // http plugin
    prometheus::Family<Counter>& http_request_counts;
+   per_thread_counters          http_request_counters;
 
    // net plugin failed p2p connection
    Counter& failed_p2p_connections;
@@ -61,9 +151,27 @@ struct catalog_type {
       prometheus::Family<Gauge>& block_sync_throttling;
       prometheus::Family<Gauge>& connection_start_time;
       prometheus::Family<Gauge>& peer_addr; // Empty gauge; we only want the label
+
+      static constexpr size_t num_per_connection = 16;
+      // families with a gauge labeled only by connid, in the order update() sets them
+      std::array<prometheus::Family<Gauge>*, num_per_connection> per_connection() {
+         return {&connection_number, &port, &accepting_blocks, &last_received_block, &first_available_block,
+                 &last_available_block, &unique_first_block_count, &latency, &bytes_received, &last_bytes_received,
+                 &bytes_sent, &last_bytes_sent, &block_sync_bytes_received, &block_sync_bytes_sent,
+                 &block_sync_throttling, &connection_start_time};
+      }
    };
    p2p_connection_metrics p2p_metrics;
 
+   // gauges of a connection, resolved when the connection is first reported instead of on every update
+   struct p2p_connection_gauges {
+      Gauge*      addr = nullptr;
+      std::string addr_ipv6;
+      std::string addr_address;
+      std::array<Gauge*, p2p_connection_metrics::num_per_connection> values{};
+   };
+   std::map<std::string, p2p_connection_gauges> p2p_connections; // keyed by connid
+
    // producer plugin
    prometheus::Family<Counter>& cpu_usage_us;
    prometheus::Family<Counter>& net_usage_us;
@@ -108,6 +216,71 @@ struct catalog_type {
    Counter& latency_us_incoming_block;
    Counter& blocks_incoming;
 
+   // block lifecycle phases, labeled by phase and block_type
+   prometheus::Family<Histogram>& block_phase_us;
+   const Histogram::BucketBoundaries block_phase_buckets{
+      100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000};
+   // (block_type, phase) -> series, labels are string literals so the views stay valid
+   std::map<std::pair<std::string_view, std::string_view>, Histogram*> block_phase_histograms;
+
+   // chainbase undo sessions, labeled by block_type
+   prometheus::Family<Counter>& db_squash_count;
+   prometheus::Family<Counter>& db_squash_us;
+   prometheus::Family<Counter>& db_undo_count;
+   prometheus::Family<Counter>& db_undo_us;
+   prometheus::Family<Counter>& db_commit_us;
+   Gauge&                       db_undo_stack_depth;
+
+   struct block_db_metrics {
+      Counter& squash_count;
+      Counter& squash_us;
+      Counter& undo_count;
+      Counter& undo_us;
+      Counter& commit_us;
+   };
+   block_db_metrics produced_db_metrics;
+   block_db_metrics incoming_db_metrics;
+
+   block_db_metrics make_block_db_metrics(const std::string& block_type) {
+      const prometheus::Labels labels{{"block_type", block_type}};
+      return {.squash_count{db_squash_count.Add(labels)},
+              .squash_us{db_squash_us.Add(labels)},
+              .undo_count{db_undo_count.Add(labels)},
+              .undo_us{db_undo_us.Add(labels)},
+              .commit_us{db_commit_us.Add(labels)}};
+   }
+
+   // chainbase shared memory segment and per index row counts, sampled on the main thread at most every
+   // db_sample_interval as blocks are accepted
+   static constexpr auto db_sample_interval = fc::seconds(10);
+   Gauge&                                            db_free_bytes;
+   Gauge&                                            db_used_bytes;
+   prometheus::Family<Gauge>&                        db_index_rows;
+   std::map<std::string, Gauge*>                     db_index_row_gauges;
+   fc::time_point                                    last_db_sample; // main thread
+   std::optional<boost::signals2::scoped_connection> accepted_block_connection;
+
+   struct db_sample {
+      uint64_t                                      free_bytes = 0;
+      uint64_t                                      size       = 0;
+      std::vector<std::pair<std::string, uint64_t>> index_rows;
+   };
+
+   // controller signal subscribers connected through an async_signal_subscriber, read when scraped
+   prometheus::Family<Gauge>&   signal_queue_size;
+   prometheus::Family<Gauge>&   signal_queue_lag_us;
+   prometheus::Family<Counter>& signal_dispatched;
+   prometheus::Family<Counter>& signal_dropped;
+   struct signal_subscriber_metrics {
+      Gauge*   queue_size = nullptr;
+      Gauge*   queue_lag_us = nullptr;
+      Counter* dispatched = nullptr;
+      Counter* dropped = nullptr;
+      uint64_t last_dispatched = 0;
+      uint64_t last_dropped = 0;
+   };
+   std::map<std::string, signal_subscriber_metrics> signal_subscribers;
+
    // prometheus exporter
    Counter& bytes_transferred;
    Counter& num_scrapes;
@@ -116,6 +289,7 @@ struct catalog_type {
    catalog_type()
        : info(family<prometheus::Info>("nodeos", "static information about the server"))
        , http_request_counts(family<Counter>("nodeos_http_requests_total", "number of HTTP requests"))
+       , http_request_counters(http_request_counts, "handler")
        , failed_p2p_connections(build<Counter>("nodeos_p2p_failed_connections", "total number of failed out-going p2p connections"))
        , dropped_trxs_total(build<Counter>("nodeos_p2p_dropped_trxs_total", "total number of dropped transactions by net plugin"))
        , p2p_metrics{
@@ -184,11 +358,49 @@ struct catalog_type {
        , net_usage_us_incoming_block(net_usage_us.Add({{"block_type", "incoming"}}))
        , latency_us_incoming_block(build<Counter>("nodeos_incoming_us_block_latency", "total incoming block latency"))
        , blocks_incoming(build<Counter>("nodeos_blocks_incoming", "number of incoming blocks"))
+       , block_phase_us(family<Histogram>("nodeos_block_phase_us", "time in microseconds spent in each phase of applying a block"))
+       , db_squash_count(family<Counter>("nodeos_db_squash_total", "number of transaction undo sessions squashed into blocks"))
+       , db_squash_us(family<Counter>("nodeos_db_squash_us_total", "total time in microseconds squashing transaction undo sessions"))
+       , db_undo_count(family<Counter>("nodeos_db_undo_total", "number of transaction undo sessions undone"))
+       , db_undo_us(family<Counter>("nodeos_db_undo_us_total", "total time in microseconds undoing transaction undo sessions"))
+       , db_commit_us(family<Counter>("nodeos_db_commit_us_total", "total time in microseconds committing irreversible revisions"))
+       , db_undo_stack_depth(build<Gauge>("nodeos_db_undo_stack_depth", "revisions on the chainbase undo stack"))
+       , produced_db_metrics(make_block_db_metrics("produced"))
+       , incoming_db_metrics(make_block_db_metrics("incoming"))
+       , db_free_bytes(build<Gauge>("nodeos_db_free_bytes", "free bytes in the chainbase shared memory segment"))
+       , db_used_bytes(build<Gauge>("nodeos_db_used_bytes", "used bytes in the chainbase shared memory segment"))
+       , db_index_rows(family<Gauge>("nodeos_db_index_rows", "number of rows in a chainbase index"))
+       , signal_queue_size(family<Gauge>("nodeos_signal_queue_size", "controller signals queued for an asynchronous subscriber"))
+       , signal_queue_lag_us(family<Gauge>("nodeos_signal_queue_lag_us", "time in microseconds the oldest queued signal of an asynchronous subscriber has waited"))
+       , signal_dispatched(family<Counter>("nodeos_signal_dispatched_total", "controller signals handled by an asynchronous subscriber"))
+       , signal_dropped(family<Counter>("nodeos_signal_dropped_total", "controller signals dropped by an asynchronous subscriber with a full queue"))
        , bytes_transferred(build<Counter>("exposer_transferred_bytes_total",
                                           "total number of bytes for responses to prometheus scrape requests"))
        , num_scrapes(build<Counter>("exposer_scrapes_total", "total number of prometheus scrape requests received")) {}
 
+   void update_signal_subscribers() {
+      for (const auto& stats : chain::async_signal_subscriber::get_all_stats()) {
+         auto& m = signal_subscribers[stats.name];
+         if (!m.queue_size) {
+            const prometheus::Labels labels{{"subscriber", stats.name}};
+            m.queue_size   = &signal_queue_size.Add(labels);
+            m.queue_lag_us = &signal_queue_lag_us.Add(labels);
+            m.dispatched   = &signal_dispatched.Add(labels);
+            m.dropped      = &signal_dropped.Add(labels);
+         }
+         m.queue_size->Set(stats.queued);
+         m.queue_lag_us->Set(stats.lag.count());
+         // a subscriber re-created under the same name starts counting from 0 again
+         m.dispatched->Increment(stats.dispatched - std::min(m.last_dispatched, stats.dispatched));
+         m.dropped->Increment(stats.dropped - std::min(m.last_dropped, stats.dropped));
+         m.last_dispatched = stats.dispatched;
+         m.last_dropped    = stats.dropped;
+      }
+   }
+
    std::string report() {
+      http_request_counters.aggregate();
+      update_signal_subscribers();
       const prometheus::TextSerializer serializer;
       auto                             result = serializer.Serialize(registry.Collect());
       bytes_transferred.Increment(result.size());
@@ -196,44 +408,93 @@ struct catalog_type {
       return result;
    }
 
-   void update(const http_plugin::metrics& metrics) {
-      http_request_counts.Add({{"handler", metrics.target}}).Increment(1);
-   }
-
    void update(const net_plugin::p2p_connections_metrics& metrics) {
       p2p_metrics.num_peers.Set(metrics.num_peers);
       p2p_metrics.num_clients.Set(metrics.num_clients);
+
+      const auto families = p2p_metrics.per_connection();
+      std::set<std::string> reported;
       for(size_t i = 0; i < metrics.stats.peers.size(); ++i) {
          const auto& peer = metrics.stats.peers[i];
          const auto& conn_id = peer.unique_conn_node_id;
+         reported.insert(conn_id);
+
+         auto& gauges = p2p_connections[conn_id];
+         if (!gauges.values[0]) {
+            for (size_t f = 0; f < families.size(); ++f)
+               gauges.values[f] = &families[f]->Add({{"connid", conn_id}});
+         }
 
          const auto addr = boost::asio::ip::make_address_v6(peer.address).to_string();
-         p2p_metrics.addr.Add({{"connid", conn_id},{"ipv6", addr},{"address", peer.p2p_address}});
-
-         auto add_and_set_gauge = [&](auto& fam, const auto& value) {
-            auto& gauge = fam.Add({{"connid", conn_id}});
-            gauge.Set(value);
-         };
-
-         add_and_set_gauge(p2p_metrics.connection_number, peer.connection_id);
-         add_and_set_gauge(p2p_metrics.port, peer.port);
-         add_and_set_gauge(p2p_metrics.accepting_blocks, peer.accepting_blocks);
-         add_and_set_gauge(p2p_metrics.last_received_block, peer.last_received_block);
-         add_and_set_gauge(p2p_metrics.first_available_block, peer.first_available_block);
-         add_and_set_gauge(p2p_metrics.last_available_block, peer.last_available_block);
-         add_and_set_gauge(p2p_metrics.unique_first_block_count, peer.unique_first_block_count);
-         add_and_set_gauge(p2p_metrics.latency, peer.latency);
-         add_and_set_gauge(p2p_metrics.bytes_received, peer.bytes_received);
-         add_and_set_gauge(p2p_metrics.last_bytes_received, peer.last_bytes_received.count());
-         add_and_set_gauge(p2p_metrics.bytes_sent, peer.bytes_sent);
-         add_and_set_gauge(p2p_metrics.last_bytes_sent, peer.last_bytes_sent.count());
-         add_and_set_gauge(p2p_metrics.block_sync_bytes_received, peer.block_sync_bytes_received);
-         add_and_set_gauge(p2p_metrics.block_sync_bytes_sent, peer.block_sync_bytes_sent);
-         add_and_set_gauge(p2p_metrics.block_sync_throttling, peer.block_sync_throttling);
-         add_and_set_gauge(p2p_metrics.connection_start_time, peer.connection_start_time.count());
+         if (!gauges.addr || gauges.addr_ipv6 != addr || gauges.addr_address != peer.p2p_address) {
+            if (gauges.addr)
+               p2p_metrics.addr.Remove(gauges.addr);
+            gauges.addr = &p2p_metrics.addr.Add({{"connid", conn_id},{"ipv6", addr},{"address", peer.p2p_address}});
+            gauges.addr_ipv6 = addr;
+            gauges.addr_address = peer.p2p_address;
+         }
+
+         const std::array<double, p2p_connection_metrics::num_per_connection> values{
+            static_cast<double>(peer.connection_id),
+            static_cast<double>(peer.port),
+            static_cast<double>(peer.accepting_blocks),
+            static_cast<double>(peer.last_received_block),
+            static_cast<double>(peer.first_available_block),
+            static_cast<double>(peer.last_available_block),
+            static_cast<double>(peer.unique_first_block_count),
+            static_cast<double>(peer.latency),
+            static_cast<double>(peer.bytes_received),
+            static_cast<double>(peer.last_bytes_received.count()),
+            static_cast<double>(peer.bytes_sent),
+            static_cast<double>(peer.last_bytes_sent.count()),
+            static_cast<double>(peer.block_sync_bytes_received),
+            static_cast<double>(peer.block_sync_bytes_sent),
+            static_cast<double>(peer.block_sync_throttling),
+            static_cast<double>(peer.connection_start_time.count())};
+         for (size_t f = 0; f < values.size(); ++f)
+            gauges.values[f]->Set(values[f]);
+      }
+
+      // drop the series of connections that have gone away rather than reporting their last values forever
+      for (auto itr = p2p_connections.begin(); itr != p2p_connections.end();) {
+         if (reported.contains(itr->first)) {
+            ++itr;
+            continue;
+         }
+         p2p_metrics.addr.Remove(itr->second.addr);
+         for (size_t f = 0; f < families.size(); ++f)
+            families[f]->Remove(itr->second.values[f]);
+         itr = p2p_connections.erase(itr);
+      }
+   }
+
+   void update(block_db_metrics& db_metrics, const producer_plugin::block_db_metrics& metrics) {
+      db_metrics.squash_count.Increment(metrics.squash_count);
+      db_metrics.squash_us.Increment(metrics.squash_us);
+      db_metrics.undo_count.Increment(metrics.undo_count);
+      db_metrics.undo_us.Increment(metrics.undo_us);
+      db_metrics.commit_us.Increment(metrics.commit_us);
+      db_undo_stack_depth.Set(metrics.undo_stack_depth);
+   }
+
+   void update(const db_sample& sample) {
+      db_free_bytes.Set(sample.free_bytes);
+      db_used_bytes.Set(sample.size - sample.free_bytes);
+      for (const auto& [index, rows] : sample.index_rows) {
+         auto& gauge = db_index_row_gauges[index];
+         if (!gauge)
+            gauge = &db_index_rows.Add({{"index", index}});
+         gauge->Set(rows);
       }
    }
 
+   void observe_block_phase(std::string_view block_type, std::string_view phase, int64_t us) {
+      auto& histogram = block_phase_histograms[{block_type, phase}];
+      if (!histogram)
+         histogram = &block_phase_us.Add({{"phase", std::string(phase)}, {"block_type", std::string(block_type)}}, block_phase_buckets);
+      histogram->Observe(us);
+   }
+
    void update(block_metrics& blk_metrics, const producer_plugin::speculative_block_metrics& metrics) {
       blk_metrics.num_blocks_created.Increment(1);
       blk_metrics.current_block_num.Set(metrics.block_num);
@@ -258,6 +519,13 @@ struct catalog_type {
       total_time_us_produced_block.Increment(metrics.total_time_us);
       net_usage_us_produced_block.Increment(metrics.net_usage_us);
 
+      // produced blocks execute their transactions over the whole block window, so only the bracketing phases are observed
+      observe_block_phase("produced", "start_block", metrics.phases.start_block_us);
+      observe_block_phase("produced", "finalize_block", metrics.phases.finalize_block_us);
+      observe_block_phase("produced", "signal", metrics.phases.signal_us);
+      observe_block_phase("produced", "log_irreversible", metrics.phases.log_irreversible_us);
+
+      update(produced_db_metrics, metrics.db);
       update(produced_metrics, metrics);
 
       last_irreversible.Set(metrics.last_irreversible);
@@ -277,6 +545,15 @@ struct catalog_type {
       net_usage_us_incoming_block.Increment(metrics.net_usage_us);
       latency_us_incoming_block.Increment(metrics.block_latency_us);
 
+      observe_block_phase("incoming", "block_state_wait", metrics.phases.block_state_wait_us);
+      observe_block_phase("incoming", "start_block", metrics.phases.start_block_us);
+      observe_block_phase("incoming", "execution", metrics.phases.execution_us);
+      observe_block_phase("incoming", "key_recovery_wait", metrics.phases.key_recovery_wait_us);
+      observe_block_phase("incoming", "finalize_block", metrics.phases.finalize_block_us);
+      observe_block_phase("incoming", "signal", metrics.phases.signal_us);
+      observe_block_phase("incoming", "log_irreversible", metrics.phases.log_irreversible_us);
+      update(incoming_db_metrics, metrics.db);
+
       last_irreversible.Set(metrics.last_irreversible);
       head_block_num.Set(metrics.head_block_num);
    }
@@ -292,8 +569,9 @@ struct catalog_type {
    }
    void register_update_handlers(boost::asio::io_context::strand& strand) {
       auto& http = app().get_plugin<http_plugin>();
+      // called on the http threads for every request, counted there and aggregated when scraped
       http.register_update_metrics(
-          [&strand, this](http_plugin::metrics metrics) { strand.post([metrics = std::move(metrics), this]() { update(metrics); }); });
+          [this](http_plugin::metrics metrics) { http_request_counters.increment(metrics.target); });
 
       auto& net = app().get_plugin<net_plugin>();
 
@@ -310,6 +588,21 @@ struct catalog_type {
          dropped_trxs_total.Increment(1);
       });
 
+      auto& chain = app().get_plugin<chain_plugin>().chain();
+      accepted_block_connection.emplace(chain.accepted_block.connect([&strand, &chain, this](const chain::block_signal_params&) {
+         const auto now = fc::time_point::now();
+         if (now - last_db_sample < db_sample_interval)
+            return;
+         last_db_sample = now;
+
+         const auto& db = chain.db();
+         db_sample sample{.free_bytes = db.get_segment_manager()->get_free_memory(),
+                          .size       = db.get_segment_manager()->get_size()};
+         for (const auto& [rows, index] : db.row_count_per_index())
+            sample.index_rows.emplace_back(index, rows);
+         strand.post([sample = std::move(sample), this]() { update(sample); });
+      }));
+
       auto& producer = app().get_plugin<producer_plugin>();
       producer.register_update_produced_block_metrics(
           [&strand, this](const producer_plugin::produced_block_metrics& metrics) {
@@ -71,6 +71,7 @@ namespace eosio {
    }
 
    void prometheus_plugin::plugin_shutdown() {
+      my->_catalog.accepted_block_connection.reset();
       my->_prometheus_thread_pool.stop();
       ilog("Prometheus plugin shutdown.");
    }
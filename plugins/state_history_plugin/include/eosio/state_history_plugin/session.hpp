@@ -4,6 +4,8 @@
 #include <eosio/state_history/serialization.hpp>
 #include <eosio/state_history/types.hpp>
 
+#include <fc/log/trace_spans.hpp>
+
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/buffer.hpp>
 #include <boost/asio/local/stream_protocol.hpp>
@@ -359,6 +361,7 @@ private:
                 fc::datastream<const char*> ds(d, s);
                 state_history::state_request req;
                 fc::raw::unpack(ds, req);
+                FC_TRACE_SPAN("ship_request", "ship", req.index());
                 std::visit( [self]( auto& r ) {
                    self->process( r );
                 }, req );
@@ -384,6 +387,7 @@ private:
       if (result.traces.has_value()) {
          auto& optional_log = plugin.get_trace_log();
          if( optional_log ) {
+            FC_TRACE_SPAN("ship_read_traces", "ship", result.this_block->block_num);
             buf.emplace( optional_log->create_locked_decompress_stream() );
             return optional_log->get_unpacked_entry( result.this_block->block_num, *buf );
          }
@@ -396,6 +400,7 @@ private:
       if (result.deltas.has_value()) {
          auto& optional_log = plugin.get_chain_state_log();
          if( optional_log ) {
+            FC_TRACE_SPAN("ship_read_deltas", "ship", result.this_block->block_num);
             buf.emplace( optional_log->create_locked_decompress_stream() );
             return optional_log->get_unpacked_entry( result.this_block->block_num, *buf );
          }
@@ -523,6 +528,7 @@ private:
       }
 
       if (block_id) {
+         FC_TRACE_SPAN("ship_get_blocks_result", "ship", to_send_block_num);
          result.this_block  = state_history::block_position{to_send_block_num, *block_id};
          auto prev_block_id = plugin.get_block_id(to_send_block_num - 1);
          if (prev_block_id)
@@ -19,6 +19,7 @@
 #include <boost/signals2/connection.hpp>
 #include <mutex>
 
+#include <fc/log/trace_spans.hpp>
 #include <fc/network/listener.hpp>
 
 namespace ws = boost::beast::websocket;
@@ -225,6 +226,7 @@ public:
       // this method is called from the main thread and "plugin_started" is set on the main thread as well when plugin is started 
       if (plugin_started) {
          boost::asio::post(get_ship_executor(), [self = this->shared_from_this(), block, id]() {
+            FC_TRACE_SPAN("ship_send_update", "ship", block->block_num());
             self->get_session_manager().send_update(block, id);
          });
       }
@@ -247,6 +249,7 @@ public:
       if (!trace_log)
          return;
 
+      FC_TRACE_SPAN("ship_store_traces", "ship", block->block_num());
       state_history_log_header header{.magic        = ship_magic(ship_current_version, 0),
                                       .block_id     = id,
                                       .payload_size = 0};
@@ -259,6 +262,7 @@ public:
    void store_chain_state(const block_id_type& id, const signed_block_header& block_header, uint32_t block_num) {
       if (!chain_state_log)
          return;
+      FC_TRACE_SPAN("ship_store_chain_state", "ship", block_num);
       bool fresh = chain_state_log->empty();
       if (fresh)
          fc_ilog(_log, "Placing initial state in block ${n}", ("n", block_num));
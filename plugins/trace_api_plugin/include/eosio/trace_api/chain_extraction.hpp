@@ -3,9 +3,12 @@
 #include <eosio/trace_api/common.hpp>
 #include <eosio/trace_api/trace.hpp>
 #include <eosio/trace_api/extract_util.hpp>
+#include <eosio/chain/thread_utils.hpp>
+#include <condition_variable>
 #include <exception>
 #include <functional>
 #include <map>
+#include <mutex>
 
 namespace eosio { namespace trace_api {
 
@@ -19,11 +22,37 @@ public:
     * Chain Extractor for capturing transaction traces, action traces, and block info.
     * @param store provider of append & append_lib
     * @param except_handler called on exceptions, logging if any is left to the user
+    * @param threads number of threads converting blocks of traces, 0 to convert and store on the signalling thread.
+    *                With threads the signals only capture the traces, conversion runs in parallel and the results are
+    *                stored in signal order.
+    * @param max_queued_blocks blocks and libs signalled but not yet stored before the signalling thread waits
     */
-   chain_extraction_impl_type( StoreProvider store, exception_handler except_handler )
+   chain_extraction_impl_type( StoreProvider store, exception_handler except_handler, uint32_t threads = 0, uint32_t max_queued_blocks = 1 )
    : store(std::move(store))
    , except_handler(std::move(except_handler))
-   {}
+   , max_queued(std::max<uint32_t>(max_queued_blocks, 1))
+   {
+      if( threads > 0 ) {
+         thread_pool.emplace();
+         thread_pool->start( threads, {} );
+      }
+   }
+
+   ~chain_extraction_impl_type() {
+      if( thread_pool ) {
+         flush();
+         thread_pool->stop();
+      }
+   }
+
+   chain_extraction_impl_type( const chain_extraction_impl_type& ) = delete;
+   chain_extraction_impl_type& operator=( const chain_extraction_impl_type& ) = delete;
+
+   /// wait until everything signalled so far has been stored
+   void flush() {
+      std::unique_lock g( mtx );
+      queue_cv.wait( g, [this]() { return queued == 0; } );
+   }
 
    /// connect to chain controller applied_transaction signal
    void signal_applied_transaction( const chain::transaction_trace_ptr& trace, const chain::packed_transaction_ptr& ptrx ) {
@@ -64,11 +93,30 @@ private:
    }
 
    void on_accepted_block(const chain::signed_block_ptr& block, const chain::block_id_type& id ) {
-      store_block_trace( block, id );
+      block_job job = make_block_job( block, id );
+      if( !thread_pool ) {
+         store_block_trace( job );
+         return;
+      }
+      post_ordered( [this, job = std::move( job )]() -> store_op {
+         try {
+            return [this, bt = to_block_trace( job ), tt = job.trx_ids]() mutable {
+               store_block_trace( std::move( bt ), std::move( tt ) );
+            };
+         } catch( ... ) {
+            return [this, e = std::current_exception()]() { except_handler( MAKE_EXCEPTION_WITH_CONTEXT( e ) ); };
+         }
+      } );
    }
 
    void on_irreversible_block( uint32_t block_num ) {
-      store_lib( block_num );
+      if( !thread_pool ) {
+         store_lib( block_num );
+         return;
+      }
+      post_ordered( [this, block_num]() -> store_op {
+         return [this, block_num]() { store_lib( block_num ); };
+      } );
    }
 
    void on_block_start( uint32_t block_num ) {
@@ -80,43 +128,118 @@ private:
       onblock_trace.reset();
    }
 
-   void store_block_trace( const chain::signed_block_ptr& block, const chain::block_id_type& id ) {
-      try {
-         using transaction_trace_t = transaction_trace_v3;
-         auto bt = create_block_trace( block, id );
-
-         std::vector<transaction_trace_t> traces;
-         traces.reserve( block->transactions.size() + 1 );
-         block_trxs_entry tt;
-         tt.ids.reserve(block->transactions.size() + 1);
-         if( onblock_trace )
-            traces.emplace_back( to_transaction_trace<transaction_trace_t>( *onblock_trace ));
-         for( const auto& r : block->transactions ) {
-            transaction_id_type id;
-            if( std::holds_alternative<transaction_id_type>(r.trx)) {
-               id = std::get<transaction_id_type>(r.trx);
-            } else {
-               id = std::get<packed_transaction>(r.trx).id();
-            }
-            const auto it = cached_traces.find( id );
-            if( it != cached_traces.end() ) {
-               traces.emplace_back( to_transaction_trace<transaction_trace_t>( it->second ));
-            }
-            tt.ids.emplace_back(id);
+   // the traces of a block in block order, captured on the signalling thread
+   struct block_job {
+      chain::signed_block_ptr    block;
+      chain::block_id_type       id;
+      std::vector<cache_trace>   traces;
+      block_trxs_entry           trx_ids;
+   };
+
+   block_job make_block_job( const chain::signed_block_ptr& block, const chain::block_id_type& id ) {
+      block_job job{ .block = block, .id = id };
+      job.traces.reserve( block->transactions.size() + 1 );
+      job.trx_ids.ids.reserve( block->transactions.size() + 1 );
+      if( onblock_trace )
+         job.traces.emplace_back( std::move( *onblock_trace ) );
+      for( const auto& r : block->transactions ) {
+         transaction_id_type id;
+         if( std::holds_alternative<transaction_id_type>(r.trx)) {
+            id = std::get<transaction_id_type>(r.trx);
+         } else {
+            id = std::get<packed_transaction>(r.trx).id();
+         }
+         const auto it = cached_traces.find( id );
+         if( it != cached_traces.end() ) {
+            job.traces.emplace_back( std::move( it->second ) );
          }
-         bt.transactions = std::move( traces );
-         clear_caches();
+         job.trx_ids.ids.emplace_back(id);
+      }
+      // tt entry acts as a placeholder in a trx id slice if this block has no transaction
+      job.trx_ids.block_num = block->block_num();
+      clear_caches();
+      return job;
+   }
 
-         // tt entry acts as a placeholder in a trx id slice if this block has no transaction
-         tt.block_num = bt.number;
-         store.append_trx_ids( std::move(tt) );
+   static block_trace_v2 to_block_trace( const block_job& job ) {
+      using transaction_trace_t = transaction_trace_v3;
+      auto bt = create_block_trace( job.block, job.id );
+
+      std::vector<transaction_trace_t> traces;
+      traces.reserve( job.traces.size() );
+      for( const auto& t : job.traces )
+         traces.emplace_back( to_transaction_trace<transaction_trace_t>( t ));
+      bt.transactions = std::move( traces );
+      return bt;
+   }
 
+   void store_block_trace( const block_job& job ) {
+      try {
+         store_block_trace( to_block_trace( job ), job.trx_ids );
+      } catch( ... ) {
+         except_handler( MAKE_EXCEPTION_WITH_CONTEXT( std::current_exception() ) );
+      }
+   }
+
+   void store_block_trace( block_trace_v2 bt, block_trxs_entry tt ) {
+      try {
+         store.append_trx_ids( std::move(tt) );
          store.append( std::move( bt ) );
       } catch( ... ) {
          except_handler( MAKE_EXCEPTION_WITH_CONTEXT( std::current_exception() ) );
       }
    }
 
+   using store_op = std::function<void()>;
+
+   // Runs `convert` on the thread pool, then the store_op it returns in the order post_ordered was called. The
+   // thread that completes the next store_op in order runs every consecutive one that is ready.
+   void post_ordered( std::function<store_op()> convert ) {
+      uint64_t seq = 0;
+      {
+         std::unique_lock g( mtx );
+         queue_cv.wait( g, [this]() { return queued < max_queued; } );
+         // except_handler threw on a pool thread, unwind the signalling thread as it would have without threads
+         if( failed )
+            throw yield_exception( "trace extraction failed" );
+         ++queued;
+         seq = next_seq++;
+      }
+      boost::asio::post( thread_pool->get_executor(), [this, seq, convert = std::move( convert )]() {
+         store_op op = convert();
+         {
+            std::lock_guard g( mtx );
+            ready.emplace( seq, std::move( op ) );
+            if( storing )
+               return;
+            storing = true;
+         }
+         for( ;; ) {
+            {
+               std::lock_guard g( mtx );
+               if( ready.empty() || ready.begin()->first != next_store_seq ) {
+                  storing = false;
+                  return;
+               }
+               op = std::move( ready.begin()->second );
+               ready.erase( ready.begin() );
+            }
+            try {
+               op();
+            } catch( ... ) {
+               std::lock_guard g( mtx );
+               failed = true;
+            }
+            {
+               std::lock_guard g( mtx );
+               ++next_store_seq;
+               --queued;
+            }
+            queue_cv.notify_all();
+         }
+      } );
+   }
+
    void store_lib( uint32_t block_num ) {
       try {
          store.append_lib( block_num );
@@ -131,6 +254,17 @@ private:
    std::map<transaction_id_type, cache_trace>                   cached_traces;
    std::optional<cache_trace>                                   onblock_trace;
 
+   const uint32_t                                               max_queued;
+   std::mutex                                                   mtx;
+   std::condition_variable                                      queue_cv;
+   uint32_t                                                     queued = 0;         // guarded by mtx
+   uint64_t                                                     next_seq = 0;       // guarded by mtx
+   uint64_t                                                     next_store_seq = 0; // guarded by mtx
+   std::map<uint64_t, store_op>                                 ready;              // guarded by mtx
+   bool                                                         storing = false;    // guarded by mtx
+   bool                                                         failed = false;     // guarded by mtx
+   std::optional<chain::named_thread_pool<struct trcext>>      thread_pool;
+
 };
 
 }}
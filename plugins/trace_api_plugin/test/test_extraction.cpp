@@ -127,8 +127,8 @@ struct extraction_test_fixture {
       extraction_test_fixture& fixture;
    };
 
-   extraction_test_fixture()
-   : extraction_impl(mock_logfile_provider_type(*this), exception_handler{} )
+   explicit extraction_test_fixture(uint32_t threads = 0)
+   : extraction_impl(mock_logfile_provider_type(*this), exception_handler{}, threads, 4 )
    {
    }
 
@@ -140,6 +140,10 @@ struct extraction_test_fixture {
       extraction_impl.signal_accepted_block(bsp->block, bsp->id);
    }
 
+   void signal_irreversible_block( uint32_t block_num ) {
+      extraction_impl.signal_irreversible_block(block_num);
+   }
+
    // fixture data and methods
    uint32_t max_lib = 0;
    std::vector<data_log_entry> data_log = {};
@@ -148,6 +152,10 @@ struct extraction_test_fixture {
    chain_extraction_impl_type<mock_logfile_provider_type> extraction_impl;
 };
 
+struct threaded_extraction_test_fixture : extraction_test_fixture {
+   threaded_extraction_test_fixture() : extraction_test_fixture(3) {}
+};
+
 
 BOOST_AUTO_TEST_SUITE(block_extraction)
 
@@ -420,4 +428,37 @@ BOOST_AUTO_TEST_SUITE(block_extraction)
       BOOST_REQUIRE_EQUAL(std::get<block_trace_v2>(data_log.at(0)), expected_block_trace);
    }
 
+   BOOST_FIXTURE_TEST_CASE(threaded_extraction_stores_in_order, threaded_extraction_test_fixture)
+   {
+      const uint32_t num_blocks = 50;
+      std::vector<chain::block_state_legacy_ptr> blocks;
+      for( uint32_t n = 1; n <= num_blocks; ++n ) {
+         // vary the number of traces so conversion of later blocks can finish first
+         std::vector<chain::packed_transaction> trxs;
+         for( uint32_t i = 0; i < (num_blocks - n) % 7 + 1; ++i ) {
+            auto act = make_transfer_action( "alice"_n, "bob"_n, "0.0001 SYS"_t, std::to_string(n * 100 + i) );
+            auto ptrx = make_packed_trx( { act } );
+            signal_applied_transaction(
+                  make_transaction_trace( ptrx.id(), n, n, chain::transaction_receipt_header::executed,
+                        { make_action_trace( n * 100 + i, act, "eosio.token"_n ) } ),
+                  std::make_shared<packed_transaction>(ptrx) );
+            trxs.emplace_back( ptrx );
+         }
+         blocks.emplace_back( make_block_state( chain::block_id_type(), n, n, "bp.one"_n, std::move(trxs) ) );
+         signal_accepted_block( blocks.back() );
+         if( n > 1 )
+            signal_irreversible_block( n - 1 );
+      }
+      extraction_impl.flush();
+
+      BOOST_REQUIRE_EQUAL(max_lib, num_blocks - 1);
+      BOOST_REQUIRE_EQUAL(data_log.size(), num_blocks);
+      for( uint32_t n = 1; n <= num_blocks; ++n ) {
+         const auto& bt = std::get<block_trace_v2>(data_log.at(n - 1));
+         BOOST_REQUIRE_EQUAL(bt.number, n);
+         BOOST_REQUIRE_EQUAL(bt.transactions.size(), blocks[n - 1]->block->transactions.size());
+         BOOST_REQUIRE_EQUAL(id_log.at(n).size(), blocks[n - 1]->block->transactions.size());
+      }
+   }
+
 BOOST_AUTO_TEST_SUITE_END()
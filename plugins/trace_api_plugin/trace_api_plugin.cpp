@@ -8,6 +8,8 @@
 #include <eosio/trace_api/configuration_utils.hpp>
 
 #include <eosio/resource_monitor_plugin/resource_monitor_plugin.hpp>
+#include <eosio/chain/async_signal_subscriber.hpp>
+#include <eosio/chain/thread_utils.hpp>
 
 #include <boost/signals2/connection.hpp>
 
@@ -351,6 +353,19 @@ struct trace_api_plugin_impl {
    explicit trace_api_plugin_impl( const std::shared_ptr<trace_api_common_impl>& common )
    :common(common) {}
 
+   static void set_program_options(appbase::options_description& cli, appbase::options_description& cfg) {
+      auto cfg_options = cfg.add_options();
+      cfg_options("trace-async-signal-queue-size", bpo::value<uint32_t>()->default_value(0),
+                  "When non-zero, traces are extracted on a dedicated thread rather than in the controller signals on the main thread, "
+                  "with up to this many signals queued. Block processing waits when the queue is full.");
+      cfg_options("trace-extraction-threads", bpo::value<uint32_t>()->default_value(2),
+                  "Number of threads converting the traces of accepted blocks. Blocks are still stored in order. "
+                  "0 converts and stores the traces in the signal handler.");
+      cfg_options("trace-extraction-max-queued-blocks", bpo::value<uint32_t>()->default_value(8),
+                  "Maximum number of blocks and irreversible block notifications awaiting conversion or storage "
+                  "before block processing waits. Only used with trace-extraction-threads.");
+   }
+
    void plugin_initialize(const appbase::variables_map& options) {
       ilog("initializing trace api plugin");
       auto log_exceptions_and_shutdown = [](const exception_with_context& e) {
@@ -358,26 +373,46 @@ struct trace_api_plugin_impl {
          app().quit();
          throw yield_exception("shutting down");
       };
-      extraction = std::make_shared<chain_extraction_t>(shared_store_provider<store_provider>(common->store), log_exceptions_and_shutdown);
+      const auto extraction_threads = options.at("trace-extraction-threads").as<uint32_t>();
+      const auto max_queued_blocks = options.at("trace-extraction-max-queued-blocks").as<uint32_t>();
+      EOS_ASSERT(max_queued_blocks > 0, chain::plugin_config_exception,
+                 "\"trace-extraction-max-queued-blocks\" must be greater than 0.");
+      extraction = std::make_shared<chain_extraction_t>(shared_store_provider<store_provider>(common->store), log_exceptions_and_shutdown,
+                                                        extraction_threads, max_queued_blocks);
 
       auto& chain = app().find_plugin<chain_plugin>()->chain();
 
+      // extraction only uses the traces and blocks passed with the signals, so it does not need to run inline
+      if (const auto queue_size = options.at("trace-async-signal-queue-size").as<uint32_t>(); queue_size > 0) {
+         // started now as the queue can fill during replay, before plugin_startup
+         signal_thread_pool.start( 1, []( const fc::exception& e ) {
+            elog( "Exception in trace api signal thread, exiting: ${e}", ("e", e.to_detail_string()) );
+            app().quit();
+         } );
+         // every block must be extracted, so block processing waits on a full queue rather than dropping
+         signal_subscriber.emplace( "trace_api", signal_thread_pool.get_executor(), queue_size,
+                                    chain::async_signal_subscriber::backpressure::block );
+      }
+      auto connect = [this](auto& signal, auto handler) {
+         return signal_subscriber ? signal_subscriber->connect(signal, std::move(handler)) : signal.connect(std::move(handler));
+      };
+
       applied_transaction_connection.emplace(
-         chain.applied_transaction.connect([this](std::tuple<const chain::transaction_trace_ptr&, const chain::packed_transaction_ptr&> t) {
+         connect(chain.applied_transaction, [this](const auto& t) {
             emit_killer([&](){
                extraction->signal_applied_transaction(std::get<0>(t), std::get<1>(t));
             });
          }));
 
       block_start_connection.emplace(
-            chain.block_start.connect([this](uint32_t block_num) {
+            connect(chain.block_start, [this](uint32_t block_num) {
                emit_killer([&](){
                   extraction->signal_block_start(block_num);
                });
             }));
 
       accepted_block_connection.emplace(
-         chain.accepted_block.connect([this](const chain::block_signal_params& t) {
+         connect(chain.accepted_block, [this](const auto& t) {
             emit_killer([&](){
                const auto& [ block, id ] = t;
                extraction->signal_accepted_block(block, id);
@@ -385,7 +420,7 @@ struct trace_api_plugin_impl {
          }));
 
       irreversible_block_connection.emplace(
-         chain.irreversible_block.connect([this](const chain::block_signal_params& t) {
+         connect(chain.irreversible_block, [this](const auto& t) {
             const auto& [ block, id ] = t;
             emit_killer([&](){
                extraction->signal_irreversible_block(block->block_num());
@@ -399,6 +434,12 @@ struct trace_api_plugin_impl {
    }
 
    void plugin_shutdown() {
+      // extract whatever is still queued, later signals are handled inline
+      if (signal_subscriber)
+         signal_subscriber->stop();
+      signal_thread_pool.stop();
+      // store the blocks still being converted before the store stops
+      extraction->flush();
       common->plugin_shutdown();
    }
 
@@ -407,6 +448,8 @@ struct trace_api_plugin_impl {
    using chain_extraction_t = chain_extraction_impl_type<shared_store_provider<store_provider>>;
    std::shared_ptr<chain_extraction_t> extraction;
 
+   chain::named_thread_pool<struct trcsig>                     signal_thread_pool;
+   std::optional<chain::async_signal_subscriber>               signal_subscriber;
    std::optional<scoped_connection>                            applied_transaction_connection;
    std::optional<scoped_connection>                            block_start_connection;
    std::optional<scoped_connection>                            accepted_block_connection;
@@ -420,6 +463,7 @@ trace_api_plugin::~trace_api_plugin() = default;
 void trace_api_plugin::set_program_options(appbase::options_description& cli, appbase::options_description& cfg) {
    trace_api_common_impl::set_program_options(cli, cfg);
    trace_api_rpc_plugin_impl::set_program_options(cli, cfg);
+   trace_api_plugin_impl::set_program_options(cli, cfg);
 }
 
 void trace_api_plugin::plugin_initialize(const appbase::variables_map& options) {
@@ -94,6 +94,10 @@ void wallet_api_plugin::plugin_startup() {
             INVOKE_R_R_R_R(wallet_mgr, sign_transaction, chain::signed_transaction, chain::flat_set<public_key_type>, chain::chain_id_type), 201),
        CALL_WITH_400(wallet, wallet_mgr, sign_digest,
             INVOKE_R_R_R(wallet_mgr, sign_digest, chain::digest_type, public_key_type), 201),
+       CALL_WITH_400(wallet, wallet_mgr, sign_transactions,
+            INVOKE_R_R_R(wallet_mgr, sign_transactions, std::vector<sign_transaction_request>, chain::chain_id_type), 201),
+       CALL_WITH_400(wallet, wallet_mgr, sign_digests,
+            INVOKE_R_R(wallet_mgr, sign_digests, std::vector<sign_digest_request>), 201),
        CALL_WITH_400(wallet, wallet_mgr, create,
             INVOKE_R_R(wallet_mgr, create, std::string), 201),
        CALL_WITH_400(wallet, wallet_mgr, open,
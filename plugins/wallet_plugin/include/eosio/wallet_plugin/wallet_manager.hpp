@@ -1,6 +1,7 @@
 #pragma once
 #include <eosio/chain/transaction.hpp>
 #include <eosio/wallet_plugin/wallet_api.hpp>
+#include <eosio/chain/thread_utils.hpp>
 #include <boost/asio/deadline_timer.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <chrono>
@@ -10,6 +11,18 @@ namespace fc { class variant; }
 namespace eosio {
 namespace wallet {
 
+/// A transaction of a wallet_manager::sign_transactions batch and the public keys to sign it with.
+struct sign_transaction_request {
+   chain::signed_transaction transaction;
+   flat_set<public_key_type> keys;
+};
+
+/// A digest of a wallet_manager::sign_digests batch and the public key to sign it with.
+struct sign_digest_request {
+   chain::digest_type digest;
+   public_key_type    key;
+};
+
 /// Provides associate of wallet name to wallet and manages the interaction with each wallet.
 ///
 /// The name of the wallet is also used as part of the file name by soft_wallet. See wallet_manager::create.
@@ -57,6 +70,26 @@ public:
    /// @throws fc::exception if corresponding private keys not found in unlocked wallets
    chain::signature_type sign_digest(const chain::digest_type& digest, const public_key_type& key);
 
+   /// Start threads used to sign the batches of sign_transactions and sign_digests in parallel.
+   /// Without them, or when an unlocked wallet does not support concurrent signing, batches are signed on the
+   /// calling thread.
+   /// @param num_threads number of signing threads, 0 for none.
+   void set_signing_threads(uint32_t num_threads);
+
+   /// Sign a batch of transactions, each with the private keys specified via its public keys.
+   /// @param requests the transactions to sign and the public keys of the private keys to sign each with
+   /// @param id the chain_id to sign the transactions with.
+   /// @return the transactions signed, in the order of requests
+   /// @throws fc::exception if any corresponding private key is not found in unlocked wallets, nothing is returned then
+   std::vector<chain::signed_transaction> sign_transactions(const std::vector<sign_transaction_request>& requests,
+                                                            const chain::chain_id_type& id);
+
+   /// Sign a batch of digests, each with the private key specified via its public key.
+   /// @param requests the digests to sign and the public key of the private key to sign each with
+   /// @return signatures over the digests, in the order of requests
+   /// @throws fc::exception if any corresponding private key is not found in unlocked wallets
+   std::vector<chain::signature_type> sign_digests(const std::vector<sign_digest_request>& requests);
+
    /// Create a new wallet.
    /// A new wallet is created in file dir/{name}.wallet see set_dir.
    /// The new wallet is unlocked after creation.
@@ -129,6 +162,14 @@ private:
    /// Calls lock_all() if timeout has passed.
    void check_timeout();
 
+   /// Sign with the first unlocked wallet holding key.
+   /// @throws wallet_missing_pub_key_exception if none does
+   chain::signature_type sign_with_unlocked(const chain::digest_type& digest, const public_key_type& key);
+
+   /// Call f(i) for i in [0, n), on the signing threads if every unlocked wallet supports concurrent signing.
+   /// Wallets are not modified meanwhile as the calling thread waits for all calls to complete.
+   void for_each_signing(size_t n, const std::function<void(size_t)>& f);
+
 private:
    using timepoint_t = std::chrono::time_point<std::chrono::system_clock>;
    std::map<std::string, std::unique_ptr<wallet_api>> wallets;
@@ -137,6 +178,8 @@ private:
    std::filesystem::path dir = ".";
    std::filesystem::path lock_path = dir / "wallet.lock";
    std::unique_ptr<boost::interprocess::file_lock> wallet_dir_lock;
+   uint32_t signing_threads = 0;
+   std::optional<chain::named_thread_pool<struct wltsig>> signing_thread_pool;
 
    void start_lock_watch(std::shared_ptr<boost::asio::deadline_timer> t);
    void initialize_lock();
@@ -144,3 +187,6 @@ private:
 
 } // namespace wallet
 } // namespace eosio
+
+FC_REFLECT(eosio::wallet::sign_transaction_request, (transaction)(keys))
+FC_REFLECT(eosio::wallet::sign_digest_request, (digest)(key))
@@ -4,6 +4,9 @@
 #include <eosio/wallet_plugin/se_wallet.hpp>
 #include <eosio/chain/exceptions.hpp>
 #include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <future>
 namespace eosio {
 namespace wallet {
 
@@ -228,21 +231,9 @@ wallet_manager::sign_transaction(const chain::signed_transaction& txn, const fla
    check_timeout();
    chain::signed_transaction stxn(txn);
 
+   const auto digest = stxn.sig_digest(id, stxn.context_free_data);
    for (const auto& pk : keys) {
-      bool found = false;
-      for (const auto& i : wallets) {
-         if (!i.second->is_locked()) {
-            std::optional<signature_type> sig = i.second->try_sign_digest(stxn.sig_digest(id, stxn.context_free_data), pk);
-            if (sig) {
-               stxn.signatures.push_back(*sig);
-               found = true;
-               break; // inner for
-            }
-         }
-      }
-      if (!found) {
-         EOS_THROW(chain::wallet_missing_pub_key_exception, "Public key not found in unlocked wallets ${k}", ("k", pk));
-      }
+      stxn.signatures.push_back(sign_with_unlocked(digest, pk));
    }
 
    return stxn;
@@ -265,6 +256,85 @@ wallet_manager::sign_digest(const chain::digest_type& digest, const public_key_t
    EOS_THROW(chain::wallet_missing_pub_key_exception, "Public key not found in unlocked wallets ${k}", ("k", key));
 }
 
+void wallet_manager::set_signing_threads(uint32_t num_threads) {
+   signing_thread_pool.reset();
+   signing_threads = num_threads;
+   if (num_threads > 0) {
+      signing_thread_pool.emplace();
+      signing_thread_pool->start(num_threads, [](const fc::exception& e) {
+         elog("Exception in wallet signing thread: ${e}", ("e", e.to_detail_string()));
+      });
+   }
+}
+
+std::vector<chain::signed_transaction>
+wallet_manager::sign_transactions(const std::vector<sign_transaction_request>& requests, const chain::chain_id_type& id) {
+   check_timeout();
+
+   std::vector<chain::signed_transaction> result(requests.size());
+   for_each_signing(requests.size(), [&](size_t i) {
+      const auto& r = requests[i];
+      result[i] = r.transaction;
+      const auto digest = result[i].sig_digest(id, result[i].context_free_data);
+      for (const auto& pk : r.keys) {
+         result[i].signatures.push_back(sign_with_unlocked(digest, pk));
+      }
+   });
+   return result;
+}
+
+std::vector<chain::signature_type>
+wallet_manager::sign_digests(const std::vector<sign_digest_request>& requests) {
+   check_timeout();
+
+   std::vector<chain::signature_type> result(requests.size());
+   for_each_signing(requests.size(), [&](size_t i) {
+      result[i] = sign_with_unlocked(requests[i].digest, requests[i].key);
+   });
+   return result;
+}
+
+chain::signature_type
+wallet_manager::sign_with_unlocked(const chain::digest_type& digest, const public_key_type& key) {
+   for (const auto& i : wallets) {
+      if (!i.second->is_locked()) {
+         std::optional<signature_type> sig = i.second->try_sign_digest(digest, key);
+         if (sig)
+            return *sig;
+      }
+   }
+   EOS_THROW(chain::wallet_missing_pub_key_exception, "Public key not found in unlocked wallets ${k}", ("k", key));
+}
+
+void wallet_manager::for_each_signing(size_t n, const std::function<void(size_t)>& f) {
+   const bool concurrent = signing_thread_pool && n > 1 &&
+         std::all_of(wallets.begin(), wallets.end(), [](const auto& i) {
+            return i.second->is_locked() || i.second->supports_concurrent_signing();
+         });
+   if (!concurrent) {
+      for (size_t i = 0; i < n; ++i)
+         f(i);
+      return;
+   }
+
+   // contiguous ranges, a few per thread so that uneven key counts even out
+   const size_t num_tasks = std::min<size_t>(n, 4 * signing_threads);
+   std::vector<std::future<void>> futures;
+   futures.reserve(num_tasks);
+   for (size_t t = 0; t < num_tasks; ++t) {
+      const size_t begin = n * t / num_tasks, end = n * (t + 1) / num_tasks;
+      futures.emplace_back(chain::post_async_task(signing_thread_pool->get_executor(), [&f, begin, end]() {
+         for (size_t i = begin; i < end; ++i)
+            f(i);
+      }));
+   }
+   // wait for every task before rethrowing, they reference f and the wallets
+   for (auto& fut : futures)
+      fut.wait();
+   for (auto& fut : futures)
+      fut.get();
+}
+
 void wallet_manager::own_and_use_wallet(const string& name, std::unique_ptr<wallet_api>&& wallet) {
    if(wallets.find(name) != wallets.end())
       EOS_THROW(wallet_exception, "Tried to use wallet name that already exists.");
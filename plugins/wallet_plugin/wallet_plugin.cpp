@@ -25,6 +25,9 @@ void wallet_plugin::set_program_options(options_description& cli, options_descri
           "Timeout for unlocked wallet in seconds (default 900 (15 minutes)). "
           "Wallets will automatically lock after specified number of seconds of inactivity. "
           "Activity is defined as any wallet command e.g. list-wallets.")
+         ("wallet-signing-threads", bpo::value<uint32_t>()->default_value(2),
+          "Number of threads signing the batches of /v1/wallet/sign_transactions and /v1/wallet/sign_digests in parallel. "
+          "0 signs them on the main thread.")
          ;
 }
 
@@ -47,6 +50,7 @@ void wallet_plugin::plugin_initialize(const variables_map& options) {
          std::chrono::seconds t(timeout);
          wallet_manager_ptr->set_timeout(t);
       }
+      wallet_manager_ptr->set_signing_threads(options.at("wallet-signing-threads").as<uint32_t>());
    } FC_LOG_AND_RETHROW()
 }
 
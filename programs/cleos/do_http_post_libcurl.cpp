@@ -70,15 +70,11 @@ namespace eosio { namespace client { namespace http {
                                                       const std::string& postjson, bool verify_cert, bool verbose,
                                                       bool trace) {
 
-      static bool initialized = false;
+      static const CURLcode init_res = curl_global_init(CURL_GLOBAL_DEFAULT);
+      EOS_ASSERT(init_res == CURLE_OK, chain::http_exception, curl_easy_strerror(init_res));
 
-      if (!initialized) {
-         auto res = curl_global_init(CURL_GLOBAL_DEFAULT);
-         EOS_ASSERT(res == CURLE_OK, chain::http_exception, curl_easy_strerror(res));
-         initialized = true;
-      }
-
-      static std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> handle(nullptr, &curl_easy_cleanup);
+      // one handle, and so one kept alive connection, per thread requesting concurrently
+      thread_local std::unique_ptr<CURL, decltype(&curl_easy_cleanup)> handle(nullptr, &curl_easy_cleanup);
       if (!handle) handle.reset(curl_easy_init());
       auto curl = handle.get();
       EOS_ASSERT(curl != 0, chain::http_exception, "curl_easy_init failed");
@@ -127,6 +123,8 @@ namespace eosio { namespace client { namespace http {
          curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
 
       auto res = curl_easy_perform(curl);
+      curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+      curl_slist_free_all(list);
       if (res == CURLE_COULDNT_CONNECT || res == CURLE_URL_MALFORMAT)
          EOS_THROW(connection_exception, curl_easy_strerror(res));
       EOS_ASSERT(res == CURLE_OK, chain::http_exception, curl_easy_strerror(res));
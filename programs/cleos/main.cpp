@@ -71,6 +71,9 @@ Options:
 #include <iostream>
 #include <locale>
 #include <unordered_map>
+#include <atomic>
+#include <future>
+#include <mutex>
 #include <fc/crypto/hex.hpp>
 #include <fc/variant.hpp>
 #include <fc/io/datastream.hpp>
@@ -96,6 +99,8 @@ Options:
 #include <boost/process/spawn.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/range/algorithm/copy.hpp>
 #define BOOST_DLL_USE_STD_FS
 #include <boost/dll/runtime_symbol_info.hpp>
@@ -382,6 +387,73 @@ auto abi_serializer_resolver_empty = [](const name& account) -> std::optional<ab
    return std::optional<abi_serializer>();
 };
 
+// parses a primary key or scope bound like the node's convert_to_type<uint64_t>: a number, a name, a symbol such
+// as 4,EOS or a symbol code such as EOS. Only a primary key of key_type name is not tried as a number.
+uint64_t parse_key_bound( const string& bound, const string& key_type = {} ) {
+   uint64_t v = 0;
+   if( key_type != "name" && boost::conversion::try_lexical_convert( bound, v ) )
+      return v;
+   try {
+      return name( boost::algorithm::trim_copy( bound ) ).to_uint64_t();
+   } catch( ... ) {}
+   if( bound.find( ',' ) != string::npos ) {
+      try {
+         return symbol::from_string( bound ).value();
+      } catch( ... ) {}
+   }
+   try {
+      return string_to_symbol( 0, bound.c_str() ) >> 8;
+   } catch( ... ) {}
+   EOSC_ASSERT( false, "ERROR: Could not convert bound '${b}' to a number, name, symbol or symbol code", ("b", bound) );
+   return 0;
+}
+
+// split the keys [lower, upper] into up to n contiguous ranges of about the same width
+std::vector<std::pair<uint64_t, uint64_t>> split_key_range( uint64_t lower, uint64_t upper, uint32_t n ) {
+   std::vector<std::pair<uint64_t, uint64_t>> ranges;
+   const unsigned __int128 count = (unsigned __int128)upper - lower + 1;
+   unsigned __int128 begin = lower;
+   for( uint32_t i = 1; i <= n; ++i ) {
+      const unsigned __int128 end = lower + count * i / n; // exclusive
+      if( end > begin )
+         ranges.emplace_back( (uint64_t)begin, (uint64_t)(end - 1) );
+      begin = end;
+   }
+   return ranges;
+}
+
+// at most this many ranges are fetched at the same time, whatever --parallel asks for
+constexpr size_t max_parallel_fetches = 16;
+
+// Page through the ranges on up to max_parallel_fetches threads, each taking the next range once done with its own.
+// fetch_page(range, lower, upper) fetches the page starting at lower, hands its rows over and returns the key to
+// continue from, if any. The first failure is rethrown once all threads stopped.
+void fetch_key_ranges( const std::vector<std::pair<uint64_t, uint64_t>>& ranges,
+                       const std::function<std::optional<uint64_t>(size_t, uint64_t, uint64_t)>& fetch_page ) {
+   std::atomic<bool> failed = false;
+   std::atomic<size_t> next_range = 0;
+   std::vector<std::future<void>> fetches;
+   const size_t workers = std::min( ranges.size(), max_parallel_fetches );
+   for( size_t w = 0; w < workers; ++w ) {
+      fetches.emplace_back( std::async( std::launch::async, [&]() {
+         try {
+            for( size_t i = next_range++; i < ranges.size() && !failed; i = next_range++ ) {
+               std::optional<uint64_t> lower = ranges[i].first;
+               while( lower && !failed )
+                  lower = fetch_page( i, *lower, ranges[i].second );
+            }
+         } catch( ... ) {
+            failed = true;
+            throw;
+         }
+      } ) );
+   }
+   for( auto& f : fetches )
+      f.wait();
+   for( auto& f : fetches )
+      f.get();
+}
+
 void prompt_for_wallet_password(string& pw, const string& name) {
    if(pw.size() == 0 && name != "SecureEnclave") {
       std::cout << localized("password: ");
@@ -3146,6 +3218,9 @@ int main( int argc, char** argv ) {
    string index_position;
    bool reverse = false;
    bool show_payer = false;
+   uint32_t parallel = 0;
+   bool ndjson = false;
+   bool decode_locally = false;
    auto getTable = get->add_subcommand( "table", localized("Retrieve the contents of a database table"));
    getTable->add_option( "account", code, localized("The account who owns the table") )->required();
    getTable->add_option( "scope", scope, localized("The scope within the contract in which the table is found") )->required();
@@ -3167,11 +3242,37 @@ int main( int argc, char** argv ) {
    getTable->add_flag("-b,--binary", binary, localized("Return the value as BINARY rather than using abi to interpret as JSON"));
    getTable->add_flag("-r,--reverse", reverse, localized("Iterate in reverse order"));
    getTable->add_flag("--show-payer", show_payer, localized("Show RAM payer"));
-
+   getTable->add_option("--parallel", parallel,
+                        localized("Retrieve all rows between the bounds, splitting the primary keys into this many ranges requested concurrently "
+                                  "(at most 16 at a time), --limit rows at a time"));
+   getTable->add_flag("--ndjson", ndjson,
+                      localized("Retrieve all rows between the bounds and print them as they arrive, one JSON row per line"));
+   getTable->add_flag("--decode-locally", decode_locally,
+                      localized("Request the rows as BINARY and use the abi to interpret them as JSON here rather than on the node"));
 
    getTable->callback([&] {
+      EOSC_ASSERT( !(binary && decode_locally), "ERROR: --binary and --decode-locally are mutually exclusive" );
+      std::optional<abi_serializer> abis;
+      type_name table_type;
+      if( decode_locally ) {
+         abis = abi_serializer_resolver( name(code) );
+         EOSC_ASSERT( abis.has_value(), "ERROR: ABI for contract ${c} not found", ("c", code) );
+         table_type = abis->get_table_type( name(table) );
+      }
+      auto decode_row = [&]( fc::variant& row ) {
+         if( !abis )
+            return;
+         if( show_payer ) {
+            fc::mutable_variant_object o( row.get_object() );
+            o["data"] = abis->binary_to_variant( table_type, o["data"].as<bytes>(), abi_serializer_max_time );
+            row = std::move( o );
+         } else {
+            row = abis->binary_to_variant( table_type, row.as<bytes>(), abi_serializer_max_time );
+         }
+      };
+
       fc::mutable_variant_object mo;
-      mo( "json", !binary )
+      mo( "json", !binary && !decode_locally )
         ( "code", code )
         ( "scope", scope )
         ( "table", table )
@@ -3185,10 +3286,78 @@ int main( int argc, char** argv ) {
         ( "reverse", reverse )
         ( "show_payer", show_payer );
       if( time_limit_ms != 0 ) mo( "time_limit_ms", time_limit_ms );
-      auto result = call( get_table_func, mo );
 
-      std::cout << fc::json::to_pretty_string(result)
-                << std::endl;
+      if( parallel == 0 && !ndjson ) {
+         auto result = call( get_table_func, mo );
+         if( abis ) {
+            auto res = result.as<eosio::chain_apis::read_only::get_table_rows_result>();
+            for( auto& row : res.rows )
+               decode_row( row );
+            result = fc::variant( res );
+         }
+
+         std::cout << fc::json::to_pretty_string(result)
+                   << std::endl;
+         return;
+      }
+
+      EOSC_ASSERT( index_position.empty() || index_position == "1" || index_position == "primary" || index_position == "first",
+                   "ERROR: --parallel and --ndjson only support the primary index" );
+      EOSC_ASSERT( !reverse, "ERROR: --parallel and --ndjson can not be used with --reverse" );
+      EOSC_ASSERT( limit > 0, "ERROR: --limit must be greater than 0" );
+
+      // primary keys are requested as numbers, next_key is then a number as well
+      mo( "key_type", "i64" )
+        ( "lower_bound", std::to_string( lower.empty() ? 0 : parse_key_bound( lower, key_type ) ) )
+        ( "upper_bound", std::to_string( upper.empty() ? std::numeric_limits<uint64_t>::max() : parse_key_bound( upper, key_type ) ) );
+
+      // with a limit of 0 next_key is the first row, from the end when reversed. Splitting the keys actually present
+      // rather than the bounds keeps the ranges even for small numeric keys.
+      auto find_key = [&]( bool last ) -> std::optional<uint64_t> {
+         auto m = mo;
+         m( "limit", 0 )( "reverse", last );
+         auto res = call( get_table_func, m ).as<eosio::chain_apis::read_only::get_table_rows_result>();
+         if( !res.more )
+            return {};
+         return parse_key_bound( res.next_key, "i64" );
+      };
+      eosio::chain_apis::read_only::get_table_rows_result all;
+      const auto first = find_key( false );
+      const auto last = first ? find_key( true ) : std::nullopt;
+      if( first && last ) {
+         const auto ranges = split_key_range( *first, *last, std::max( parallel, 1u ) );
+         std::vector<std::vector<fc::variant>> range_rows( ranges.size() );
+         std::mutex out_mtx;
+         fetch_key_ranges( ranges, [&]( size_t i, uint64_t lo, uint64_t hi ) -> std::optional<uint64_t> {
+            auto m = mo;
+            m( "lower_bound", std::to_string( lo ) )( "upper_bound", std::to_string( hi ) );
+            auto res = call( get_table_func, m ).as<eosio::chain_apis::read_only::get_table_rows_result>();
+            for( auto& row : res.rows )
+               decode_row( row );
+            if( ndjson ) {
+               std::string out;
+               for( const auto& row : res.rows ) {
+                  out += fc::json::to_string( row, fc::time_point::maximum() );
+                  out += '\n';
+               }
+               std::lock_guard g( out_mtx );
+               std::cout << out << std::flush;
+            } else {
+               // only appended to by the thread of range i
+               std::move( res.rows.begin(), res.rows.end(), std::back_inserter( range_rows[i] ) );
+            }
+            if( !res.more )
+               return {};
+            return parse_key_bound( res.next_key, "i64" );
+         } );
+         for( auto& rows : range_rows )
+            std::move( rows.begin(), rows.end(), std::back_inserter( all.rows ) );
+      }
+
+      if( !ndjson ) {
+         std::cout << fc::json::to_pretty_string(all)
+                   << std::endl;
+      }
    });
 
    auto getScope = get->add_subcommand( "scope", localized("Retrieve a list of scopes and tables owned by a contract"));
@@ -3199,6 +3368,11 @@ int main( int argc, char** argv ) {
    getScope->add_option( "-L,--lower", lower, localized("Lower bound of scope") );
    getScope->add_option( "-U,--upper", upper, localized("Upper bound of scope") );
    getScope->add_flag("-r,--reverse", reverse, localized("Iterate in reverse order"));
+   getScope->add_option("--parallel", parallel,
+                        localized("Retrieve all scopes between the bounds, splitting them into this many ranges requested concurrently "
+                                  "(at most 16 at a time), --limit rows at a time"));
+   getScope->add_flag("--ndjson", ndjson,
+                      localized("Retrieve all scopes between the bounds and print them as they arrive, one JSON row per line"));
    getScope->callback([&] {
       fc::mutable_variant_object mo;
       mo( "code", code )
@@ -3208,10 +3382,83 @@ int main( int argc, char** argv ) {
         ( "limit", limit )
         ( "reverse", reverse );
       if( time_limit_ms != 0 ) mo( "time_limit_ms", time_limit_ms );
-      auto result = call( get_table_by_scope_func, mo );
 
-      std::cout << fc::json::to_pretty_string(result)
-                << std::endl;
+      if( parallel == 0 && !ndjson ) {
+         auto result = call( get_table_by_scope_func, mo );
+
+         std::cout << fc::json::to_pretty_string(result)
+                   << std::endl;
+         return;
+      }
+
+      EOSC_ASSERT( !reverse, "ERROR: --parallel and --ndjson can not be used with --reverse" );
+      EOSC_ASSERT( limit > 0, "ERROR: --limit must be greater than 0" );
+
+      using scope_row = eosio::chain_apis::read_only::get_table_by_scope_result_row;
+      using scope_result = eosio::chain_apis::read_only::get_table_by_scope_result;
+      // scopes are requested as numbers, parsed number first as the node does, so -L 5 means the same as without
+      // --parallel or --ndjson
+      mo( "lower_bound", std::to_string( lower.empty() ? 0 : parse_key_bound( lower ) ) )
+        ( "upper_bound", std::to_string( upper.empty() ? std::numeric_limits<uint64_t>::max() : parse_key_bound( upper ) ) );
+
+      // with a limit of 0 more is the first scope, from the end when reversed
+      auto find_scope = [&]( bool last ) -> std::optional<uint64_t> {
+         auto m = mo;
+         m( "limit", 0 )( "reverse", last );
+         auto res = call( get_table_by_scope_func, m ).as<scope_result>();
+         if( res.more.empty() )
+            return {};
+         return name( res.more ).to_uint64_t();
+      };
+      scope_result all;
+      const auto first = find_scope( false );
+      const auto last = first ? find_scope( true ) : std::nullopt;
+      if( first && last ) {
+         const auto ranges = split_key_range( *first, *last, std::max( parallel, 1u ) );
+         std::vector<std::vector<scope_row>> range_rows( ranges.size() );
+         // more is the scope of the next table, which can be the scope of the last row returned
+         std::vector<std::optional<std::pair<name, name>>> range_last( ranges.size() );
+         std::vector<uint32_t> range_limit( ranges.size(), limit );
+         std::mutex out_mtx;
+         fetch_key_ranges( ranges, [&]( size_t i, uint64_t lo, uint64_t hi ) -> std::optional<uint64_t> {
+            auto m = mo;
+            m( "lower_bound", std::to_string( lo ) )( "upper_bound", std::to_string( hi ) )( "limit", range_limit[i] );
+            auto res = call( get_table_by_scope_func, m ).as<scope_result>();
+            std::vector<scope_row> rows;
+            for( auto& row : res.rows ) {
+               const auto key = std::make_pair( row.scope, row.table );
+               if( range_last[i] && key <= *range_last[i] )
+                  continue;
+               range_last[i] = key;
+               rows.emplace_back( std::move( row ) );
+            }
+            if( ndjson ) {
+               std::string out;
+               for( const auto& row : rows ) {
+                  out += fc::json::to_string( row, fc::time_point::maximum() );
+                  out += '\n';
+               }
+               std::lock_guard g( out_mtx );
+               std::cout << out << std::flush;
+            } else {
+               std::move( rows.begin(), rows.end(), std::back_inserter( range_rows[i] ) );
+            }
+            if( res.more.empty() )
+               return {};
+            const uint64_t next = name( res.more ).to_uint64_t();
+            // a page within a single scope, ask for more of its tables at once
+            if( next == lo )
+               range_limit[i] *= 2;
+            return next;
+         } );
+         for( auto& rows : range_rows )
+            std::move( rows.begin(), rows.end(), std::back_inserter( all.rows ) );
+      }
+
+      if( !ndjson ) {
+         std::cout << fc::json::to_pretty_string(all)
+                   << std::endl;
+      }
    });
 
    // currency accessors
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <fc/variant_object.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <vector>
+
+namespace eosio::testing {
+
+   // Log-linear (HDR style) histogram of non-negative integer values, e.g. latencies in microseconds.
+   // Values below 2^sub_bucket_bits are counted exactly; above that every power of two is split into
+   // 2^(sub_bucket_bits-1) equal buckets, so any recorded value is reported within 1/2^(sub_bucket_bits-1)
+   // of its true value while memory stays logarithmic in the largest value recorded.
+   class latency_histogram {
+    public:
+      explicit latency_histogram(uint8_t sub_bucket_bits = 7)
+         : _sub_bucket_bits(std::clamp<uint8_t>(sub_bucket_bits, 2, 16)) {}
+
+      void record(int64_t value, uint64_t count = 1) {
+         value = std::max<int64_t>(value, 0);
+         const size_t index = index_of(value);
+         if (index >= _counts.size())
+            _counts.resize(index + 1);
+         _counts[index] += count;
+         _total += count;
+         _sum += static_cast<double>(value) * count;
+         _min = std::min(_min, value);
+         _max = std::max(_max, value);
+      }
+
+      void merge(const latency_histogram& other) {
+         if (other._sub_bucket_bits != _sub_bucket_bits) {
+            // different resolution, re-record at bucket values
+            for (size_t i = 0; i < other._counts.size(); ++i)
+               if (other._counts[i])
+                  record(other.highest_equivalent_value(i), other._counts[i]);
+            return;
+         }
+         if (other._counts.size() > _counts.size())
+            _counts.resize(other._counts.size());
+         for (size_t i = 0; i < other._counts.size(); ++i)
+            _counts[i] += other._counts[i];
+         _total += other._total;
+         _sum += other._sum;
+         _min = std::min(_min, other._min);
+         _max = std::max(_max, other._max);
+      }
+
+      uint64_t count() const { return _total; }
+      int64_t  min() const { return _total ? _min : 0; }
+      int64_t  max() const { return _total ? _max : 0; }
+      double   mean() const { return _total ? _sum / _total : 0.0; }
+
+      // smallest recorded value v such that percentile% of recorded values are <= v (reported at bucket resolution)
+      int64_t value_at_percentile(double percentile) const {
+         if (_total == 0)
+            return 0;
+         percentile = std::clamp(percentile, 0.0, 100.0);
+         const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * _total)));
+         uint64_t cumulative = 0;
+         for (size_t i = 0; i < _counts.size(); ++i) {
+            cumulative += _counts[i];
+            if (cumulative >= target)
+               return std::min(highest_equivalent_value(i), _max);
+         }
+         return _max;
+      }
+
+      fc::mutable_variant_object to_variant() const {
+         return fc::mutable_variant_object()
+            ("count", _total)
+            ("min", min())
+            ("mean", mean())
+            ("p50", value_at_percentile(50.0))
+            ("p90", value_at_percentile(90.0))
+            ("p99", value_at_percentile(99.0))
+            ("p99_9", value_at_percentile(99.9))
+            ("p99_99", value_at_percentile(99.99))
+            ("max", max());
+      }
+
+    private:
+      size_t index_of(int64_t value) const {
+         const uint64_t v = static_cast<uint64_t>(value);
+         if (v < (uint64_t(1) << _sub_bucket_bits))
+            return v;
+         const uint32_t half  = 1u << (_sub_bucket_bits - 1);
+         const int      shift = (63 - __builtin_clzll(v)) - (_sub_bucket_bits - 1);
+         return (size_t(1) << _sub_bucket_bits) + size_t(shift - 1) * half + ((v >> shift) - half);
+      }
+
+      int64_t highest_equivalent_value(size_t index) const {
+         const size_t exact = size_t(1) << _sub_bucket_bits;
+         if (index < exact)
+            return index;
+         const uint32_t half  = 1u << (_sub_bucket_bits - 1);
+         const size_t   shift = (index - exact) / half + 1;
+         const uint64_t lower = (uint64_t(half) + (index - exact) % half) << shift;
+         return static_cast<int64_t>(lower + (uint64_t(1) << shift) - 1);
+      }
+
+      uint8_t               _sub_bucket_bits;
+      std::vector<uint64_t> _counts;
+      uint64_t              _total = 0;
+      double                _sum   = 0.0;
+      int64_t               _min   = std::numeric_limits<int64_t>::max();
+      int64_t               _max   = 0;
+   };
+
+   // One histogram overall plus one per elapsed second of the test, for percentile time series.
+   struct latency_time_series {
+      static constexpr uint8_t per_second_sub_bucket_bits = 5;
+
+      latency_histogram                    _overall;
+      std::map<int64_t, latency_histogram> _per_second;
+
+      void record(int64_t second, int64_t value) {
+         _overall.record(value);
+         _per_second.try_emplace(second, per_second_sub_bucket_bits).first->second.record(value);
+      }
+
+      fc::mutable_variant_object to_variant() const {
+         fc::variants series;
+         series.reserve(_per_second.size());
+         for (const auto& [second, hist] : _per_second) {
+            series.emplace_back(fc::mutable_variant_object()
+                                   ("second", second)
+                                   ("count", hist.count())
+                                   ("p50", hist.value_at_percentile(50.0))
+                                   ("p99", hist.value_at_percentile(99.0))
+                                   ("p99_9", hist.value_at_percentile(99.9))
+                                   ("max", hist.max()));
+         }
+         return fc::mutable_variant_object()("overall", _overall.to_variant())("per_second", std::move(series));
+      }
+   };
+}
@@ -66,6 +66,10 @@ int main(int argc, char** argv) {
          ("peer-endpoint-type", bpo::value<std::string>(&provider_config._peer_endpoint_type)->default_value("p2p"), "Identify the peer endpoint api type to determine how to send transactions. Allowable 'p2p' and 'http'. Default: 'p2p'")
          ("peer-endpoint", bpo::value<std::string>(&provider_config._peer_endpoint)->default_value("127.0.0.1"), "set the peer endpoint to send transactions to")
          ("port", bpo::value<uint16_t>(&provider_config._port)->default_value(9876), "set the peer endpoint port to send transactions to")
+         ("peer-connections", bpo::value<uint16_t>(&provider_config._num_connections)->default_value(1), "Number of connections to open to the peer endpoint. Transactions are sent round robin across them. Defaults to 1.")
+         ("confirmations-endpoint", bpo::value<std::string>(&provider_config._confirmations_endpoint)->default_value("127.0.0.1"), "Node whose chain api is followed to measure time to block inclusion and to irreversibility of sent transactions.")
+         ("confirmations-port", bpo::value<uint16_t>(&provider_config._confirmations_port)->default_value(0), "Http port of the confirmations-endpoint. 0 disables following blocks. Defaults to 0.")
+         ("sign-threads", bpo::value<uint16_t>(&trx_gen_base_config._num_sign_threads)->default_value(0), "Number of threads signing transactions ahead of sending. 0 signs each transaction on the sending thread. Defaults to 0.")
          ("help,h", "print this list")
          ;
 
@@ -175,6 +179,12 @@ int main(int argc, char** argv) {
          return INITIALIZE_FAIL;
       }
 
+      if(provider_config._num_connections < 1) {
+         ilog("Initialization error: peer-connections must be at least 1");
+         cli.print(std::cerr);
+         return INITIALIZE_FAIL;
+      }
+
       if (!(provider_config._peer_endpoint_type == "p2p" || provider_config._peer_endpoint_type == "http")) {
          ilog("Initialization error: peer-endpoint-type must be either 'p2p', or 'http'");
          cli.print(std::cerr);
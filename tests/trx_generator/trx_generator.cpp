@@ -1,6 +1,7 @@
 #include <trx_generator.hpp>
 #include <iostream>
 #include <fc/log/logger.hpp>
+#include <fc/log/logger_config.hpp>
 #include <boost/algorithm/string.hpp>
 #include <eosio/chain/chain_id_type.hpp>
 #include <boost/program_options.hpp>
@@ -90,6 +91,10 @@ namespace eosio::testing {
    trx_generator_base::trx_generator_base(const trx_generator_base_config& trx_gen_base_config, const provider_base_config& provider_config)
        : _config(trx_gen_base_config), _provider(provider_config) {}
 
+   trx_generator_base::~trx_generator_base() {
+      stop_presigners();
+   }
+
    transfer_trx_generator::transfer_trx_generator(const trx_generator_base_config& trx_gen_base_config, const provider_base_config& provider_config,
                                                   const accounts_config& accts_config)
        : trx_generator_base(trx_gen_base_config, provider_config), _accts_config(accts_config) {}
@@ -114,6 +119,7 @@ namespace eosio::testing {
       ilog("Update each trx to qualify as unique and fresh timestamps, re-sign trx, and send each updated transactions via p2p transaction provider");
 
       _provider.setup();
+      start_presigners();
       return true;
    }
 
@@ -181,7 +187,10 @@ namespace eosio::testing {
    void trx_generator::update_resign_transaction(chain::signed_transaction& trx, const fc::crypto::private_key& priv_key, uint64_t& nonce_prefix, uint64_t& nonce,
                                                  const fc::microseconds& trx_expiration, const chain::chain_id_type& chain_id, const chain::block_id_type& last_irr_block_id) {
       trx.actions.clear();
-      trx.actions = generate_actions();
+      {
+         std::lock_guard<std::mutex> g(_generate_actions_mtx);
+         trx.actions = generate_actions();
+      }
       trx_generator_base::update_resign_transaction(trx, priv_key, nonce_prefix, nonce, trx_expiration, chain_id, last_irr_block_id);
    }
 
@@ -282,10 +291,12 @@ namespace eosio::testing {
            " re-sign trx, and send each updated transactions via p2p transaction provider");
 
       _provider.setup();
+      start_presigners();
       return true;
    }
 
    bool trx_generator_base::tear_down() {
+      stop_presigners();
       _provider.teardown();
       _provider.log_trxs(_config._log_dir);
 
@@ -298,12 +309,23 @@ namespace eosio::testing {
       return true;
    }
 
-   bool trx_generator_base::generate_and_send() {
+   bool trx_generator_base::generate_and_send(const fc::time_point& scheduled_time) {
       try {
-         if (_trxs.size()) {
+         if (!_presigners.empty()) {
+            chain::packed_transaction_ptr trx = next_presigned_trx();
+            if (!trx) {
+               elog("presigners stopped");
+               return false;
+            }
+            if (_txcount == 0) {
+               log_first_trx(_config._log_dir, trx->get_signed_transaction());
+            }
+            _provider.send(*trx, scheduled_time);
+            ++_txcount;
+         } else if (_trxs.size()) {
             size_t index_to_send = _txcount % _trxs.size();
             push_transaction(_trxs.at(index_to_send), ++_nonce_prefix, _nonce, _config._trx_expiration_us, _config._chain_id,
-                             _config._last_irr_block_id);
+                             _config._last_irr_block_id, scheduled_time);
             ++_txcount;
          } else {
             elog("no transactions available to send");
@@ -330,12 +352,108 @@ namespace eosio::testing {
    }
 
    void trx_generator_base::push_transaction(signed_transaction_w_signer& trx, uint64_t& nonce_prefix, uint64_t& nonce,
-                                             const fc::microseconds& trx_expiration, const chain::chain_id_type& chain_id, const chain::block_id_type& last_irr_block_id) {
+                                             const fc::microseconds& trx_expiration, const chain::chain_id_type& chain_id, const chain::block_id_type& last_irr_block_id,
+                                             const fc::time_point& scheduled_time) {
       update_resign_transaction(trx._trx, trx._signer, ++nonce_prefix, nonce, trx_expiration, chain_id, last_irr_block_id);
       if (_txcount == 0) {
          log_first_trx(_config._log_dir, trx._trx);
       }
-      _provider.send(trx._trx);
+      _provider.send(trx._trx, scheduled_time);
+   }
+
+   void trx_generator_base::start_presigners() {
+      if (_config._num_sign_threads == 0 || _trxs.empty()) {
+         return;
+      }
+      stop_presigners();
+
+      const size_t num_signers = _config._num_sign_threads;
+      ilog("Starting ${n} transaction presigning threads", ("n", num_signers));
+      _presigners.reserve(num_signers);
+      for (size_t i = 0; i < num_signers; ++i) {
+         auto signer = std::make_unique<trx_presigner>();
+         // signers own disjoint copies of the transactions so they can re-sign without coordination; with fewer
+         // transactions than signers the same transaction is shared out and made unique by the nonce prefix
+         for (size_t t = i; t < _trxs.size(); t += num_signers) {
+            signer->_trxs.push_back(_trxs[t]);
+         }
+         if (signer->_trxs.empty()) {
+            signer->_trxs.push_back(_trxs[i % _trxs.size()]);
+         }
+         // each signer advances its nonce prefix by num_signers from a distinct start, keeping nonces unique across signers
+         signer->_nonce_prefix = _nonce_prefix + i;
+         signer->_nonce = _nonce;
+         _presigners.push_back(std::move(signer));
+      }
+
+      _presigning = true;
+      for (auto& signer : _presigners) {
+         signer->_thread = std::thread([this, s = signer.get()]() { presign_loop(*s); });
+      }
+   }
+
+   void trx_generator_base::stop_presigners() {
+      _presigning = false;
+      for (auto& signer : _presigners) {
+         if (signer->_thread.joinable()) {
+            signer->_thread.join();
+         }
+      }
+      _presigners.clear();
+      _next_presigner = 0;
+   }
+
+   void trx_generator_base::presign_loop(trx_presigner& signer) {
+      fc::set_thread_name("presign");
+      const uint64_t stride = _presigners.size();
+      try {
+         while (_presigning) {
+            if (!signer._queue.write_available()) {
+               std::this_thread::sleep_for(std::chrono::microseconds(50));
+               continue;
+            }
+            signed_transaction_w_signer& trx = signer._trxs[signer._next_trx++ % signer._trxs.size()];
+            signer._nonce_prefix += stride;
+            update_resign_transaction(trx._trx, trx._signer, signer._nonce_prefix, signer._nonce, _config._trx_expiration_us, _config._chain_id,
+                                      _config._last_irr_block_id);
+            signer._queue.push(std::make_shared<chain::packed_transaction>(trx._trx));
+            if (_sender_waiting) {
+               std::lock_guard g(_presigned_mtx);
+               _presigned_cv.notify_one();
+            }
+         }
+      } catch (const fc::exception& e) {
+         elog("presigner exiting: ${e}", ("e", e.to_detail_string()));
+         _presigning = false;
+      } catch (const std::exception& e) {
+         elog("presigner exiting: ${e}", ("e", e.what()));
+         _presigning = false;
+      }
+   }
+
+   chain::packed_transaction_ptr trx_generator_base::next_presigned_trx() {
+      chain::packed_transaction_ptr trx;
+      for (;;) {
+         // take from the next signer with a transaction ready so one slow signer does not stall sending
+         for (size_t i = 0; i < _presigners.size(); ++i) {
+            trx_presigner& signer = *_presigners[_next_presigner++ % _presigners.size()];
+            if (signer._queue.pop(trx)) {
+               return trx;
+            }
+         }
+         if (!_presigning) {
+            return {};
+         }
+         // the sender is ahead of all signers, wait for a push rather than spin; the wait is bounded so a notify
+         // racing with setting _sender_waiting only delays the sender briefly
+         std::unique_lock lock(_presigned_mtx);
+         _sender_waiting = true;
+         _presigned_cv.wait_for(lock, std::chrono::milliseconds(1), [this]() {
+            return !_presigning || std::any_of(_presigners.begin(), _presigners.end(),
+                                               [](const auto& s) { return s->_queue.read_available() > 0; });
+         });
+         _sender_waiting = false;
+      }
    }
 
    void trx_generator_base::stop_generation() {
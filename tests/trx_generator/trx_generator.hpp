@@ -6,6 +6,12 @@
 #include <eosio/chain/asset.hpp>
 #include <eosio/chain/abi_serializer.hpp>
 #include <fc/io/json.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 namespace eosio::testing {
 
@@ -102,12 +108,14 @@ namespace eosio::testing {
       eosio::chain::block_id_type _last_irr_block_id = eosio::chain::block_id_type();
       std::string _log_dir = ".";
       bool _stop_on_trx_failed = true;
+      // 0 signs each transaction inline on the sending thread
+      uint16_t _num_sign_threads = 0;
 
       std::string to_string() const {
          std::ostringstream ss;
          ss << " generator id: " << _generator_id << " chain id: " << std::string(_chain_id) << " contract owner account: " 
             << _contract_owner_account << " trx expiration seconds: " << _trx_expiration_us.to_seconds() << " lib id: " << std::string(_last_irr_block_id)
-            << " log dir: " << _log_dir << " stop on trx failed: " << _stop_on_trx_failed;
+            << " log dir: " << _log_dir << " stop on trx failed: " << _stop_on_trx_failed << " sign threads: " << _num_sign_threads;
          return std::move(ss).str();
       };
    };
@@ -157,6 +165,19 @@ namespace eosio::testing {
       };
    };
 
+   // Signs transactions ahead of the sender. Each signer owns a copy of a subset of the generator's transactions and hands
+   // the packed result to the sending thread through its own single producer, single consumer lock-free queue.
+   struct trx_presigner {
+      static constexpr size_t queue_capacity = 4096;
+
+      std::vector<signed_transaction_w_signer> _trxs;
+      uint64_t _nonce_prefix = 0;
+      uint64_t _nonce = 0;
+      size_t _next_trx = 0;
+      boost::lockfree::spsc_queue<eosio::chain::packed_transaction_ptr> _queue{queue_capacity};
+      std::thread _thread;
+   };
+
    struct trx_generator_base {
       const trx_generator_base_config& _config;
       trx_provider _provider;
@@ -170,17 +191,25 @@ namespace eosio::testing {
       uint64_t _nonce = 0;
       uint64_t _nonce_prefix = 0;
 
+      std::vector<std::unique_ptr<trx_presigner>> _presigners;
+      std::atomic_bool _presigning{false};
+      size_t _next_presigner = 0;
+      // the sender waits on _presigned_cv when every presigner queue is empty, presigners notify it once they push
+      std::mutex _presigned_mtx;
+      std::condition_variable _presigned_cv;
+      std::atomic_bool _sender_waiting{false};
+
 
       trx_generator_base(const trx_generator_base_config& trx_gen_base_config, const provider_base_config& provider_config);
 
-      virtual ~trx_generator_base() = default;
+      virtual ~trx_generator_base();
 
       virtual void update_resign_transaction(eosio::chain::signed_transaction& trx, const fc::crypto::private_key& priv_key, uint64_t& nonce_prefix, uint64_t& nonce,
                                      const fc::microseconds& trx_expiration, const eosio::chain::chain_id_type& chain_id, const eosio::chain::block_id_type& last_irr_block_id);
 
       void push_transaction(signed_transaction_w_signer& trx, uint64_t& nonce_prefix,
                             uint64_t& nonce, const fc::microseconds& trx_expiration, const eosio::chain::chain_id_type& chain_id,
-                            const eosio::chain::block_id_type& last_irr_block_id);
+                            const eosio::chain::block_id_type& last_irr_block_id, const fc::time_point& scheduled_time);
 
       void set_transaction_headers(eosio::chain::transaction& trx, const eosio::chain::block_id_type& last_irr_block_id, const fc::microseconds& expiration, uint32_t delay_sec = 0);
 
@@ -190,7 +219,12 @@ namespace eosio::testing {
 
       void log_first_trx(const std::string& log_dir, const eosio::chain::signed_transaction& trx);
 
-      bool generate_and_send();
+      void start_presigners();
+      void stop_presigners();
+      void presign_loop(trx_presigner& signer);
+      eosio::chain::packed_transaction_ptr next_presigned_trx();
+
+      bool generate_and_send(const fc::time_point& scheduled_time = fc::time_point::now());
       bool tear_down();
       void stop_generation();
       bool stop_on_trx_fail();
@@ -222,10 +256,13 @@ namespace eosio::testing {
       eosio::chain::abi_serializer _abi;
       std::vector<fc::mutable_variant_object> _unpacked_actions;
       std::map<int, std::vector<std::string>> _acct_gen_fields;
+      std::mutex _generate_actions_mtx; // generate_actions() is shared by all presigners
 
       const fc::microseconds abi_serializer_max_time = fc::seconds(10); // No risk to client side serialization taking a long time
 
       trx_generator(const trx_generator_base_config& trx_gen_base_config, const provider_base_config& provider_config, const user_specified_trx_config& usr_trx_config);
+      // presigners call back into update_resign_transaction, stop them before this part of the object is destroyed
+      ~trx_generator() override { stop_presigners(); }
 
 
       std::vector<eosio::chain::action> generate_actions();
@@ -67,13 +67,15 @@ struct simple_tps_monitor {
 
 struct mock_trx_generator {
    std::vector<fc::time_point> _calls;
+   std::vector<fc::time_point> _scheduled;
    std::chrono::microseconds _delay;
 
    bool setup() {return true;}
    bool tear_down() {return true;}
 
-   bool generate_and_send() {
+   bool generate_and_send(const fc::time_point& scheduled_time) {
       _calls.push_back(fc::time_point::now());
+      _scheduled.push_back(scheduled_time);
       if (_delay.count() > 0) {
          std::this_thread::sleep_for(_delay);
       }
@@ -86,6 +88,7 @@ struct mock_trx_generator {
 
    mock_trx_generator(size_t expected_num_calls, uint32_t delay=0) :_calls(), _delay(delay) {
       _calls.reserve(expected_num_calls);
+      _scheduled.reserve(expected_num_calls);
    }
 };
 
@@ -276,6 +279,27 @@ BOOST_AUTO_TEST_CASE(tps_med_run_med_tps_30us_delay)
    }
 }
 
+BOOST_AUTO_TEST_CASE(tps_open_loop_schedule)
+{
+   constexpr uint32_t test_duration_s = 1;
+   constexpr uint32_t test_tps = 1000;
+   constexpr uint32_t expected_trxs = test_duration_s * test_tps;
+   constexpr uint32_t trx_delay_us = 1500;
+
+   std::shared_ptr<mock_trx_generator> generator = std::make_shared<mock_trx_generator>(expected_trxs, trx_delay_us);
+   std::shared_ptr<simple_tps_monitor> monitor = std::make_shared<simple_tps_monitor>(expected_trxs);
+
+   trx_tps_tester<mock_trx_generator, simple_tps_monitor> t1(generator, monitor, {test_duration_s, test_tps});
+   t1.run();
+
+   // sends fall behind, but each transaction is still stamped with the time it was due rather than when it went out
+   BOOST_REQUIRE_EQUAL(generator->_scheduled.size(), expected_trxs);
+   for (size_t i = 1; i < generator->_scheduled.size(); ++i) {
+      BOOST_REQUIRE_EQUAL((generator->_scheduled[i] - generator->_scheduled[i-1]).count(), 1000);
+   }
+   BOOST_REQUIRE_GT(generator->_calls.back(), generator->_scheduled.back() + fc::milliseconds(100));
+}
+
 BOOST_AUTO_TEST_CASE(tps_performance_monitor_during_spin_up)
 {
    tps_test_stats stats;
@@ -381,6 +405,50 @@ BOOST_AUTO_TEST_CASE(trx_generator_constructor)
    auto generator = std::make_shared<trx_generator>(tg_config, p_config, trx_config);
 }
 
+BOOST_AUTO_TEST_CASE(latency_histogram_percentiles)
+{
+   latency_histogram h;
+   BOOST_REQUIRE_EQUAL(h.value_at_percentile(99.0), 0);
+
+   for (int64_t v = 1; v <= 100000; ++v) {
+      h.record(v);
+   }
+   BOOST_REQUIRE_EQUAL(h.count(), 100000u);
+   BOOST_REQUIRE_EQUAL(h.min(), 1);
+   BOOST_REQUIRE_EQUAL(h.max(), 100000);
+   BOOST_REQUIRE_CLOSE(h.mean(), 50000.5, 0.0001);
+
+   // 7 sub bucket bits report values within 1/64 of the exact percentile
+   for (double p : {50.0, 90.0, 99.0, 99.9}) {
+      const double exact = p * 1000;
+      BOOST_REQUIRE_GE(h.value_at_percentile(p), exact);
+      BOOST_REQUIRE_LE(h.value_at_percentile(p), exact * (1.0 + 1.0 / 64));
+   }
+   BOOST_REQUIRE_EQUAL(h.value_at_percentile(100.0), 100000);
+
+   // small values are exact
+   latency_histogram small;
+   for (int64_t v = 0; v < 100; ++v) {
+      small.record(v);
+   }
+   BOOST_REQUIRE_EQUAL(small.value_at_percentile(50.0), 49);
+
+   latency_histogram merged;
+   merged.merge(h);
+   merged.merge(small);
+   BOOST_REQUIRE_EQUAL(merged.count(), 100100u);
+   BOOST_REQUIRE_EQUAL(merged.min(), 0);
+   BOOST_REQUIRE_EQUAL(merged.max(), 100000);
+
+   latency_time_series series;
+   series.record(0, 10);
+   series.record(0, 20);
+   series.record(2, 30);
+   BOOST_REQUIRE_EQUAL(series._overall.count(), 3u);
+   BOOST_REQUIRE_EQUAL(series._per_second.size(), 2u);
+   BOOST_REQUIRE_EQUAL(series._per_second.at(0).max(), 20);
+}
+
 BOOST_AUTO_TEST_CASE(account_name_generator_tests)
 {
    auto acct_gen = account_name_generator();
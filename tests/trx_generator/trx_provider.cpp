@@ -4,9 +4,12 @@
 #include <fc/io/raw.hpp>
 #include <fc/log/appender.hpp>
 #include <fc/io/json.hpp>
+#include <fc/log/logger_config.hpp>
 
 #include <boost/asio.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
 #include <eosio/chain/exceptions.hpp>
 
 namespace eosio::testing {
@@ -235,22 +238,221 @@ namespace eosio::testing {
       return info;
    }
 
+   trx_confirmation_tracker::~trx_confirmation_tracker() {
+      _running = false;
+      if (_thread.joinable())
+         _thread.join();
+   }
+
+   fc::variant trx_confirmation_tracker::post(const std::string& target, std::string body) {
+      namespace beast = boost::beast;
+      namespace http  = beast::http;
+
+      io_context        ioc;
+      tcp::resolver     resolver(ioc);
+      beast::tcp_stream stream(ioc);
+      stream.expires_after(std::chrono::seconds(5));
+      stream.connect(resolver.resolve(_config._confirmations_endpoint, std::to_string(_config._confirmations_port)));
+
+      http::request<http::string_body> req{http::verb::post, target, 11};
+      req.set(http::field::host, _config._confirmations_endpoint);
+      req.set(http::field::content_type, "application/json");
+      req.body() = std::move(body);
+      req.prepare_payload();
+      http::write(stream, req);
+
+      beast::flat_buffer                buffer;
+      http::response<http::string_body> res;
+      http::read(stream, buffer, res);
+      beast::error_code ec;
+      stream.socket().shutdown(tcp::socket::shutdown_both, ec);
+
+      FC_ASSERT(res.result() == http::status::ok, "${t} failed with http status ${s}: ${b}",
+                ("t", target)("s", res.result_int())("b", res.body()));
+      return fc::json::from_string(res.body());
+   }
+
+   void trx_confirmation_tracker::start() {
+      // transactions sent from now on can only appear in blocks after the current head
+      const fc::variant info = post("/v1/chain/get_info", "{}");
+      _last_block_num = info["head_block_num"].as<uint32_t>();
+      _last_block_id  = info["head_block_id"].as<eosio::chain::block_id_type>();
+      _last_head_time = info["head_block_time"].as<fc::time_point>();
+      _included.emplace(_last_block_num, included_block{_last_block_id, {}, {}});
+      ilog("Following blocks for transaction confirmations from ${ip}:${port} starting after block ${b}",
+           ("ip", _config._confirmations_endpoint)("port", _config._confirmations_port)("b", _last_block_num));
+      _running = true;
+      _thread = std::thread([this]() { run(); });
+   }
+
+   void trx_confirmation_tracker::stop(const fc::microseconds& max_wait) {
+      const fc::time_point deadline = fc::time_point::now() + max_wait;
+      while (_running && fc::time_point::now() < deadline) {
+         {
+            // poll() drops pending transactions that expired before head block time, so this does not wait out
+            // max_wait for transactions that can no longer be included
+            std::lock_guard<std::mutex> lock(_pending_lock);
+            if (_pending.empty() && not_irreversible() == 0)
+               break;
+         }
+         std::this_thread::sleep_for(poll_interval);
+      }
+      _running = false;
+      if (_thread.joinable())
+         _thread.join();
+   }
+
+   void trx_confirmation_tracker::trx_sent(const eosio::chain::transaction_id_type& trx_id, const fc::time_point& scheduled_time,
+                                           const fc::time_point_sec& expiration) {
+      std::lock_guard<std::mutex> lock(_pending_lock);
+      if (_start_time == fc::time_point())
+         _start_time = scheduled_time;
+      _pending.emplace(trx_id, sent_trx{scheduled_time, expiration});
+   }
+
+   void trx_confirmation_tracker::run() {
+      fc::set_thread_name("confirmations");
+      while (_running) {
+         try {
+            poll();
+         } catch (const fc::exception& e) {
+            wlog("Failed to follow blocks for transaction confirmations: ${e}", ("e", e.to_detail_string()));
+         } catch (const std::exception& e) {
+            wlog("Failed to follow blocks for transaction confirmations: ${e}", ("e", e.what()));
+         }
+         std::this_thread::sleep_for(poll_interval);
+      }
+   }
+
+   void trx_confirmation_tracker::unwind_last_block() {
+      std::lock_guard<std::mutex> lock(_pending_lock);
+      auto itr = _included.find(_last_block_num);
+      if (itr != _included.end()) {
+         for (auto& [id, sent] : itr->second.trxs)
+            _pending.emplace(id, sent);
+         _included.erase(itr);
+      }
+      --_last_block_num;
+      auto prev = _included.find(_last_block_num);
+      _last_block_id = prev != _included.end() ? prev->second.id : eosio::chain::block_id_type();
+   }
+
+   void trx_confirmation_tracker::poll() {
+      const fc::variant    info      = post("/v1/chain/get_info", "{}");
+      const uint32_t       head_num  = info["head_block_num"].as<uint32_t>();
+      const uint32_t       lib_num   = info["last_irreversible_block_num"].as<uint32_t>();
+      const fc::time_point head_time = info["head_block_time"].as<fc::time_point>();
+
+      while (_running && _last_block_num < head_num) {
+         const uint32_t    block_num = _last_block_num + 1;
+         const fc::variant block     = post("/v1/chain/get_block", fc::json::to_string(fc::mutable_variant_object()("block_num_or_id", block_num), fc::time_point::maximum()));
+
+         // the last followed block was forked out, step back until the new branch links up; irreversible blocks
+         // cannot be forked out, so a mismatch there means the node switched forks between requests
+         if (_last_block_id != eosio::chain::block_id_type() &&
+             block["previous"].as<eosio::chain::block_id_type>() != _last_block_id) {
+            if (_last_block_num <= lib_num)
+               break; // node's view changed under us, retry next poll
+            unwind_last_block();
+            continue;
+         }
+
+         included_block included{block["id"].as<eosio::chain::block_id_type>(),
+                                 block["timestamp"].as<eosio::chain::block_timestamp_type>().to_time_point(), {}};
+         std::lock_guard<std::mutex> lock(_pending_lock);
+         for (const auto& receipt : block["transactions"].get_array()) {
+            const fc::variant& trx = receipt["trx"];
+            if (!trx.is_object()) // deferred transactions are referenced by id only and are never sent by the generator
+               continue;
+            auto itr = _pending.find(trx["id"].as<eosio::chain::transaction_id_type>());
+            if (itr == _pending.end())
+               continue;
+            included.trxs.emplace_back(*itr);
+            _pending.erase(itr);
+         }
+         _last_block_num = block_num;
+         _last_block_id  = included.id;
+         _included.emplace(block_num, std::move(included));
+      }
+
+      // Irreversibility is timed by the head block time when lib was seen past the block, not by when this poll ran.
+      // Lib was still behind the block at the previous poll, so the latency is overstated by at most the head block
+      // time step between the two polls, which is reported as the resolution.
+      std::lock_guard<std::mutex> lock(_pending_lock);
+      bool recorded = false;
+      for (auto itr = _included.begin(); itr != _included.end() && itr->first <= lib_num; itr = _included.erase(itr)) {
+         for (const auto& [id, sent] : itr->second.trxs) {
+            const double at = (sent.scheduled - _start_time).to_seconds();
+            _inclusion_latency.record(at, (itr->second.timestamp - sent.scheduled).count());
+            _irreversible_latency.record(at, (head_time - sent.scheduled).count());
+            recorded = true;
+         }
+      }
+      if (recorded)
+         _irreversible_resolution = std::max(_irreversible_resolution, head_time - _last_head_time);
+      _last_head_time = head_time;
+      // can no longer be included once head block time is past their expiration
+      for (auto itr = _pending.begin(); itr != _pending.end();) {
+         if (itr->second.expiration < head_time) {
+            ++_expired;
+            itr = _pending.erase(itr);
+         } else {
+            ++itr;
+         }
+      }
+   }
+
+   fc::mutable_variant_object trx_confirmation_tracker::inclusion_to_variant() const {
+      return _inclusion_latency.to_variant()("not_included", _pending.size())("expired", _expired);
+   }
+
+   size_t trx_confirmation_tracker::not_irreversible() const {
+      size_t count = 0;
+      for (const auto& [num, b] : _included)
+         count += b.trxs.size();
+      return count;
+   }
+
+   fc::mutable_variant_object trx_confirmation_tracker::irreversible_to_variant() const {
+      return _irreversible_latency.to_variant()("not_irreversible", not_irreversible())
+                                               ("resolution_us", _irreversible_resolution.count());
+   }
+
    trx_provider::trx_provider(const provider_base_config& provider_config) {
-      if (provider_config._peer_endpoint_type == "http") {
-         _conn.emplace<http_connection>(provider_config);
-         _peer_connection = &std::get<http_connection>(_conn);
-      } else {
-         _conn.emplace<p2p_connection>(provider_config);
-         _peer_connection = &std::get<p2p_connection>(_conn);
+      if (provider_config._confirmations_port != 0) {
+         _confirmations.emplace(provider_config);
+      }
+      const uint16_t num_connections = std::max<uint16_t>(provider_config._num_connections, 1);
+      _peer_connections.reserve(num_connections);
+      for (uint16_t i = 0; i < num_connections; ++i) {
+         if (provider_config._peer_endpoint_type == "http") {
+            _peer_connections.emplace_back(std::make_unique<http_connection>(provider_config));
+         } else {
+            _peer_connections.emplace_back(std::make_unique<p2p_connection>(provider_config));
+         }
       }
    }
 
-   void trx_provider::setup() { _peer_connection->init_and_connect(); }
+   void trx_provider::setup() {
+      for (auto& conn : _peer_connections) {
+         conn->init_and_connect();
+      }
+      if (_confirmations) {
+         _confirmations->start();
+      }
+   }
 
-   void trx_provider::send(const chain::signed_transaction& trx) {
-      chain::packed_transaction pt(trx);
-      _peer_connection->send_transaction(pt);
-      _sent_trx_data.push_back(logged_trx_data(trx.id()));
+   void trx_provider::send(const chain::signed_transaction& trx, const fc::time_point& scheduled_time) {
+      send(chain::packed_transaction(trx), scheduled_time);
+   }
+
+   void trx_provider::send(const chain::packed_transaction& trx, const fc::time_point& scheduled_time) {
+      const size_t index = _next_connection++ % _peer_connections.size();
+      _peer_connections[index]->send_transaction(trx);
+      _sent_trx_data.push_back(logged_trx_data(trx.id(), scheduled_time, index));
+      if (_confirmations) {
+         _confirmations->trx_sent(trx.id(), scheduled_time, trx.expiration());
+      }
    }
 
    void trx_provider::log_trxs(const std::string& log_dir) {
@@ -258,8 +460,12 @@ namespace eosio::testing {
       fileName << log_dir << "/trx_data_output_" << getpid() << ".txt";
       std::ofstream out(fileName.str());
 
+      latency_time_series ack_latency;
+      const fc::time_point first_scheduled = _sent_trx_data.empty() ? fc::time_point() : _sent_trx_data.front()._timestamp;
+
       for (const logged_trx_data& data : _sent_trx_data) {
-         fc::time_point   acked = _peer_connection->get_trx_ack_time(data._trx_id);
+         provider_connection& conn = *_peer_connections.at(data._connection_index);
+         fc::time_point   acked = conn.get_trx_ack_time(data._trx_id);
          std::string      acked_str;
          fc::microseconds ack_round_trip_us;
          if (fc::time_point::min() == acked) {
@@ -268,21 +474,38 @@ namespace eosio::testing {
          } else {
             acked_str         = acked.to_iso_string();
             ack_round_trip_us = acked - data._timestamp;
+            ack_latency.record((data._timestamp - first_scheduled).to_seconds(), ack_round_trip_us.count());
          }
          out << std::string(data._trx_id) << "," << data._timestamp.to_iso_string() << "," << acked_str << ","
              << ack_round_trip_us.count();
 
-         acked_trx_trace_info info = _peer_connection->get_acked_trx_trace_info(data._trx_id);
+         acked_trx_trace_info info = conn.get_acked_trx_trace_info(data._trx_id);
          if (info._valid) {
             out << "," << info._block_num << "," << info._cpu_usage_us << "," << info._net_usage_words << "," << info._block_time;
          }
          out << "\n";
       }
       out.close();
+
+      // latencies in microseconds from scheduled send time, percentiles overall and per second of the run
+      fc::mutable_variant_object latency;
+      latency("ack", ack_latency.to_variant());
+      if (_confirmations) {
+         latency("inclusion", _confirmations->inclusion_to_variant());
+         latency("irreversible", _confirmations->irreversible_to_variant());
+      }
+      std::ostringstream latencyFileName;
+      latencyFileName << log_dir << "/trx_latency_" << getpid() << ".json";
+      fc::json::save_to_file(fc::variant(std::move(latency)), latencyFileName.str(), true);
    }
 
    void trx_provider::teardown() {
-      _peer_connection->cleanup_and_disconnect();
+      for (auto& conn : _peer_connections) {
+         conn->cleanup_and_disconnect();
+      }
+      if (_confirmations) {
+         _confirmations->stop(fc::seconds(30));
+      }
    }
 
    bool tps_performance_monitor::monitor_test(const tps_test_stats &stats) {
@@ -4,12 +4,14 @@
 #include<eosio/chain/block.hpp>
 #include<eosio/chain/thread_utils.hpp>
 
+#include<latency_histogram.hpp>
+
 #include<boost/asio/ip/tcp.hpp>
 #include<boost/asio/strand.hpp>
 
 #include<chrono>
+#include<memory>
 #include<thread>
-#include<variant>
 #include<vector>
 #include<mutex>
 
@@ -21,9 +23,10 @@ namespace eosio::testing {
    struct logged_trx_data {
       eosio::chain::transaction_id_type _trx_id;
       fc::time_point _timestamp;
+      size_t _connection_index = 0;
 
-      explicit logged_trx_data(eosio::chain::transaction_id_type trx_id, fc::time_point time_of_interest=fc::time_point::now()) :
-         _trx_id(trx_id), _timestamp(time_of_interest) {}
+      explicit logged_trx_data(eosio::chain::transaction_id_type trx_id, fc::time_point time_of_interest=fc::time_point::now(), size_t connection_index=0) :
+         _trx_id(trx_id), _timestamp(time_of_interest), _connection_index(connection_index) {}
    };
 
    struct provider_base_config {
@@ -32,11 +35,17 @@ namespace eosio::testing {
       unsigned short _port               = 9876;
       // Api endpoint not truly used for p2p connections as transactions are streamed directly to p2p endpoint
       std::string    _api_endpoint       = "/v1/chain/send_transaction2";
+      // transactions are sent round robin over this many connections to the peer endpoint
+      uint16_t       _num_connections    = 1;
+      // chain api of a node to follow blocks from for inclusion and irreversibility latency, port 0 disables
+      std::string    _confirmations_endpoint = "127.0.0.1";
+      unsigned short _confirmations_port     = 0;
 
       std::string to_string() const {
          std::ostringstream ss;
          ss << "Provider base config endpoint type: " << _peer_endpoint_type << " peer_endpoint: " << _peer_endpoint
-            << " port: " << _port << " api endpoint: " << _api_endpoint;
+            << " port: " << _port << " api endpoint: " << _api_endpoint << " connections: " << _num_connections
+            << " confirmations endpoint: " << _confirmations_endpoint << " confirmations port: " << _confirmations_port;
          return ss.str();
       }
    };
@@ -126,18 +135,81 @@ namespace eosio::testing {
       void disconnect() override final;
    };
 
+   // Follows blocks through the chain api of a node, matching the transactions in each block against those sent, to
+   // measure the time from scheduled send to block inclusion and to the block becoming irreversible. A transaction
+   // only counts as confirmed once its block is irreversible; blocks forked out before that return their
+   // transactions to pending.
+   struct trx_confirmation_tracker {
+      static constexpr auto poll_interval = std::chrono::milliseconds(100);
+
+      explicit trx_confirmation_tracker(const provider_base_config& provider_config)
+          : _config(provider_config) {}
+      ~trx_confirmation_tracker();
+
+      void start();
+      // waits up to max_wait for sent transactions to become irreversible or expire before stopping
+      void stop(const fc::microseconds& max_wait);
+      void trx_sent(const eosio::chain::transaction_id_type& trx_id, const fc::time_point& scheduled_time,
+                    const fc::time_point_sec& expiration);
+
+      fc::time_point start_time() const { return _start_time; }
+      fc::mutable_variant_object inclusion_to_variant() const;
+      fc::mutable_variant_object irreversible_to_variant() const;
+
+    private:
+      struct sent_trx {
+         fc::time_point     scheduled;
+         fc::time_point_sec expiration;
+      };
+      struct included_block {
+         eosio::chain::block_id_type                                           id;
+         fc::time_point                                                        timestamp;
+         std::vector<std::pair<eosio::chain::transaction_id_type, sent_trx>> trxs;
+      };
+
+      void        run();
+      void        poll();
+      // moves the transactions of the last followed block back to pending and steps back one block
+      void        unwind_last_block();
+      // transactions in followed blocks that are not yet irreversible, requires _pending_lock or a stopped tracker
+      size_t      not_irreversible() const;
+      fc::variant post(const std::string& target, std::string body);
+
+      const provider_base_config& _config;
+      std::atomic_bool            _running{false};
+      std::thread                 _thread;
+
+      std::mutex                                            _pending_lock;
+      std::map<eosio::chain::transaction_id_type, sent_trx> _pending;    // sent, not in a followed block
+      std::map<uint32_t, included_block>                    _included;   // followed blocks not yet irreversible
+      uint64_t                                              _expired = 0; // expired before being included
+      fc::time_point                                        _start_time; // scheduled time of first trx sent
+
+      // only accessed by the tracker thread while running
+      uint32_t                    _last_block_num = 0;
+      eosio::chain::block_id_type _last_block_id;
+      fc::time_point              _last_head_time;          // head block time of the previous poll
+      fc::microseconds            _irreversible_resolution; // largest head block time step a lib advance was seen in
+      latency_time_series         _inclusion_latency;
+      latency_time_series         _irreversible_latency;
+   };
+
    struct trx_provider {
       explicit trx_provider(const provider_base_config& provider_config);
 
       void setup();
-      void send(const chain::signed_transaction& trx);
+      // scheduled_time is when the transaction was due to be sent, so queueing delay on the sending side is
+      // included in the logged round trip time rather than hidden by it
+      void send(const chain::signed_transaction& trx, const fc::time_point& scheduled_time = fc::time_point::now());
+      void send(const chain::packed_transaction& trx, const fc::time_point& scheduled_time = fc::time_point::now());
       void log_trxs(const std::string& log_dir);
       void teardown();
 
     private:
-      std::variant<std::monostate, http_connection, p2p_connection> _conn;
-      provider_connection*         _peer_connection;
+      std::vector<std::unique_ptr<provider_connection>> _peer_connections;
+      size_t                       _next_connection = 0;
       std::vector<logged_trx_data> _sent_trx_data;
+      std::optional<trx_confirmation_tracker> _confirmations;
    };
 
    struct tps_test_stats {
@@ -221,9 +293,11 @@ namespace eosio::testing {
 
          while (keep_running) {
             stats.last_run = fc::time_point::now();
-            stats.next_run = stats.start_time + fc::microseconds(stats.trx_interval.count() * (stats.trxs_sent+1));
+            // open loop: the send schedule is fixed from the start time regardless of how long previous sends took
+            const fc::time_point scheduled = stats.start_time + fc::microseconds(stats.trx_interval.count() * stats.trxs_sent);
+            stats.next_run = scheduled + stats.trx_interval;
 
-            if (_generator->generate_and_send()) {
+            if (_generator->generate_and_send(scheduled)) {
                stats.trxs_sent++;
             } else {
                elog("generator unable to create/send a transaction");
@@ -262,6 +262,65 @@ BOOST_AUTO_TEST_CASE(wallet_manager_create_test) {
    } FC_LOG_AND_RETHROW()
 }
 
+/// Test batch signing on the signing threads
+BOOST_AUTO_TEST_CASE(wallet_manager_batch_sign_test)
+{ try {
+   using namespace eosio::wallet;
+
+   if (std::filesystem::exists("batch.wallet")) std::filesystem::remove("batch.wallet");
+
+   constexpr auto key1 = "5JktVNHnRX48BUdtewU7N1CyL4Z886c42x7wYW7XhNWkDQRhdcS";
+   constexpr auto key2 = "5Ju5RTcVDo35ndtzHioPMgebvBM6LkJ6tvuU6LTNQv8yaz3ggZr";
+   private_key_type pkey1{std::string(key1)};
+   private_key_type pkey2{std::string(key2)};
+   private_key_type missing = private_key_type::generate();
+
+   wallet_manager wm;
+   wm.set_signing_threads(3);
+   wm.create("batch");
+   wm.import_key("batch", key1);
+   wm.import_key("batch", key2);
+
+   auto chain_id = genesis_state().compute_chain_id();
+   std::vector<sign_transaction_request> trx_requests;
+   std::vector<sign_digest_request> digest_requests;
+   for (uint32_t i = 0; i < 50; ++i) {
+      chain::signed_transaction trx;
+      trx.ref_block_num = i;
+      flat_set<public_key_type> keys{pkey1.get_public_key()};
+      if (i % 2)
+         keys.emplace(pkey2.get_public_key());
+      trx_requests.push_back({trx, keys});
+      digest_requests.push_back({trx.sig_digest(chain_id), i % 2 ? pkey2.get_public_key() : pkey1.get_public_key()});
+   }
+
+   auto trxs = wm.sign_transactions(trx_requests, chain_id);
+   BOOST_REQUIRE_EQUAL(trxs.size(), trx_requests.size());
+   for (size_t i = 0; i < trxs.size(); ++i) {
+      BOOST_CHECK_EQUAL(trxs[i].ref_block_num, i);
+      flat_set<public_key_type> pks;
+      trxs[i].get_signature_keys(chain_id, fc::time_point::maximum(), pks);
+      BOOST_CHECK(pks == trx_requests[i].keys);
+      BOOST_CHECK(trxs[i].signatures == wm.sign_transaction(trx_requests[i].transaction, trx_requests[i].keys, chain_id).signatures);
+   }
+
+   auto sigs = wm.sign_digests(digest_requests);
+   BOOST_REQUIRE_EQUAL(sigs.size(), digest_requests.size());
+   for (size_t i = 0; i < sigs.size(); ++i) {
+      BOOST_CHECK(public_key_type(sigs[i], digest_requests[i].digest) == digest_requests[i].key);
+   }
+
+   trx_requests[17].keys.emplace(missing.get_public_key());
+   BOOST_CHECK_THROW(wm.sign_transactions(trx_requests, chain_id), chain::wallet_missing_pub_key_exception);
+   digest_requests[33].key = missing.get_public_key();
+   BOOST_CHECK_THROW(wm.sign_digests(digest_requests), chain::wallet_missing_pub_key_exception);
+
+   wm.lock("batch");
+   BOOST_CHECK_THROW(wm.sign_digests(digest_requests), chain::wallet_missing_pub_key_exception);
+
+   std::filesystem::remove("batch.wallet");
+} FC_LOG_AND_RETHROW() }
+
 
 BOOST_AUTO_TEST_SUITE_END()
 
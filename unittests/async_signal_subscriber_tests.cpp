@@ -0,0 +1,86 @@
+#include <boost/test/unit_test.hpp>
+#include <eosio/chain/async_signal_subscriber.hpp>
+#include <eosio/chain/thread_utils.hpp>
+#include <eosio/chain/types.hpp>
+
+#include <future>
+
+using namespace eosio;
+using namespace eosio::chain;
+
+BOOST_AUTO_TEST_SUITE(async_signal_subscriber_tests)
+
+using block_signal = boost::signals2::signal<void(const std::tuple<const signed_block_ptr&, const block_id_type&>&)>;
+
+BOOST_AUTO_TEST_CASE(in_order_with_owned_args) try {
+   named_thread_pool<struct sigtst> pool;
+   pool.start( 2, {} );
+
+   block_signal accepted;
+   boost::signals2::signal<void(uint32_t)> started;
+   std::vector<uint32_t> seen;
+   {
+      async_signal_subscriber sub( "test", pool.get_executor(), 8, async_signal_subscriber::backpressure::block );
+      boost::signals2::scoped_connection c1 = sub.connect( accepted, [&]( const auto& t ) {
+         const auto& [block, id] = t;
+         seen.push_back( block->block_num() );
+      } );
+      boost::signals2::scoped_connection c2 = sub.connect( started, [&]( uint32_t block_num ) {
+         seen.push_back( block_num );
+      } );
+
+      for( uint32_t i = 1; i < 1000; i += 2 ) {
+         started( i );
+         // the slot keeps the block alive, the signalling side drops its reference right away
+         auto block = std::make_shared<signed_block>();
+         block->previous._hash[0] = fc::endian_reverse_u32( i );
+         block_id_type id;
+         accepted( std::tie( block, id ) );
+      }
+      sub.stop();
+      // handled inline once stopped
+      started( 1001 );
+   }
+   pool.stop();
+
+   BOOST_REQUIRE_EQUAL( seen.size(), 1001u );
+   for( uint32_t i = 0; i < seen.size(); ++i )
+      BOOST_REQUIRE_EQUAL( seen[i], i + 1 );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_CASE(drop_oldest) try {
+   named_thread_pool<struct sigtst> pool;
+   pool.start( 1, {} );
+
+   // hold the subscriber's strand until the queue has overflowed
+   std::promise<void> release;
+   std::shared_future<void> released = release.get_future().share();
+
+   boost::signals2::signal<void(uint32_t)> started;
+   std::vector<uint32_t> seen;
+   async_signal_subscriber sub( "test", pool.get_executor(), 2, async_signal_subscriber::backpressure::drop_oldest );
+   boost::signals2::scoped_connection c = sub.connect( started, [&]( uint32_t block_num ) {
+      if( block_num == 1 )
+         released.wait();
+      seen.push_back( block_num );
+   } );
+
+   started( 1 );
+   while( sub.get_stats().queued != 0 ) // wait for 1 to be running
+      std::this_thread::yield();
+   for( uint32_t i = 2; i <= 5; ++i )
+      started( i );
+
+   auto stats = sub.get_stats();
+   BOOST_TEST( stats.name == "test" );
+   BOOST_TEST( stats.queued == 2u );
+   BOOST_TEST( stats.dropped == 2u );
+
+   release.set_value();
+   sub.stop();
+   pool.stop();
+
+   BOOST_TEST( seen == (std::vector<uint32_t>{1, 4, 5}) );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
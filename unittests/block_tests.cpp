@@ -322,4 +322,42 @@ BOOST_FIXTURE_TEST_CASE( abort_block_transactions_tester, validating_tester) { t
 
    } FC_LOG_AND_RETHROW() }
 
+// a block with transactions produced on one chain and pushed to a validator, with the report of applying it
+struct block_report_fixture {
+   tester                   main;
+   tester                   validator{ setup_policy::none };
+   signed_block_ptr         b;
+   controller::block_report br;
+
+   block_report_fixture() {
+      main.produce_block();
+      main.create_accounts( {"alice"_n, "bob"_n} );
+      b = main.produce_block();
+      BOOST_REQUIRE( !b->transactions.empty() );
+
+      for( uint32_t n = validator.control->head_block_num() + 1; n < b->block_num(); ++n ) {
+         validator.push_block( main.control->fetch_block_by_number( n ) );
+      }
+
+      auto bsf = validator.control->create_block_state_future( b->calculate_id(), b );
+      validator.control->push_block( br, bsf.get(), forked_branch_callback{}, trx_meta_cache_lookup{} );
+      BOOST_REQUIRE_EQUAL( validator.control->head_block_id(), b->calculate_id() );
+   }
+};
+
+BOOST_FIXTURE_TEST_CASE( block_report_phase_times, block_report_fixture ) { try {
+   // phases are disjoint parts of applying the block; log_irreversible runs after total_time is taken
+   BOOST_TEST( br.key_recovery_wait_time <= br.execution_time );
+   BOOST_TEST( (br.start_block_time + br.execution_time + br.finalize_block_time + br.signal_time).count() <= br.total_time.count() );
+   BOOST_TEST( br.log_irreversible_time.count() >= 0 );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_FIXTURE_TEST_CASE( block_report_undo_sessions, block_report_fixture ) { try {
+   // every transaction of the block and the implicit onblock are squashed into the block session, none fail
+   BOOST_TEST( br.db_squash_count == b->transactions.size() + 1 );
+   BOOST_TEST( br.db_undo_count == 0u );
+   BOOST_TEST( br.db_commit_time <= br.log_irreversible_time );
+   BOOST_TEST( br.undo_stack_depth == int64_t(validator.control->head_block_num() - validator.control->last_irreversible_block_num()) );
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,8 @@
 #include <fc/log/logger_config.hpp>
 #include <fc/io/cfile.hpp>
 #include <eosio/chain/deep_mind.hpp>
+#include <eosio/chain/deep_mind_writer.hpp>
+#include <fc/crypto/hex.hpp>
 
 #include <boost/test/unit_test.hpp>
 
@@ -52,6 +54,27 @@ struct deep_mind_tester : deep_mind_log_fixture, validating_tester
    deep_mind_tester() : validating_tester({}, &deep_mind_logger, setup_policy::full) {}
 };
 
+struct deep_mind_binary_fixture
+{
+   fc::temp_cfile tmp;
+   std::shared_ptr<deep_mind_writer> writer;
+   deep_mind_handler deep_mind_logger;
+
+   deep_mind_binary_fixture()
+   {
+      tmp.file().close();
+      // small queue so the main thread waits on the writer during the test
+      writer = std::make_shared<deep_mind_writer>(tmp.file().get_file_path().string(), 4);
+      deep_mind_logger.update_config(deep_mind_handler::deep_mind_config{.zero_elapsed = true});
+      deep_mind_logger.update_writer(writer);
+   }
+};
+
+struct deep_mind_binary_tester : deep_mind_binary_fixture, validating_tester
+{
+   deep_mind_binary_tester() : validating_tester({}, &deep_mind_logger, setup_policy::full) {}
+};
+
 namespace {
 
 void compare_files(const std::string& filename1, const std::string& filename2)
@@ -80,6 +103,30 @@ void compare_files(const std::string& filename1, const std::string& filename2)
    }
 }
 
+struct binary_record {
+   deep_mind_writer::record_type type;
+   std::vector<char>             body;
+};
+
+std::vector<binary_record> read_binary_records(const std::filesystem::path& path)
+{
+   std::ifstream in(path, std::ios::binary);
+   std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+   std::vector<binary_record> records;
+   size_t pos = 0;
+   while (pos + 5 <= data.size()) {
+      uint32_t length = 0;
+      memcpy(&length, data.data() + pos, sizeof(length));
+      BOOST_REQUIRE(length >= 1 && pos + 4 + length <= data.size());
+      binary_record r{static_cast<deep_mind_writer::record_type>(data[pos + 4]),
+                      std::vector<char>(data.begin() + pos + 5, data.begin() + pos + 4 + length)};
+      records.push_back(std::move(r));
+      pos += 4 + length;
+   }
+   BOOST_REQUIRE_EQUAL(pos, data.size());
+   return records;
+}
+
 } // namespace
 
 BOOST_AUTO_TEST_SUITE(deep_mind_tests)
@@ -116,4 +163,52 @@ BOOST_FIXTURE_TEST_CASE(deep_mind, deep_mind_tester)
    }
 }
 
+// the binary output carries the same records as the text log, with blocks and traces as raw packed bytes
+BOOST_FIXTURE_TEST_CASE(deep_mind_binary, deep_mind_binary_tester)
+{
+   produce_block();
+
+   create_account( "alice"_n );
+
+   push_action(config::system_account_name, "updateauth"_n, "alice"_n, fc::mutable_variant_object()
+               ("account", "alice")
+               ("permission", "test1")
+               ("parent", "active")
+               ("auth", authority{{"eosio"_n, "active"_n}}));
+
+   produce_block();
+   writer->flush();
+
+   auto records = read_binary_records(tmp.file().get_file_path());
+
+   std::ifstream expected(DEEP_MIND_LOGFILE);
+   std::string line;
+   size_t i = 0;
+   auto packed_matches = [&](deep_mind_writer::record_type type, const std::string& rest) {
+      // rest is "<block_num> <hex>"
+      auto space = rest.find(' ');
+      uint32_t block_num = std::stoul(rest.substr(0, space));
+      const auto& r = records.at(i);
+      BOOST_REQUIRE(r.type == type);
+      uint32_t num = 0;
+      memcpy(&num, r.body.data(), sizeof(num));
+      BOOST_TEST(num == block_num);
+      BOOST_TEST(fc::to_hex(r.body.data() + sizeof(num), r.body.size() - sizeof(num)) == rest.substr(space + 1));
+   };
+   for (; std::getline(expected, line); ++i) {
+      BOOST_REQUIRE_LT(i, records.size());
+      BOOST_REQUIRE(line.rfind("DMLOG ", 0) == 0);
+      line = line.substr(6);
+      if (line.rfind("ACCEPTED_BLOCK ", 0) == 0) {
+         packed_matches(deep_mind_writer::record_type::accepted_block, line.substr(15));
+      } else if (line.rfind("APPLIED_TRANSACTION ", 0) == 0) {
+         packed_matches(deep_mind_writer::record_type::applied_transaction, line.substr(20));
+      } else {
+         BOOST_REQUIRE(records[i].type == deep_mind_writer::record_type::text);
+         BOOST_TEST(std::string(records[i].body.begin(), records[i].body.end()) == line);
+      }
+   }
+   BOOST_TEST(i == records.size());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,41 @@
+#include <eosio/chain/merkle.hpp>
+#include <boost/test/unit_test.hpp>
+
+using namespace eosio::chain;
+
+BOOST_AUTO_TEST_SUITE(merkle_tree_tests)
+
+BOOST_AUTO_TEST_CASE(accumulator_matches_merkle) {
+   merkle_accumulator acc;
+   deque<digest_type> digests;
+   BOOST_TEST( acc.get_root() == merkle( digests ) );
+
+   for( uint32_t i = 0; i < 300; ++i ) {
+      const auto d = digest_type::hash( i );
+      acc.append( d );
+      digests.push_back( d );
+      BOOST_TEST( acc.size() == digests.size() );
+      BOOST_TEST( acc.get_root() == merkle( digests ) );
+   }
+}
+
+BOOST_AUTO_TEST_CASE(accumulator_restore) {
+   merkle_accumulator acc;
+   deque<digest_type> digests;
+   for( uint32_t i = 0; i < 7; ++i ) {
+      acc.append( digest_type::hash( i ) );
+      digests.push_back( digest_type::hash( i ) );
+   }
+
+   // a failed transaction is rolled back by restoring a copy
+   const auto restore_point = acc;
+   acc.append( digest_type::hash( 100 ) ); // merges into a complete subtree of 8
+   acc.append( digest_type::hash( 101 ) );
+   acc = restore_point;
+
+   acc.append( digest_type::hash( 7 ) );
+   digests.push_back( digest_type::hash( 7 ) );
+   BOOST_TEST( acc.get_root() == merkle( digests ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
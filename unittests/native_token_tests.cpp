@@ -0,0 +1,159 @@
+#include <eosio/chain/apply_context.hpp>
+#include <eosio/testing/tester.hpp>
+
+#include <fc/variant_object.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <test_contracts.hpp>
+
+using namespace eosio;
+using namespace eosio::chain;
+using namespace eosio::testing;
+
+using mvo = fc::mutable_variant_object;
+
+/**
+ * Runs every transaction on a chain that applies eosio.token::transfer in the wasm runtime and on a chain that
+ * applies it natively, and requires identical results, traces, blocks and state.
+ */
+class native_token_tester {
+public:
+   native_token_tester()
+   : wasm( wasm_dir, []( controller::config& ) {}, true )
+   , native( native_dir, []( controller::config& cfg ) {
+        const auto code = test_contracts::eosio_token_wasm();
+        cfg.native_token_code_hashes.emplace( fc::sha256::hash( reinterpret_cast<const char*>( code.data() ), code.size() ) );
+     }, true ) {
+      for( auto* t : { &wasm, &native } ) {
+         t->execute_setup_policy( setup_policy::full );
+         t->create_accounts( { "alice"_n, "bob"_n, "carol"_n, "dan"_n, "erin"_n, "eosio.token"_n } );
+         t->set_code( "eosio.token"_n, test_contracts::eosio_token_wasm() );
+         t->set_abi( "eosio.token"_n, test_contracts::eosio_token_abi() );
+         t->produce_blocks();
+      }
+      // counts the transfers that reach the wasm runtime
+      wasm.control->get_wasm_interface().substitute_apply = [this]( const digest_type&, uint8_t, uint8_t, apply_context& context ) {
+         if( context.get_receiver() == "eosio.token"_n && context.get_action().name == "transfer"_n )
+            ++wasm_transfers;
+         return false;
+      };
+      native.control->get_wasm_interface().substitute_apply = [this]( const digest_type&, uint8_t, uint8_t, apply_context& context ) {
+         if( context.get_receiver() == "eosio.token"_n && context.get_action().name == "transfer"_n )
+            ++native_wasm_transfers;
+         return false;
+      };
+   }
+
+   /// pushes `act` to both chains, checks that the outcomes are identical and returns it
+   base_tester::action_result push( const action_name& name, const std::vector<account_name>& actors, const mvo& data,
+                                    const std::function<void(action&)>& edit = {} ) {
+      std::vector<permission_level> auths;
+      for( const auto& a : actors )
+         auths.push_back( { a, config::active_name } );
+
+      base_tester::action_result results[2];
+      transaction_trace_ptr traces[2];
+      int i = 0;
+      for( auto* t : { &wasm, &native } ) {
+         signed_transaction trx;
+         trx.actions.emplace_back( t->get_action( "eosio.token"_n, name, auths, data ) );
+         if( edit )
+            edit( trx.actions.back() );
+         t->set_transaction_headers( trx );
+         for( const auto& a : actors )
+            trx.sign( t->get_private_key( a, "active" ), t->control->get_chain_id() );
+         try {
+            traces[i] = t->push_transaction( trx );
+         } catch( const fc::exception& e ) {
+            results[i] = base_tester::error( e.top_message() );
+         }
+         t->produce_block();
+         ++i;
+      }
+
+      BOOST_REQUIRE_EQUAL( results[0], results[1] );
+      BOOST_REQUIRE_EQUAL( !!traces[0], !!traces[1] );
+      if( traces[0] )
+         require_same_traces( *traces[0], *traces[1] );
+      BOOST_REQUIRE_EQUAL( wasm.control->head_block_id(), native.control->head_block_id() );
+      return results[0];
+   }
+
+   base_tester::action_result transfer( account_name from, account_name to, const std::string& quantity, const std::string& memo,
+                                        std::vector<account_name> actors = {} ) {
+      if( actors.empty() )
+         actors.push_back( from );
+      return push( "transfer"_n, actors, mvo()("from", from)("to", to)("quantity", asset::from_string( quantity ))("memo", memo) );
+   }
+
+   static void require_same_traces( const transaction_trace& a, const transaction_trace& b ) {
+      BOOST_REQUIRE( a.receipt && b.receipt );
+      BOOST_REQUIRE( *a.receipt == *b.receipt );
+      BOOST_REQUIRE_EQUAL( a.action_traces.size(), b.action_traces.size() );
+      for( size_t i = 0; i < a.action_traces.size(); ++i ) {
+         const action_trace& x = a.action_traces[i];
+         const action_trace& y = b.action_traces[i];
+         BOOST_REQUIRE_EQUAL( x.receiver, y.receiver );
+         BOOST_REQUIRE_EQUAL( x.act.name, y.act.name );
+         BOOST_REQUIRE_EQUAL( x.creator_action_ordinal, y.creator_action_ordinal );
+         BOOST_REQUIRE_EQUAL( x.closest_unnotified_ancestor_action_ordinal, y.closest_unnotified_ancestor_action_ordinal );
+         BOOST_REQUIRE( x.receipt && y.receipt );
+         BOOST_REQUIRE_EQUAL( x.receipt->digest(), y.receipt->digest() );
+         BOOST_REQUIRE_EQUAL( x.console, y.console );
+         BOOST_REQUIRE( x.return_value == y.return_value );
+         BOOST_REQUIRE_EQUAL( x.account_ram_deltas.size(), y.account_ram_deltas.size() );
+         for( auto xi = x.account_ram_deltas.begin(), yi = y.account_ram_deltas.begin(); xi != x.account_ram_deltas.end(); ++xi, ++yi ) {
+            BOOST_REQUIRE_EQUAL( xi->account, yi->account );
+            BOOST_REQUIRE_EQUAL( xi->delta, yi->delta );
+         }
+      }
+   }
+
+   fc::temp_directory wasm_dir;
+   fc::temp_directory native_dir;
+   tester             wasm;
+   tester             native;
+   uint32_t           wasm_transfers = 0;
+   uint32_t           native_wasm_transfers = 0;
+};
+
+BOOST_AUTO_TEST_SUITE(native_token_tests)
+
+BOOST_FIXTURE_TEST_CASE( differential, native_token_tester ) try {
+   BOOST_REQUIRE_EQUAL( base_tester::success(),
+                        push( "create"_n, { "eosio.token"_n }, mvo()("issuer", "alice")("maximum_supply", asset::from_string( "1000000.0000 CUR" )) ) );
+   BOOST_REQUIRE_EQUAL( base_tester::success(),
+                        push( "issue"_n, { "alice"_n }, mvo()("to", "alice")("quantity", asset::from_string( "1000.0000 CUR" ))("memo", "") ) );
+   // existing balance, new balance paid by the sender, new balance paid by the receiver
+   BOOST_REQUIRE_EQUAL( base_tester::success(), transfer( "alice"_n, "bob"_n, "10.0000 CUR", "hi" ) );
+   BOOST_REQUIRE_EQUAL( base_tester::success(), transfer( "alice"_n, "carol"_n, "1.0000 CUR", "" ) );
+   BOOST_REQUIRE_EQUAL( base_tester::success(), transfer( "bob"_n, "dan"_n, "2.5000 CUR", "", { "bob"_n, "dan"_n } ) );
+   // whole balance, the row stays
+   BOOST_REQUIRE_EQUAL( base_tester::success(), transfer( "carol"_n, "alice"_n, "1.0000 CUR", "" ) );
+   BOOST_REQUIRE_EQUAL( base_tester::wasm_assert_msg( "overdrawn balance" ), transfer( "carol"_n, "bob"_n, "1.0000 CUR", "" ) );
+
+   BOOST_REQUIRE_EQUAL( base_tester::wasm_assert_msg( "cannot transfer to self" ), transfer( "alice"_n, "alice"_n, "1.0000 CUR", "" ) );
+   BOOST_REQUIRE_NE( base_tester::success(), transfer( "alice"_n, "bob"_n, "1.0000 CUR", "", { "bob"_n } ) );
+   BOOST_REQUIRE_EQUAL( base_tester::wasm_assert_msg( "to account does not exist" ), transfer( "alice"_n, "nobody"_n, "1.0000 CUR", "" ) );
+   BOOST_REQUIRE_EQUAL( base_tester::wasm_assert_msg( "unable to find key" ), transfer( "alice"_n, "bob"_n, "1.0000 XYZ", "" ) );
+   BOOST_REQUIRE_EQUAL( base_tester::wasm_assert_msg( "must transfer positive quantity" ), transfer( "alice"_n, "bob"_n, "0.0000 CUR", "" ) );
+   BOOST_REQUIRE_EQUAL( base_tester::wasm_assert_msg( "must transfer positive quantity" ), transfer( "alice"_n, "bob"_n, "-1.0000 CUR", "" ) );
+   BOOST_REQUIRE_EQUAL( base_tester::wasm_assert_msg( "symbol precision mismatch" ), transfer( "alice"_n, "bob"_n, "1.00 CUR", "" ) );
+   BOOST_REQUIRE_EQUAL( base_tester::wasm_assert_msg( "memo has more than 256 bytes" ), transfer( "alice"_n, "bob"_n, "1.0000 CUR", std::string( 257, 'm' ) ) );
+   BOOST_REQUIRE_EQUAL( base_tester::wasm_assert_msg( "overdrawn balance" ), transfer( "alice"_n, "bob"_n, "10000.0000 CUR", "" ) );
+   BOOST_REQUIRE_EQUAL( base_tester::wasm_assert_msg( "no balance object found" ), transfer( "erin"_n, "bob"_n, "1.0000 CUR", "" ) );
+
+   // action data the contract cannot deserialize is left to the wasm
+   BOOST_REQUIRE_NE( base_tester::success(), push( "transfer"_n, { "alice"_n },
+                     mvo()("from", "alice")("to", "bob")("quantity", asset::from_string( "1.0000 CUR" ))("memo", "truncated"),
+                     []( action& a ) { a.data.resize( a.data.size() - 1 ); } ) );
+
+   BOOST_REQUIRE_EQUAL( wasm.control->calculate_integrity_hash(), native.control->calculate_integrity_hash() );
+
+   // only the truncated transfer reached the wasm runtime of the native chain
+   BOOST_REQUIRE_GT( wasm_transfers, 1u );
+   BOOST_REQUIRE_EQUAL( native_wasm_transfers, 1u );
+} FC_LOG_AND_RETHROW()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+#include <eosio/chain/platform_timer.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace eosio::chain;
+
+namespace {
+
+void count_expiration( void* p ) {
+   ++*static_cast<std::atomic<uint32_t>*>( p );
+}
+
+fc::time_point from_now( fc::microseconds us ) {
+   return fc::time_point::now() + us;
+}
+
+// waits up to one second for `t` to expire
+bool wait_expired( const platform_timer& t ) {
+   const auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds( 1 );
+   while( !t.expired && std::chrono::steady_clock::now() < give_up )
+      std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+   return t.expired;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(platform_timer_tests)
+
+BOOST_AUTO_TEST_CASE(expiration) {
+   platform_timer t;
+   std::atomic<uint32_t> calls = 0;
+   t.set_expiration_callback( &count_expiration, &calls );
+
+   for( uint32_t i = 1; i <= 10; ++i ) {
+      t.start( from_now( fc::milliseconds( 2 ) ) );
+      BOOST_REQUIRE( wait_expired( t ) );
+      BOOST_REQUIRE_EQUAL( calls.load(), i );
+   }
+
+   // a deadline in the past expires immediately without a callback
+   t.start( fc::time_point::now() - fc::milliseconds( 1 ) );
+   BOOST_REQUIRE( t.expired );
+   BOOST_REQUIRE_EQUAL( calls.load(), 10u );
+
+   t.set_expiration_callback( nullptr, nullptr );
+}
+
+BOOST_AUTO_TEST_CASE(earlier_deadline_while_waiting) {
+   platform_timer long_timer;
+   platform_timer short_timer;
+   long_timer.start( from_now( fc::seconds( 10 ) ) );
+   // arming an earlier deadline while the watchdog waits for a later one must not wait for the later one
+   short_timer.start( from_now( fc::milliseconds( 2 ) ) );
+   BOOST_REQUIRE( wait_expired( short_timer ) );
+   BOOST_REQUIRE( !long_timer.expired );
+   long_timer.stop();
+}
+
+BOOST_AUTO_TEST_CASE(cancel_before_expire) {
+   platform_timer t;
+   std::atomic<uint32_t> calls = 0;
+   t.set_expiration_callback( &count_expiration, &calls );
+
+   for( uint32_t i = 0; i < 10; ++i ) {
+      t.start( from_now( fc::milliseconds( 20 ) ) );
+      BOOST_REQUIRE( !t.expired );
+      t.stop();
+      BOOST_REQUIRE( t.expired );
+   }
+   t.start( fc::time_point::maximum() );
+   BOOST_REQUIRE( !t.expired );
+   std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+   BOOST_REQUIRE_EQUAL( calls.load(), 0u );
+
+   t.set_expiration_callback( nullptr, nullptr );
+}
+
+BOOST_AUTO_TEST_CASE(repeated_create_destroy) {
+   // timers come and go on several threads, so the last timer going away races with a new one being created
+   std::vector<std::thread> threads;
+   std::atomic<uint32_t> expirations = 0;
+   for( uint32_t n = 0; n < 4; ++n ) {
+      threads.emplace_back( [&]() {
+         for( uint32_t i = 0; i < 200; ++i ) {
+            platform_timer t;
+            t.start( from_now( fc::microseconds( 200 ) ) );
+            if( i % 2 == 0 && wait_expired( t ) )
+               ++expirations;
+         }
+      } );
+   }
+   for( auto& t : threads )
+      t.join();
+   BOOST_REQUIRE_EQUAL( expirations.load(), 4u * 100u );
+}
+
+BOOST_AUTO_TEST_SUITE_END()